@@ -0,0 +1,125 @@
+//
+// Created by lucas on 19/10/2026.
+//
+
+#include "BacktrackingEngine.h"
+
+using namespace std;
+
+/**
+ * @file BacktrackingEngine.cpp
+ * @brief Implementation of class BacktrackingEngine.
+ */
+
+/**
+ * Creates an engine over an index, with its arrays sized for the whole graph.
+ * Complexity: O(V)
+ * @param g Index of the graph (must outlive the engine)
+ */
+BacktrackingEngine::BacktrackingEngine(const GraphIndex &g) : g(g), path(g.size()), cursor(g.size()), cost(g.size()),
+    visited(g.size(), 0) {
+    best.reserve(g.size());
+}
+
+/**
+ * Searches the cheapest Hamiltonian cycle that starts with the given path and returns to its first vertex,
+ * cheaper than a bound. Only extensions of the prefix are searched (it is never undone).
+ * Complexity: O(V!) in the worst case
+ * @param prefix Indexes of the first vertexes of the cycle (not empty, no repetitions)
+ * @param bound Only cycles cheaper than this are accepted
+ * @param maxExpansions Maximum number of nodes expanded (0 for no limit)
+ * @param stop Returns true when the search must stop (checked once per node)
+ * @param stats Statistics of the search
+ * @return true if a cycle cheaper than the bound was found
+ */
+bool BacktrackingEngine::run(const vector<int> &prefix, WeightSum bound, unsigned long long maxExpansions,
+                             const function<bool()> &stop, SearchStats &stats) {
+    (void) stats; //only written with TSP_SEARCH_STATS
+    int n = g.size();
+    int base = (int) prefix.size() - 1;
+    int start = prefix[0];
+    best.clear();
+    bestWeight = bound;
+    expanded = 0;
+
+    fill(visited.begin(), visited.end(), 0);
+    for(int d = 0; d <= base; d++){
+        path[d] = prefix[d];
+        visited[prefix[d]] = 1;
+        cost[d] = d == 0 ? 0 : cost[d - 1] + (WeightSum) g.weight(prefix[d - 1], prefix[d]);
+    }
+    cursor[base] = 0;
+
+    int depth = base;
+    TSP_STAT(stats.expand(depth + 1));
+    while(depth >= base){
+        int v = path[depth];
+
+        if(depth == n - 1){
+            //every vertex is in the path: closes the cycle if there is an edge back
+            double closing = g.weight(v, start);
+            if(closing != GraphIndex::infinity() && cost[depth] + (WeightSum) closing < bestWeight){
+                bestWeight = cost[depth] + (WeightSum) closing;
+                best.assign(path.begin(), path.end());
+                TSP_STAT(stats.incumbentUpdates++);
+            }
+            visited[v] = 0;
+            depth--;
+            continue;
+        }
+
+        //next unvisited neighbour that can still lead to a better cycle
+        const Neighbour *e = g.begin(v) + cursor[depth];
+        const Neighbour *end = g.end(v);
+        while(e != end && visited[e->to]) e++;
+        if(e != end && cost[depth] + e->weight >= bestWeight){
+            //sorted by weight: the remaining edges can't do better either
+            TSP_STAT(stats.boundPrunes++);
+            e = end;
+        }
+
+        if(e == end || stop() || (maxExpansions != 0 && expanded >= maxExpansions)){
+            if(depth > base) visited[v] = 0;
+            depth--;
+            continue;
+        }
+
+        cursor[depth] = (int) (e - g.begin(v)) + 1;
+        depth++;
+        path[depth] = e->to;
+        cursor[depth] = 0;
+        cost[depth] = cost[depth - 1] + e->weight;
+        visited[e->to] = 1;
+        expanded++;
+        TSP_STAT(stats.expand(depth + 1));
+    }
+
+    return !best.empty();
+}
+
+/**
+ * Gets the cost of the best cycle found by the last run (the bound if none was found).
+ * Complexity: O(1)
+ * @return Cost, in graph units
+ */
+WeightSum BacktrackingEngine::bestCost() const {
+    return bestWeight;
+}
+
+/**
+ * Gets the best cycle found by the last run.
+ * Complexity: O(1)
+ * @return Indexes of the vertexes, starting with the prefix (empty if none was found)
+ */
+const vector<int> &BacktrackingEngine::bestCycle() const {
+    return best;
+}
+
+/**
+ * Gets the number of nodes expanded by the last run.
+ * Complexity: O(1)
+ * @return Nodes expanded
+ */
+unsigned long long BacktrackingEngine::expansions() const {
+    return expanded;
+}
@@ -0,0 +1,47 @@
+//
+// Created by lucas on 19/10/2026.
+//
+
+#ifndef PROJECT2_BACKTRACKINGENGINE_H
+#define PROJECT2_BACKTRACKINGENGINE_H
+
+#include <functional>
+#include <vector>
+#include "GraphIndex.h"
+#include "SearchStats.h"
+#include "Weight.h"
+
+/**
+ * @file BacktrackingEngine.h
+ * @brief Definition of class BacktrackingEngine.
+ *
+ * \class BacktrackingEngine
+ * Exact search for the cheapest Hamiltonian cycle that starts with a given path, as an iterative depth-first
+ * search: the path, the cost up to each depth and the next edge to try at each depth live in arrays sized once,
+ * so no memory is allocated per node and the depth is not limited by the call stack.
+ * The edges of each vertex are tried by increasing weight, so once one goes over the best cycle the remaining
+ * ones are cut at once.
+ */
+class BacktrackingEngine {
+public:
+    explicit BacktrackingEngine(const GraphIndex &g);
+
+    bool run(const std::vector<int> &prefix, WeightSum bound, unsigned long long maxExpansions,
+             const std::function<bool()> &stop, SearchStats &stats);
+
+    WeightSum bestCost() const;
+    const std::vector<int> &bestCycle() const;
+    unsigned long long expansions() const;
+
+private:
+    const GraphIndex &g;
+    std::vector<int> path;          // path[d] is the vertex at depth d
+    std::vector<int> cursor;        // next edge of path[d] to try
+    std::vector<WeightSum> cost;    // cost of the path up to depth d
+    std::vector<char> visited;
+    std::vector<int> best;          // best cycle found (without the return to the first vertex)
+    WeightSum bestWeight = 0;
+    unsigned long long expanded = 0;
+};
+
+#endif //PROJECT2_BACKTRACKINGENGINE_H
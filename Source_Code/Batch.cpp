@@ -0,0 +1,439 @@
+//
+// Created by lucas on 19/10/2026.
+//
+
+#include "Batch.h"
+#include <cstdio>
+#include <cstring>
+#include <iomanip>
+#include <mutex>
+#include <sstream>
+#include <stdexcept>
+#include "parse.h"
+#include "ThreadPool.h"
+
+using namespace std;
+
+/**
+ * @file Batch.cpp
+ * @brief Implementation of the non-interactive (batch) mode.
+ */
+
+/**
+ * Splits a comma separated list.
+ * Complexity: O(n) where n is the length of the text
+ * @param text List
+ * @return The elements of the list
+ */
+static vector<string> splitList(const string &text) {
+    vector<string> res;
+    stringstream ss(text);
+    string item;
+    while(getline(ss, item, ',')){
+        if(!item.empty()) res.push_back(item);
+    }
+    return res;
+}
+
+/**
+ * Checks if the program was called with command line options (batch mode) instead of the menu.
+ * Complexity: O(1)
+ * @param argc Number of arguments
+ * @param argv Arguments
+ * @return true if the batch mode must be used
+ */
+bool isBatchInvocation(int argc, char *argv[]) {
+    return argc > 1 && strncmp(argv[1], "--", 2) == 0;
+}
+
+/**
+ * Reads the batch options from the command line.
+ * Complexity: O(n) where n is the number of arguments
+ * @param argc Number of arguments
+ * @param argv Arguments
+ * @param options Where the options are stored
+ * @return 1 if an error occurred. 0 otherwise
+ */
+int parseBatchOptions(int argc, char *argv[], BatchOptions &options) {
+    for(int i = 1; i < argc; i++){
+        string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+
+        try {
+            if(arg == "--dataset" && hasValue){
+                for(const string &spec : splitList(argv[++i])){
+                    for(const string &dataset : expandDatasetSpec(spec)) options.datasets.push_back(dataset);
+                }
+            }
+            else if(arg == "--algorithms" && hasValue){
+                options.algorithms = splitList(argv[++i]);
+            }
+            else if(arg == "--start" && hasValue){
+                options.starts.clear();
+                for(const string &id : splitList(argv[++i])) options.starts.push_back(stoi(id));
+            }
+            else if(arg == "--budget" && hasValue){
+                options.timeBudget = stod(argv[++i]);
+            }
+            else if(arg == "--threads" && hasValue){
+                int threads = stoi(argv[++i]);
+                options.threads = threads <= 0 ? ThreadPool::defaultThreads() : (unsigned int) threads;
+            }
+            else if(arg == "--format" && hasValue){
+                options.format = argv[++i];
+            }
+            else if(arg == "--print-path"){
+                options.printPath = true;
+            }
+            else if(arg == "--hierarchy"){
+                options.hierarchy = true;
+            }
+            else if(arg == "--all-pairs"){
+                options.allPairs = true;
+            }
+            else if(arg == "--lower-bound"){
+                options.lowerBound = true;
+            }
+            else if(arg == "--target-gap" && hasValue){
+                options.targetGap = stod(argv[++i]) / 100;
+            }
+            else if(arg == "--ordering" && hasValue){
+                if(!parseOrdering(argv[++i], options.ordering)) throw invalid_argument(arg);
+            }
+            else{
+                cerr << "Unknown option: " << arg << '\n';
+                return EXIT_FAILURE;
+            }
+        } catch (const exception &) {
+            cerr << "Invalid value for " << arg << '\n';
+            return EXIT_FAILURE;
+        }
+    }
+
+    if(options.datasets.empty()){
+        cerr << "No dataset given (use --dataset)\n";
+        return EXIT_FAILURE;
+    }
+    if(options.format != "text" && options.format != "csv" && options.format != "json"){
+        cerr << "Unknown format: " << options.format << '\n';
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
+
+/**
+ * Expands "kind:*" and "kind:A-B" into one spec per graph. Any other spec is returned as is.
+ * Complexity: O(n) where n is the number of graphs selected
+ * @param spec Dataset spec
+ * @return Dataset specs
+ */
+vector<string> expandDatasetSpec(const string &spec) {
+    size_t colon = spec.find(':');
+    string kind = colon == string::npos ? "" : spec.substr(0, colon);
+    int count = kind == "medium" ? 12 : (kind == "small" || kind == "big") ? 3 : 0;
+    if(count == 0) return {spec};
+
+    string range = spec.substr(colon + 1);
+    int first = 1, last = count;
+    size_t dash = range.find('-');
+    if(range != "*"){
+        if(dash == string::npos) return {spec};
+        first = atoi(range.substr(0, dash).c_str());
+        last = atoi(range.substr(dash + 1).c_str());
+    }
+
+    vector<string> res;
+    for(int n = max(first, 1); n <= min(last, count); n++){
+        res.push_back(kind + ":" + to_string(n));
+    }
+    return res;
+}
+
+/**
+ * Checks if an algorithm name is accepted by runAlgorithm.
+ * Complexity: O(1)
+ * @param algorithm Name of the algorithm
+ * @return true if the algorithm exists
+ */
+bool isKnownAlgorithm(const string &algorithm) {
+    return algorithm == "backtracking" || algorithm == "triangular" || algorithm == "other"
+        || algorithm == "realworld" || algorithm == "realworld2" || algorithm == "multistart"
+        || algorithm == "nn2opt" || algorithm == "mst2opt"
+        || algorithm == "multinn" || algorithm == "curve" || algorithm == "curve2opt" || algorithm == "greedy2opt"
+        || algorithm == "cheapest" || algorithm == "farthest" || algorithm == "hull" || algorithm == "clusters";
+}
+
+/**
+ * Checks if an algorithm uses the start vertex (the heuristics always start at 0).
+ * Complexity: O(1)
+ * @param algorithm Name of the algorithm
+ * @return true if the start vertex can be chosen
+ */
+bool algorithmUsesStart(const string &algorithm) {
+    return algorithm == "backtracking" || algorithm == "realworld" || algorithm == "realworld2" || algorithm == "multistart"
+        || algorithm == "nn2opt" || algorithm == "mst2opt"
+        || algorithm == "multinn" || algorithm == "curve" || algorithm == "curve2opt" || algorithm == "greedy2opt"
+        || algorithm == "cheapest" || algorithm == "farthest" || algorithm == "hull" || algorithm == "clusters";
+}
+
+/**
+ * Runs an algorithm by name.
+ * Complexity: depends on the algorithm
+ * @param tsp TSP with the graph loaded
+ * @param algorithm Name of the algorithm
+ * @param start Id of the start vertex (ignored by the heuristics, that always start at 0)
+ * @param timeBudget Seconds the search may take (0 for no limit)
+ * @param result Where the result is stored
+ * @return false if the algorithm doesn't exist
+ */
+bool runAlgorithm(TSP &tsp, const string &algorithm, int start, double timeBudget, TSPResult &result) {
+    if(algorithm == "backtracking"){
+        if(tsp.getIdToNode().count(start) == 0){
+            result = TSPResult();
+            result.error = 1;
+        }
+        else{
+            result = tsp.backtrackingSolution(start, timeBudget);
+        }
+    }
+    else if(algorithm == "triangular") result = tsp.triangularAproxSolution();
+    else if(algorithm == "other") result = tsp.otherHeuristic();
+    else if(algorithm == "realworld") result = tsp.tspRealWord(start, timeBudget);
+    else if(algorithm == "realworld2") result = tsp.tspRealWord2(start, timeBudget);
+    else if(algorithm == "multistart") result = tsp.tspRealWordBatch({start}, 1, timeBudget)[0];
+    else if(algorithm == "nn2opt") result = tsp.improvedHeuristic(start, TourConstruction::NEAREST_NEIGHBOUR, timeBudget);
+    else if(algorithm == "mst2opt") result = tsp.improvedHeuristic(start, TourConstruction::SPANNING_TREE, timeBudget);
+    else if(algorithm == "curve") result = tsp.spaceFillingCurveTour(start);
+    else if(algorithm == "curve2opt") result = tsp.improvedHeuristic(start, TourConstruction::SPACE_FILLING_CURVE, timeBudget);
+    else if(algorithm == "greedy2opt") result = tsp.improvedHeuristic(start, TourConstruction::GREEDY_EDGE, timeBudget);
+    else if(algorithm == "cheapest") result = tsp.constructionHeuristic(start, TourConstruction::CHEAPEST_INSERTION, timeBudget);
+    else if(algorithm == "farthest") result = tsp.constructionHeuristic(start, TourConstruction::FARTHEST_INSERTION, timeBudget);
+    else if(algorithm == "hull") result = tsp.constructionHeuristic(start, TourConstruction::CONVEX_HULL_INSERTION, timeBudget);
+    else if(algorithm == "multinn") result = tsp.multiStartNearestNeighbour(start, timeBudget);
+    else if(algorithm == "clusters") result = tsp.clusterDecomposition(start, TourConstruction::NEAREST_NEIGHBOUR, timeBudget);
+    else return false;
+    result = tsp.withLowerBound(result);
+    return true;
+}
+
+/**
+ * Escapes a text to be used as a JSON string: quotes, backslashes and control characters (as \n, \t, ... or \u00XX).
+ * Complexity: O(n) where n is the length of the text
+ * @param text Text to escape
+ * @return Escaped text (without the quotes)
+ */
+string jsonEscape(const string &text) {
+    string res;
+    for(char c : text){
+        switch(c){
+            case '"': res += "\\\""; break;
+            case '\\': res += "\\\\"; break;
+            case '\n': res += "\\n"; break;
+            case '\t': res += "\\t"; break;
+            case '\r': res += "\\r"; break;
+            case '\b': res += "\\b"; break;
+            case '\f': res += "\\f"; break;
+            default:
+                if((unsigned char) c < 0x20){
+                    char code[7];
+                    snprintf(code, sizeof(code), "\\u%04x", (unsigned char) c);
+                    res += code;
+                }
+                else{
+                    res += c;
+                }
+        }
+    }
+    return res;
+}
+
+/**
+ * Quotes a text to be used as a CSV field (the quotes inside it are doubled).
+ * Complexity: O(n) where n is the length of the text
+ * @param text Text to quote
+ * @return Quoted text
+ */
+static string csvQuote(const string &text) {
+    string res = "\"";
+    for(char c : text){
+        if(c == '"') res += '"';
+        res += c;
+    }
+    return res + '"';
+}
+
+/**
+ * Writes the fields of a result as JSON (without the surrounding braces, so other fields can be added).
+ * Complexity: O(n) where n is the size of the path (if printed)
+ * @param row Result
+ * @param printPath If the path found is included
+ * @return JSON fields
+ */
+string batchRowJsonFields(const BatchRow &row, bool printPath) {
+    const TSPResult &r = row.result;
+    ostringstream out;
+    out << setprecision(12);
+    out << "\"dataset\":\"" << jsonEscape(row.dataset) << "\",\"algorithm\":\"" << jsonEscape(row.algorithm)
+        << "\",\"start\":" << row.start << ",\"found\":" << (r.found ? "true" : "false") << ",\"error\":" << r.error
+        << ",\"cost\":" << r.cost << ",\"time\":" << r.time.count() << ",\"timedOut\":" << (r.timedOut ? "true" : "false")
+        << ",\"nodesExpanded\":" << r.stats.nodesExpanded << ",\"boundPrunes\":" << r.stats.boundPrunes
+        << ",\"incumbentUpdates\":" << r.stats.incumbentUpdates << ",\"improvingMoves\":" << r.stats.improvingMoves;
+    if(r.lowerBound > 0) out << ",\"lowerBound\":" << r.lowerBound;
+    if(r.gap() >= 0) out << ",\"gap\":" << r.gap();
+    if(r.cycleFrom != -1) out << ",\"cycleFrom\":" << r.cycleFrom;
+    if(printPath){
+        out << ",\"path\":[";
+        for(size_t i = 0; i < r.path.size(); i++) out << (i ? "," : "") << r.path[i].getId();
+        out << ']';
+    }
+    if(printPath && !r.route.empty()){
+        out << ",\"route\":[";
+        for(size_t i = 0; i < r.route.size(); i++) out << (i ? "," : "") << r.route[i].getId();
+        out << ']';
+    }
+    return out.str();
+}
+
+/**
+ * Prints the results of a batch run.
+ * Complexity: O(r * n) where r is the number of rows and n the size of the paths (if printed)
+ * @param rows Results
+ * @param format text, csv or json (one object per line)
+ * @param printPath If the path found is printed
+ * @param out Where to print
+ */
+void printBatchRows(const vector<BatchRow> &rows, const string &format, bool printPath, ostream &out) {
+    out << setprecision(12);
+    if(format == "csv"){
+        out << "dataset,algorithm,start,found,error,cost,time,timedOut,nodesExpanded,boundPrunes,incumbentUpdates,improvingMoves,lowerBound,cycleFrom";
+        if(printPath) out << ",path,route";
+        out << '\n';
+    }
+
+    for(const BatchRow &row : rows){
+        const TSPResult &r = row.result;
+        if(format == "csv"){
+            out << csvQuote(row.dataset) << ',' << row.algorithm << ',' << row.start << ',' << r.found << ',' << r.error << ','
+                << r.cost << ',' << r.time.count() << ',' << r.timedOut << ',' << r.stats.nodesExpanded << ','
+                << r.stats.boundPrunes << ',' << r.stats.incumbentUpdates << ',' << r.stats.improvingMoves << ',' << r.lowerBound << ',' << r.cycleFrom;
+            if(printPath){
+                out << ',';
+                for(size_t i = 0; i < r.path.size(); i++) out << (i ? " " : "") << r.path[i].getId();
+                out << ',';
+                for(size_t i = 0; i < r.route.size(); i++) out << (i ? " " : "") << r.route[i].getId();
+            }
+            out << '\n';
+        }
+        else if(format == "json"){
+            out << '{' << batchRowJsonFields(row, printPath) << "}\n";
+        }
+        else{
+            out << row.dataset << " | " << row.algorithm << " | start " << row.start << '\n';
+            if(r.found){
+                out << "Cost: " << r.cost << '\n' << "Time: " << r.time.count() << '\n';
+                if(r.cycleFrom != -1) out << "Cycle found from vertex " << r.cycleFrom << " and rotated to this start\n";
+                if(printPath){
+                    for(const NodeInfo &info : r.path) out << info.getId() << '\n';
+                }
+                if(printPath && !r.route.empty()){
+                    out << "Route driven (the steps without an edge follow their shortest path):\n";
+                    for(const NodeInfo &info : r.route) out << info.getId() << '\n';
+                }
+            }
+            else{
+                out << (r.error == 1 ? "That vertex does not exist" : "Solution starting with that vertex is impossible") << '\n';
+            }
+            if(r.timedOut) out << "The time budget ended before the search finished\n";
+            if(r.lowerBound > 0) out << "Lower bound: " << r.lowerBound << '\n';
+            if(r.gap() >= 0) out << "Gap: " << 100 * r.gap() << "%\n";
+            if(!r.stats.empty()) r.stats.print(out);
+            out << '\n';
+        }
+    }
+}
+
+/**
+ * Runs the batch mode: every dataset is loaded once and then every algorithm is run from every start vertex.
+ * Datasets are processed concurrently in a thread pool, each one with its own TSP object and its share of the threads.
+ * Complexity: depends on the algorithms
+ * @param options Options of the run
+ * @return 1 if an error occurred. 0 otherwise
+ */
+int runBatch(const BatchOptions &options) {
+    for(const string &algorithm : options.algorithms){
+        if(!isKnownAlgorithm(algorithm)){
+            cerr << "Unknown algorithm: " << algorithm << '\n';
+            return EXIT_FAILURE;
+        }
+    }
+
+    vector<vector<BatchRow>> rowsPerDataset(options.datasets.size());
+    vector<char> loaded(options.datasets.size(), false); //not vector<bool>: each worker writes its own element
+    mutex progressMutex;
+
+    //the threads are split between the datasets run at the same time, so their own threads don't add up past them
+    unsigned int poolSize = max(1u, min<unsigned int>(options.threads, (unsigned int) options.datasets.size()));
+    unsigned int datasetThreads = max(1u, options.threads / poolSize);
+    {
+        ThreadPool pool(poolSize);
+        for(size_t d = 0; d < options.datasets.size(); d++){
+            pool.submit([&, d]{
+                const string &dataset = options.datasets[d];
+                unordered_map<int, NodeInfo> map;
+                Graph<NodeInfo> g;
+                string edgesFile;
+                if(!loadDataset(dataset, map, g, &edgesFile)){
+                    return;
+                }
+                loaded[d] = true;
+
+                TSP tsp;
+                tsp.setIdToNode(std::move(map));
+                tsp.setGraph(std::move(g));
+                tsp.setThreads(datasetThreads);
+                tsp.setOrdering(options.ordering);
+                tsp.setLowerBound(options.lowerBound, options.targetGap);
+                tsp.setHierarchy(options.hierarchy, edgesFile + ".ch");
+                if(options.allPairs) tsp.computeAllPairs();
+
+                for(const string &algorithm : options.algorithms){
+                    if(algorithm == "multistart"){
+                        //all the starts share one preprocessing and are searched together
+                        vector<TSPResult> results = tsp.tspRealWordBatch(options.starts, datasetThreads, options.timeBudget);
+                        for(size_t i = 0; i < results.size(); i++){
+                            TSPResult result = tsp.withLowerBound(results[i]);
+                            if(options.printPath) result = tsp.withRoute(result);
+                            rowsPerDataset[d].push_back({dataset, algorithm, options.starts[i], result});
+                        }
+                        continue;
+                    }
+                    bool usesStart = algorithmUsesStart(algorithm);
+                    for(int start : options.starts){
+                        BatchRow row {dataset, algorithm, usesStart ? start : 0, TSPResult()};
+                        runAlgorithm(tsp, algorithm, row.start, options.timeBudget, row.result);
+                        if(options.printPath) row.result = tsp.withRoute(row.result);
+                        rowsPerDataset[d].push_back(row);
+                        if(!usesStart) break;
+                    }
+                }
+
+                lock_guard<mutex> lock(progressMutex);
+                cerr << "Finished " << dataset << '\n';
+            });
+        }
+        pool.wait();
+    }
+
+    int status = EXIT_SUCCESS;
+    vector<BatchRow> rows;
+    for(size_t d = 0; d < options.datasets.size(); d++){
+        if(!loaded[d]){
+            cerr << "Unable to load the dataset " << options.datasets[d] << '\n';
+            status = EXIT_FAILURE;
+        }
+        rows.insert(rows.end(), rowsPerDataset[d].begin(), rowsPerDataset[d].end());
+    }
+
+    printBatchRows(rows, options.format, options.printPath, cout);
+    return status;
+}
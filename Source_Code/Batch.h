@@ -0,0 +1,82 @@
+//
+// Created by lucas on 19/10/2026.
+//
+
+#ifndef PROJECT2_BATCH_H
+#define PROJECT2_BATCH_H
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include "TSP.h"
+
+/**
+ * @file Batch.h
+ * @brief Definition of the non-interactive (batch) mode.
+ *
+ * Usage: main --dataset <spec>[,<spec>...] [--algorithms a,b,...] [--start id,id,...]
+ *             [--budget seconds] [--threads n] [--format text|csv|json] [--print-path] [--hierarchy] [--all-pairs]
+ *             [--ordering id|hilbert|rcm|auto] [--lower-bound] [--target-gap percent]
+ *
+ * A dataset spec is "small:N", "medium:N" or "big:N" (N as in the menu, "*" for all of them or a range "A-B")
+ * or a path accepted by loadDataset. Algorithms: backtracking, triangular, other, realworld, realworld2, multistart
+ * (a depth-first walk with bounded backtracking from all the starts at once, with shared preprocessing), nn2opt
+ * and mst2opt (nearest neighbour or spanning tree tour improved with 2-opt), multinn (nearest neighbour from every
+ * vertex on several threads, keeping the cheapest cycle), curve (the order along a Hilbert curve over the
+ * coordinates, for inputs too large for the rest), curve2opt (that order improved with 2-opt), greedy2opt (greedy
+ * edge matching improved with 2-opt), cheapest, farthest and hull (insertion heuristics, see InsertionHeuristics.h)
+ * and clusters (the graph split into clusters solved on several threads and chained, for graphs too large for
+ * the rest).
+ * --threads is shared by the datasets: up to that many are run at the same time, and each one gets
+ * max(1, threads / datasets run at the same time) threads for multistart, multinn, clusters and the preprocessing.
+ * --hierarchy makes the heuristics get shortest path distances from a contraction hierarchy, saved next to the
+ * edges file of the dataset (<edges file>.ch) and reused by the following runs. --all-pairs calculates every
+ * distance beforehand (Floyd-Warshall), for graphs up to a few thousand vertexes. --ordering renumbers the vertexes
+ * of the index for memory locality (see Ordering.h). --lower-bound adds the Held-Karp lower bound (see HeldKarp.h) and
+ * the optimality gap to every result; --target-gap makes backtracking and the 2-opt heuristics stop once their cycle
+ * is within that percentage of the bound. --print-path adds the path and, when some of its steps have no edge, the
+ * route driven (see TSP::withRoute), whose cost is the one reported.
+ */
+
+/**
+ * \struct BatchOptions
+ * Options of a batch run, as given in the command line.
+ */
+struct BatchOptions {
+    std::vector<std::string> datasets;
+    std::vector<std::string> algorithms {"triangular", "other"};
+    std::vector<int> starts {0};
+    double timeBudget = 0;
+    unsigned int threads = 1;
+    std::string format = "text";
+    bool printPath = false;
+    bool hierarchy = false;
+    bool allPairs = false;
+    VertexOrdering ordering = VertexOrdering::ID;
+    bool lowerBound = false;
+    double targetGap = 0;     // fraction (the option is given in percent)
+};
+
+/**
+ * \struct BatchRow
+ * Result of running one algorithm from one start vertex in one dataset.
+ */
+struct BatchRow {
+    std::string dataset;
+    std::string algorithm;
+    int start;
+    TSPResult result;
+};
+
+bool isBatchInvocation(int argc, char *argv[]);
+int parseBatchOptions(int argc, char *argv[], BatchOptions &options);
+std::vector<std::string> expandDatasetSpec(const std::string &spec);
+bool isKnownAlgorithm(const std::string &algorithm);
+bool algorithmUsesStart(const std::string &algorithm);
+bool runAlgorithm(TSP &tsp, const std::string &algorithm, int start, double timeBudget, TSPResult &result);
+std::string batchRowJsonFields(const BatchRow &row, bool printPath);
+void printBatchRows(const std::vector<BatchRow> &rows, const std::string &format, bool printPath, std::ostream &out);
+std::string jsonEscape(const std::string &text);
+int runBatch(const BatchOptions &options);
+
+#endif //PROJECT2_BATCH_H
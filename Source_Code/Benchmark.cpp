@@ -0,0 +1,118 @@
+//
+// Created by lucas on 19/10/2026.
+//
+
+#include "Benchmark.h"
+#include <atomic>
+#include <cstdlib>
+#include <iomanip>
+#include <new>
+
+using namespace std;
+
+/**
+ * @file Benchmark.cpp
+ * @brief Implementation of the micro-benchmark harness and of the allocation counter.
+ */
+
+// ===================================================== ALLOCATION COUNTER ======================================================================
+
+static atomic<unsigned long long> allocations(0);
+
+void *operator new(size_t size) {
+    allocations.fetch_add(1, memory_order_relaxed);
+    void *p = malloc(size == 0 ? 1 : size);
+    if(p == nullptr) throw bad_alloc();
+    return p;
+}
+
+void *operator new[](size_t size) {
+    allocations.fetch_add(1, memory_order_relaxed);
+    void *p = malloc(size == 0 ? 1 : size);
+    if(p == nullptr) throw bad_alloc();
+    return p;
+}
+
+void operator delete(void *p) noexcept {
+    free(p);
+}
+
+void operator delete[](void *p) noexcept {
+    free(p);
+}
+
+void operator delete(void *p, size_t) noexcept {
+    free(p);
+}
+
+void operator delete[](void *p, size_t) noexcept {
+    free(p);
+}
+
+unsigned long long allocationCount() {
+    return allocations.load(memory_order_relaxed);
+}
+
+// ========================================================== HARNESS =================================================================================
+
+/**
+ * Registers a new benchmark case.
+ * Complexity: O(1)
+ * @param group Backend or data structure being measured (e.g. "Graph", "MutablePriorityQueue")
+ * @param name Name of the case
+ * @param maxSize Largest size the case should be run with (cases that are quadratic can limit themselves)
+ * @param benchmarkCase Function that builds the data and measures the operations
+ */
+void BenchmarkHarness::registerCase(const string &group, const string &name, size_t maxSize, Case benchmarkCase) {
+    cases.push_back({group, name, maxSize, {}, std::move(benchmarkCase)});
+}
+
+/**
+ * Registers a new benchmark case that always runs with its own sizes (used by the exponential solvers,
+ * which cannot go anywhere near the sizes of the data structure benchmarks).
+ * Complexity: O(1)
+ * @param group Backend or algorithm being measured
+ * @param name Name of the case
+ * @param sizes Sizes the case is run with
+ * @param benchmarkCase Function that builds the data and measures the operations
+ */
+void BenchmarkHarness::registerCase(const string &group, const string &name, const vector<size_t> &sizes, Case benchmarkCase) {
+    cases.push_back({group, name, 0, sizes, std::move(benchmarkCase)});
+}
+
+/**
+ * Runs every case whose "group/name" contains the filter, for every size, and prints a table with the results.
+ * Complexity: depends on the registered cases
+ * @param sizes Problem sizes (number of vertexes)
+ * @param filter Only cases containing this text are run (empty runs everything)
+ * @param out Stream where the table is written
+ * @return All the measurements taken
+ */
+vector<BenchmarkResult> BenchmarkHarness::run(const vector<size_t> &sizes, const string &filter, ostream &out) const {
+    vector<BenchmarkResult> all;
+
+    out << left << setw(24) << "group" << setw(46) << "operation" << right << setw(10) << "n"
+        << setw(14) << "ops" << setw(14) << "ns/op" << setw(14) << "allocs/op" << '\n';
+
+    for(const Entry &entry : cases){
+        if(!filter.empty() && (entry.group + "/" + entry.name).find(filter) == string::npos) continue;
+
+        for(size_t n : entry.sizes.empty() ? sizes : entry.sizes){
+            if(entry.sizes.empty() && n > entry.maxSize) continue;
+
+            BenchmarkRun run(entry.group, entry.name, n);
+            entry.benchmarkCase(run);
+
+            for(const BenchmarkResult &r : run.getResults()){
+                out << left << setw(24) << r.group << setw(46) << r.name << right << setw(10) << r.n
+                    << setw(14) << r.ops << setw(14) << fixed << setprecision(2) << r.nsPerOp
+                    << setw(14) << setprecision(3) << r.allocsPerOp;
+                if(!r.counters.empty()) out << "   " << r.counters;
+                out << '\n';
+                all.push_back(r);
+            }
+            out.flush();
+        }
+    }
+    return all;
+}
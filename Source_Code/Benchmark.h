@@ -0,0 +1,108 @@
+//
+// Created by lucas on 19/10/2026.
+//
+
+#ifndef PROJECT2_BENCHMARK_H
+#define PROJECT2_BENCHMARK_H
+
+#include <chrono>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <vector>
+
+/**
+ * @file Benchmark.h
+ * @brief Definition of the micro-benchmark harness.
+ *
+ * \class BenchmarkRun
+ * Handed to every benchmark case for one problem size. The case builds whatever it needs
+ * and then calls measure() around the code being timed, so the setup is never counted.
+ */
+
+/**
+ * Number of heap allocations performed by the process so far.
+ * Defined by the benchmark executable, which replaces the global operator new.
+ * @return Allocation count
+ */
+unsigned long long allocationCount();
+
+struct BenchmarkResult {
+    std::string group;
+    std::string name;
+    size_t n;
+    unsigned long long ops;
+    double nsPerOp;
+    double allocsPerOp;
+    std::string counters; // extra counters reported by the case (e.g. search statistics)
+};
+
+class BenchmarkRun {
+public:
+    BenchmarkRun(std::string group, std::string name, size_t n) : group(std::move(group)), name(std::move(name)), n(n) {}
+
+    size_t size() const { return n; }
+
+    /**
+     * Times a block of code that performs a known number of operations and records ns/op and allocations/op.
+     * Can be called several times by the same case to report different operations on the same data.
+     * @param op Name of the operation
+     * @param ops Number of operations performed by f
+     * @param f Code to measure
+     */
+    template <class F>
+    void measure(const std::string &op, unsigned long long ops, F f) {
+        unsigned long long allocsBefore = allocationCount();
+        auto clockStart = std::chrono::high_resolution_clock::now();
+        f();
+        auto clockEnd = std::chrono::high_resolution_clock::now();
+        unsigned long long allocs = allocationCount() - allocsBefore;
+
+        if(ops == 0) ops = 1;
+        double ns = std::chrono::duration<double, std::nano>(clockEnd - clockStart).count();
+        results.push_back({group, name + "/" + op, n, ops, ns / (double) ops, (double) allocs / (double) ops, ""});
+    }
+
+    /**
+     * Attaches extra counters to the last measurement.
+     * @param counters Text with the counters
+     */
+    void annotate(const std::string &counters) {
+        if(!results.empty()) results.back().counters = counters;
+    }
+
+    const std::vector<BenchmarkResult> &getResults() const { return results; }
+
+private:
+    std::string group;
+    std::string name;
+    size_t n;
+    std::vector<BenchmarkResult> results;
+};
+
+/**
+ * \class BenchmarkHarness
+ * Keeps the registered benchmark cases and runs them over a range of sizes.
+ * Each backend (graph representation, heap, distance source...) registers its own cases under a group name,
+ * so alternative implementations are compared side by side in the same table.
+ */
+class BenchmarkHarness {
+public:
+    using Case = std::function<void(BenchmarkRun &)>;
+
+    void registerCase(const std::string &group, const std::string &name, size_t maxSize, Case benchmarkCase);
+    void registerCase(const std::string &group, const std::string &name, const std::vector<size_t> &sizes, Case benchmarkCase);
+    std::vector<BenchmarkResult> run(const std::vector<size_t> &sizes, const std::string &filter, std::ostream &out) const;
+
+private:
+    struct Entry {
+        std::string group;
+        std::string name;
+        size_t maxSize;
+        std::vector<size_t> sizes; // when not empty, used instead of the sizes given to run()
+        Case benchmarkCase;
+    };
+    std::vector<Entry> cases;
+};
+
+#endif //PROJECT2_BENCHMARK_H
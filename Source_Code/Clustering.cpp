@@ -0,0 +1,121 @@
+//
+// Created by lucas on 19/10/2026.
+//
+
+#include "Clustering.h"
+#include <atomic>
+#include "Delaunay.h"
+#include "Ordering.h"
+#include "SpatialGrid.h"
+#include "ThreadPool.h"
+
+using namespace std;
+
+/**
+ * @file Clustering.cpp
+ * @brief Implementation of the k-means and edge based partitions.
+ */
+
+/**
+ * Splits points into about k clusters by k-means. The clusters start as k runs of equal length of the Hilbert
+ * curve, and each iteration moves every point to the closest centroid among the one of its cluster and the
+ * centroids next to it in their Delaunay triangulation (the clusters only exchange points with their neighbours,
+ * so this finds the closest centroid for all but a few points, with about 7 comparisons per point). The points
+ * are assigned in parallel. Clusters that end up empty are dropped, so there may be fewer than k.
+ * Complexity: O(i * (V / T + k log k)) for i iterations and T threads, plus O(V log V) for the curve
+ * @param nodes Points
+ * @param k Number of clusters wanted
+ * @param iterations Maximum number of iterations (fewer if no point moves)
+ * @param threads Number of threads
+ * @return The cluster of each point, numbered from 0
+ */
+vector<int> kMeansClusters(const vector<NodeInfo> &nodes, int k, int iterations, unsigned int threads) {
+    int n = (int) nodes.size();
+    vector<int> cluster(n, 0);
+    if(n == 0) return cluster;
+    k = max(1, min(k, n));
+    vector<double> x, y;
+    projectCoordinates(nodes, x, y);
+
+    vector<int> order = hilbertOrder(nodes);
+    for(int i = 0; i < n; i++) cluster[order[i]] = (int) ((long long) i * k / n);
+
+    const int block = 4096;     // points assigned per job
+    ThreadPool pool(max(1u, threads));
+    vector<double> centreX, centreY;
+    vector<NodeInfo> centres;
+    for(int it = 0; it <= iterations; it++){
+        //the centroids, numbered again without the empty clusters
+        vector<double> sumX(k, 0), sumY(k, 0), sumLon(k, 0), sumLat(k, 0);
+        vector<int> count(k, 0);
+        for(int v = 0; v < n; v++){
+            int c = cluster[v];
+            sumX[c] += x[v];
+            sumY[c] += y[v];
+            sumLon[c] += nodes[v].getLongitude();
+            sumLat[c] += nodes[v].getLatitude();
+            count[c]++;
+        }
+        vector<int> renumbered(k, -1);
+        centreX.clear();
+        centreY.clear();
+        centres.clear();
+        for(int c = 0; c < k; c++){
+            if(count[c] == 0) continue;
+            renumbered[c] = (int) centres.size();
+            centreX.push_back(sumX[c] / count[c]);
+            centreY.push_back(sumY[c] / count[c]);
+            centres.emplace_back((int) centres.size(), "", sumLon[c] / count[c], sumLat[c] / count[c]);
+        }
+        k = (int) centres.size();
+        for(int v = 0; v < n; v++) cluster[v] = renumbered[cluster[v]];
+        if(it == iterations) break;
+
+        vector<vector<int>> near = delaunayNeighbours(centres);
+        atomic<int> next(0);
+        atomic<int> moved(0);
+        for(unsigned int t = 0; t < pool.size(); t++){
+            pool.submit([&](){
+                for(int first = block * next++; first < n; first = block * next++){
+                    int changed = 0;
+                    for(int v = first; v < min(n, first + block); v++){
+                        int own = cluster[v], best = own;
+                        double bestDistance = (x[v] - centreX[own]) * (x[v] - centreX[own]) + (y[v] - centreY[own]) * (y[v] - centreY[own]);
+                        for(int c : near[own]){
+                            double distance = (x[v] - centreX[c]) * (x[v] - centreX[c]) + (y[v] - centreY[c]) * (y[v] - centreY[c]);
+                            if(distance < bestDistance){
+                                bestDistance = distance;
+                                best = c;
+                            }
+                        }
+                        changed += best != own;
+                        cluster[v] = best;
+                    }
+                    moved += changed;
+                }
+            });
+        }
+        pool.wait();
+        if(moved == 0) break;
+    }
+    return cluster;
+}
+
+/**
+ * Splits a graph into k clusters of (almost) the same size: runs of its reverse Cuthill-McKee order, which
+ * visits the graph breadth first, so a run is a band of vertexes at similar depths, mostly connected by edges.
+ * Complexity: O(V + E log E)
+ * @param offsets Edges of v are in [offsets[v], offsets[v + 1]) of targets
+ * @param targets Destinations of the edges
+ * @param k Number of clusters wanted
+ * @return The cluster of each vertex, numbered from 0 (consecutive clusters are close in the order)
+ */
+vector<int> graphClusters(const vector<int> &offsets, const vector<int> &targets, int k) {
+    int n = (int) offsets.size() - 1;
+    vector<int> cluster(max(n, 0), 0);
+    if(n <= 0) return cluster;
+    k = max(1, min(k, n));
+    vector<int> order = reverseCuthillMcKee(offsets, targets);
+    for(int i = 0; i < n; i++) cluster[order[i]] = (int) ((long long) i * k / n);
+    return cluster;
+}
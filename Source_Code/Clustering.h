@@ -0,0 +1,24 @@
+//
+// Created by lucas on 19/10/2026.
+//
+
+#ifndef PROJECT2_CLUSTERING_H
+#define PROJECT2_CLUSTERING_H
+
+#include <vector>
+#include "NodeInfo.h"
+
+/**
+ * @file Clustering.h
+ * @brief Partitions of the vertexes into clusters of close vertexes, for solving large instances piece by piece.
+ *
+ * With coordinates, k-means (Lloyd) on the projection of SpatialGrid. It starts from k runs of the Hilbert curve,
+ * and each vertex only compares its centroid with the centroids next to it in their Delaunay triangulation.
+ * Without coordinates, runs of the reverse Cuthill-McKee order of the edges, whose consecutive vertexes are
+ * neighbours or close to it. Both return the cluster of each vertex, with the clusters numbered 0 to k - 1.
+ */
+
+std::vector<int> kMeansClusters(const std::vector<NodeInfo> &nodes, int k, int iterations, unsigned int threads);
+std::vector<int> graphClusters(const std::vector<int> &offsets, const std::vector<int> &targets, int k);
+
+#endif //PROJECT2_CLUSTERING_H
@@ -0,0 +1,455 @@
+//
+// Created by lucas on 19/10/2026.
+//
+
+#include "ContractionHierarchy.h"
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <fstream>
+#include "ThreadPool.h"
+
+using namespace std;
+
+/**
+ * @file ContractionHierarchy.cpp
+ * @brief Implementation of class ContractionHierarchy.
+ */
+
+static const char MAGIC[8] = {'P', '2', 'C', 'H', '0', '0', '0', '1'};
+static const int WITNESS_SETTLE_LIMIT = 500; // vertexes a witness search may settle before giving up
+static const int ESTIMATE_SETTLE_LIMIT = 50;  // same, when only estimating the priority of a vertex
+
+// ============================================================ PREPROCESSING ================================================================
+/**
+ * Builds the hierarchy. The vertexes are contracted by increasing priority (shortcuts added - edges removed +
+ * contracted neighbours), updated lazily. The witness searches are limited, so some shortcuts may not be needed,
+ * but all the distances are kept.
+ * Meant for sparse graphs (road networks): in complete graphs every contraction tries O(d^2) pairs.
+ * Complexity: O(V * d^2 * W) in practice, where d is the degree of the contracted vertexes and W the witness search cost
+ * @param g Index of the graph (undirected)
+ */
+ContractionHierarchy::ContractionHierarchy(const GraphIndex &g) : n(g.size()), graphFingerprint(fingerprint(g)) {
+    //remaining graph, without self loops and parallel edges (the first edge to a vertex is the lightest)
+    vector<vector<pair<int, double>>> adj(n);
+    vector<int> lastSeenFrom(n, -1);
+    for(int v = 0; v < n; v++){
+        for(const Neighbour *e = g.begin(v); e != g.end(v); e++){
+            if(e->to != v && lastSeenFrom[e->to] != v){
+                lastSeenFrom[e->to] = v;
+                adj[v].push_back({e->to, e->weight});
+            }
+        }
+    }
+
+    vector<char> contracted(n, 0);
+    vector<int> contractedNeighbours(n, 0);
+    vector<vector<pair<int, double>>> up(n);
+
+    //witness search buffers
+    vector<double> dist(n, GraphIndex::infinity());
+    vector<int> touched;
+    priority_queue<pair<double, int>, vector<pair<double, int>>, greater<pair<double, int>>> pq;
+
+    auto remainingNeighbours = [&](int v){
+        vector<pair<int, double>> res;
+        for(const pair<int, double> &e : adj[v]){
+            if(!contracted[e.first]) res.push_back(e);
+        }
+        return res;
+    };
+
+    //finds the shortcuts needed to contract v (only counts them, with a cheaper search, if shortcuts is nullptr)
+    auto findShortcuts = [&](int v, vector<pair<pair<int, int>, double>> *shortcuts){
+        int settleLimit = shortcuts == nullptr ? ESTIMATE_SETTLE_LIMIT : WITNESS_SETTLE_LIMIT;
+        vector<pair<int, double>> neighbours = remainingNeighbours(v);
+        double maxOut = 0;
+        for(const pair<int, double> &e : neighbours) maxOut = max(maxOut, e.second);
+        int count = 0;
+
+        for(size_t i = 0; i + 1 < neighbours.size(); i++){
+            int u = neighbours[i].first;
+            double limit = neighbours[i].second + maxOut;
+
+            //Dijkstra from u avoiding v
+            dist[u] = 0;
+            touched.push_back(u);
+            pq.push({0, u});
+            int settled = 0;
+            while(!pq.empty() && settled < settleLimit){
+                double d = pq.top().first;
+                int x = pq.top().second;
+                pq.pop();
+                if(d > dist[x]) continue;
+                if(d > limit) break;
+                settled++;
+                for(const pair<int, double> &e : adj[x]){
+                    if(e.first == v || contracted[e.first]) continue;
+                    if(d + e.second < dist[e.first]){
+                        if(dist[e.first] == GraphIndex::infinity()) touched.push_back(e.first);
+                        dist[e.first] = d + e.second;
+                        pq.push({dist[e.first], e.first});
+                    }
+                }
+            }
+
+            for(size_t j = i + 1; j < neighbours.size(); j++){
+                double via = neighbours[i].second + neighbours[j].second;
+                if(dist[neighbours[j].first] > via){
+                    count++;
+                    if(shortcuts != nullptr) shortcuts->push_back({{u, neighbours[j].first}, via});
+                }
+            }
+
+            for(int x : touched) dist[x] = GraphIndex::infinity();
+            touched.clear();
+            pq = priority_queue<pair<double, int>, vector<pair<double, int>>, greater<pair<double, int>>>();
+        }
+        return count;
+    };
+
+    auto priority = [&](int v){
+        return findShortcuts(v, nullptr) - (int) remainingNeighbours(v).size() + contractedNeighbours[v];
+    };
+
+    auto addOrImprove = [&](int u, int x, double w){
+        for(pair<int, double> &e : adj[u]){
+            if(e.first == x){
+                e.second = min(e.second, w);
+                return;
+            }
+        }
+        adj[u].push_back({x, w});
+    };
+
+    priority_queue<pair<int, int>, vector<pair<int, int>>, greater<pair<int, int>>> order;
+    for(int v = 0; v < n; v++) order.push({priority(v), v});
+
+    rank.assign(n, 0);
+    int nextRank = 0;
+    while(!order.empty()){
+        int v = order.top().second;
+        order.pop();
+        if(contracted[v]) continue;
+
+        //lazy update: contracts v only if it is still the least important
+        int p = priority(v);
+        if(!order.empty() && p > order.top().first){
+            order.push({p, v});
+            continue;
+        }
+
+        vector<pair<pair<int, int>, double>> shortcuts;
+        findShortcuts(v, &shortcuts);
+        up[v] = remainingNeighbours(v);
+        rank[v] = nextRank++;
+        contracted[v] = 1;
+        for(const pair<pair<int, int>, double> &s : shortcuts){
+            addOrImprove(s.first.first, s.first.second, s.second);
+            addOrImprove(s.first.second, s.first.first, s.second);
+        }
+        for(const pair<int, double> &e : up[v]) contractedNeighbours[e.first]++;
+        adj[v].clear();
+        adj[v].shrink_to_fit();
+    }
+
+    offsets.assign(n + 1, 0);
+    for(int v = 0; v < n; v++) offsets[v + 1] = offsets[v] + (int) up[v].size();
+    targets.reserve(offsets[n]);
+    weights.reserve(offsets[n]);
+    for(int v = 0; v < n; v++){
+        for(const pair<int, double> &e : up[v]){
+            targets.push_back(e.first);
+            weights.push_back(e.second);
+        }
+    }
+}
+
+/**
+ * Summarizes a graph, so a saved hierarchy is only used with the graph it was built for.
+ * Complexity: O(V + E)
+ * @param g Index of the graph
+ * @return Fingerprint of the graph
+ */
+double ContractionHierarchy::fingerprint(const GraphIndex &g) {
+    double res = g.size() + (double) g.numEdges() * 1e-3;
+    for(int v = 0; v < g.size(); v++){
+        res += g.idOf(v) * 1e-6;
+        for(const Neighbour *e = g.begin(v); e != g.end(v); e++) res += e->weight * (1 + e->to % 7);
+    }
+    return res;
+}
+
+// ============================================================ PERSISTENCE ================================================================
+/**
+ * Writes a vector to a binary file.
+ * @param out File
+ * @param values Values to write
+ */
+template <class T>
+static void writeVector(ofstream &out, const vector<T> &values) {
+    out.write(reinterpret_cast<const char *>(values.data()), (streamsize) (values.size() * sizeof(T)));
+}
+
+/**
+ * Reads a vector from a binary file.
+ * @param in File
+ * @param values Where the values are stored (already with the right size)
+ * @return true if every value was read
+ */
+template <class T>
+static bool readVector(ifstream &in, vector<T> &values) {
+    in.read(reinterpret_cast<char *>(values.data()), (streamsize) (values.size() * sizeof(T)));
+    return (bool) in;
+}
+
+/**
+ * Saves the hierarchy to a binary file.
+ * Complexity: O(V + S) where S is the number of upward edges
+ * @param path Path of the file
+ * @return true if it was written
+ */
+bool ContractionHierarchy::save(const string &path) const {
+    ofstream out(path, ios::binary | ios::trunc);
+    if(!out) return false;
+    out.write(MAGIC, sizeof(MAGIC));
+    out.write(reinterpret_cast<const char *>(&n), sizeof(n));
+    out.write(reinterpret_cast<const char *>(&graphFingerprint), sizeof(graphFingerprint));
+    writeVector(out, rank);
+    writeVector(out, offsets);
+    writeVector(out, targets);
+    writeVector(out, weights);
+    return (bool) out;
+}
+
+/**
+ * Loads a hierarchy saved by save, if it was built for the given graph.
+ * Complexity: O(V + E + S) where S is the number of upward edges
+ * @param path Path of the file
+ * @param g Index of the graph
+ * @return The hierarchy, nullptr if the file doesn't exist, is corrupted or belongs to another graph
+ */
+unique_ptr<ContractionHierarchy> ContractionHierarchy::load(const string &path, const GraphIndex &g) {
+    ifstream in(path, ios::binary);
+    if(!in) return nullptr;
+
+    char magic[sizeof(MAGIC)];
+    unique_ptr<ContractionHierarchy> ch(new ContractionHierarchy());
+    in.read(magic, sizeof(magic));
+    in.read(reinterpret_cast<char *>(&ch->n), sizeof(ch->n));
+    in.read(reinterpret_cast<char *>(&ch->graphFingerprint), sizeof(ch->graphFingerprint));
+    if(!in || memcmp(magic, MAGIC, sizeof(MAGIC)) != 0 || ch->n != g.size() || ch->graphFingerprint != fingerprint(g)){
+        return nullptr;
+    }
+
+    ch->rank.resize(ch->n);
+    ch->offsets.resize(ch->n + 1);
+    if(!readVector(in, ch->rank) || !readVector(in, ch->offsets) || ch->offsets[ch->n] < 0) return nullptr;
+    ch->targets.resize(ch->offsets[ch->n]);
+    ch->weights.resize(ch->offsets[ch->n]);
+    if(!readVector(in, ch->targets) || !readVector(in, ch->weights)) return nullptr;
+    return ch;
+}
+
+// ============================================================ QUERIES ================================================================
+/**
+ * Gets the number of vertexes.
+ * Complexity: O(1)
+ * @return Number of vertexes
+ */
+int ContractionHierarchy::size() const {
+    return n;
+}
+
+/**
+ * Gets the number of upward edges (original edges and shortcuts).
+ * Complexity: O(1)
+ * @return Number of edges
+ */
+size_t ContractionHierarchy::numEdges() const {
+    return targets.size();
+}
+
+/**
+ * Settles every vertex reachable from a source going up in the hierarchy.
+ * Complexity: O(s log s) where s is the size of the search space (small compared to the graph)
+ * @param source Index of the source
+ * @param dist Scratch array of size n, all infinity (left that way)
+ * @param space Where the vertexes settled and their distances are stored
+ */
+void ContractionHierarchy::upwardSearch(int source, vector<double> &dist, vector<pair<int, double>> &space) const {
+    space.clear();
+    priority_queue<pair<double, int>, vector<pair<double, int>>, greater<pair<double, int>>> pq;
+    dist[source] = 0;
+    pq.push({0, source});
+    while(!pq.empty()){
+        double d = pq.top().first;
+        int v = pq.top().second;
+        pq.pop();
+        if(d > dist[v]) continue;
+        space.push_back({v, d});
+        for(int k = offsets[v]; k < offsets[v + 1]; k++){
+            if(d + weights[k] < dist[targets[k]]){
+                dist[targets[k]] = d + weights[k];
+                pq.push({dist[targets[k]], targets[k]});
+            }
+        }
+    }
+    for(const pair<int, double> &p : space) dist[p.first] = GraphIndex::infinity();
+}
+
+/**
+ * Calculates the distances between every source and every target (many-to-many). Each target leaves its upward
+ * search space in buckets; each source runs its upward search and combines it with the buckets it meets.
+ * Complexity: O((s + t) * S log S + M) where S is the size of a search space and M the bucket entries scanned
+ * @param sources Indexes of the sources
+ * @param targets_ Indexes of the targets
+ * @param threads Number of threads
+ * @return Distances, row by row (sources x targets), infinity when there is no route
+ */
+vector<double> ContractionHierarchy::table(const vector<int> &sources, const vector<int> &targets_, unsigned int threads) const {
+    threads = max(threads, 1u);
+    vector<vector<pair<int, double>>> spaces(targets_.size());
+    atomic<size_t> next(0);
+    auto targetWorker = [&](){
+        vector<double> dist(n, GraphIndex::infinity());
+        for(size_t j = next++; j < targets_.size(); j = next++) upwardSearch(targets_[j], dist, spaces[j]);
+    };
+
+    //buckets: the targets whose search space has v are in [bucketStart[v], bucketStart[v + 1])
+    vector<int> bucketStart(n + 1, 0);
+    vector<pair<int, double>> buckets;
+
+    vector<double> res(sources.size() * targets_.size(), GraphIndex::infinity());
+    auto sourceWorker = [&](){
+        vector<double> dist(n, GraphIndex::infinity());
+        vector<pair<int, double>> space;
+        for(size_t i = next++; i < sources.size(); i = next++){
+            upwardSearch(sources[i], dist, space);
+            double *row = res.data() + i * targets_.size();
+            for(const pair<int, double> &p : space){
+                for(int k = bucketStart[p.first]; k < bucketStart[p.first + 1]; k++){
+                    double d = p.second + buckets[k].second;
+                    if(d < row[buckets[k].first]) row[buckets[k].first] = d;
+                }
+            }
+        }
+    };
+
+    auto runWorkers = [&](const function<void()> &worker, size_t jobs){
+        unsigned int used = (unsigned int) min<size_t>(threads, max<size_t>(jobs, 1));
+        next = 0;
+        if(used == 1){
+            worker();
+            return;
+        }
+        ThreadPool pool(used);
+        for(unsigned int t = 0; t < used; t++) pool.submit(worker);
+        pool.wait();
+    };
+
+    runWorkers(targetWorker, targets_.size());
+    for(const vector<pair<int, double>> &space : spaces){
+        for(const pair<int, double> &p : space) bucketStart[p.first + 1]++;
+    }
+    for(int v = 0; v < n; v++) bucketStart[v + 1] += bucketStart[v];
+    buckets.resize(bucketStart[n]);
+    vector<int> fill(bucketStart.begin(), bucketStart.end() - 1);
+    for(size_t j = 0; j < spaces.size(); j++){
+        for(const pair<int, double> &p : spaces[j]) buckets[fill[p.first]++] = {(int) j, p.second};
+    }
+    spaces.clear();
+
+    runWorkers(sourceWorker, sources.size());
+    return res;
+}
+
+/**
+ * Creates the buffers for queries on a hierarchy.
+ * Complexity: O(V)
+ * @param ch Hierarchy (must outlive the query)
+ */
+ContractionHierarchy::Query::Query(const ContractionHierarchy &ch) : ch(ch) {
+    for(int side = 0; side < 2; side++){
+        dist[side].assign(ch.n, GraphIndex::infinity());
+        stamp[side].assign(ch.n, 0);
+    }
+}
+
+/**
+ * Gets the distance found from the source in the current query.
+ * @param v Index of the vertex
+ * @return Distance, infinity if not reached
+ */
+double ContractionHierarchy::Query::forwardDist(int v) const {
+    return stamp[0][v] == epoch ? dist[0][v] : GraphIndex::infinity();
+}
+
+/**
+ * Gets the distance found from the target in the current query.
+ * @param v Index of the vertex
+ * @return Distance, infinity if not reached
+ */
+double ContractionHierarchy::Query::backwardDist(int v) const {
+    return stamp[1][v] == epoch ? dist[1][v] : GraphIndex::infinity();
+}
+
+/**
+ * Calculates the shortest path distance between two vertexes with a bidirectional upward search (with stall on
+ * demand). Each side stops when its closest unsettled vertex is farther than the best meeting point found.
+ * Complexity: O(S log S) where S is the size of the search spaces (microseconds in road networks)
+ * @param s Index of the source
+ * @param t Index of the target
+ * @return Distance, infinity if there is no route
+ */
+double ContractionHierarchy::Query::distance(int s, int t) {
+    if(s == t) return 0;
+    if(++epoch == 0){
+        //the stamps wrapped around: clears them so old entries aren't taken as current
+        for(int side = 0; side < 2; side++) fill(stamp[side].begin(), stamp[side].end(), 0);
+        epoch = 1;
+    }
+    for(int side = 0; side < 2; side++){
+        queues[side] = Heap();
+        int start = side == 0 ? s : t;
+        dist[side][start] = 0;
+        stamp[side][start] = epoch;
+        queues[side].push({0, start});
+    }
+
+    double best = GraphIndex::infinity();
+    while(!queues[0].empty() || !queues[1].empty()){
+        int side = queues[1].empty() || (!queues[0].empty() && queues[0].top().first <= queues[1].top().first) ? 0 : 1;
+        Heap &queue = queues[side];
+        double d = queue.top().first;
+        int v = queue.top().second;
+        queue.pop();
+        if(d >= best){
+            queue = Heap();
+            continue;
+        }
+        if(d > dist[side][v]) continue;
+
+        double other = side == 0 ? backwardDist(v) : forwardDist(v);
+        if(d + other < best) best = d + other;
+
+        //stall on demand: if a higher neighbour reaches v with a shorter distance, v isn't on a shortest up-path
+        bool stalled = false;
+        for(int k = ch.offsets[v]; k < ch.offsets[v + 1] && !stalled; k++){
+            int w = ch.targets[k];
+            stalled = stamp[side][w] == epoch && dist[side][w] + ch.weights[k] < d;
+        }
+        if(stalled) continue;
+
+        for(int k = ch.offsets[v]; k < ch.offsets[v + 1]; k++){
+            int w = ch.targets[k];
+            double nd = d + ch.weights[k];
+            if(stamp[side][w] != epoch || nd < dist[side][w]){
+                stamp[side][w] = epoch;
+                dist[side][w] = nd;
+                queue.push({nd, w});
+            }
+        }
+    }
+    return best;
+}
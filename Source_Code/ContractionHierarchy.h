@@ -0,0 +1,74 @@
+//
+// Created by lucas on 19/10/2026.
+//
+
+#ifndef PROJECT2_CONTRACTIONHIERARCHY_H
+#define PROJECT2_CONTRACTIONHIERARCHY_H
+
+#include <functional>
+#include <memory>
+#include <queue>
+#include <string>
+#include <utility>
+#include <vector>
+#include "GraphIndex.h"
+
+/**
+ * @file ContractionHierarchy.h
+ * @brief Definition of class ContractionHierarchy.
+ *
+ * \class ContractionHierarchy
+ * Contraction hierarchy of an undirected graph: the vertexes are contracted one by one (the least important
+ * first) and shortcuts are added so the distances between the remaining vertexes don't change. A distance is
+ * then found by two small Dijkstra searches that only go up in the hierarchy, one from each end.
+ * Built once per dataset (it can be saved next to it) and read-only afterwards.
+ */
+class ContractionHierarchy {
+public:
+    explicit ContractionHierarchy(const GraphIndex &g);
+
+    static std::unique_ptr<ContractionHierarchy> load(const std::string &path, const GraphIndex &g);
+    bool save(const std::string &path) const;
+
+    int size() const;
+    size_t numEdges() const;
+    std::vector<double> table(const std::vector<int> &sources, const std::vector<int> &targets, unsigned int threads) const;
+
+    /**
+     * \class Query
+     * Buffers of the bidirectional search, reused between queries. Each thread must use its own.
+     */
+    class Query {
+    public:
+        explicit Query(const ContractionHierarchy &ch);
+        double distance(int s, int t);
+
+    private:
+        typedef std::pair<double, int> Entry;
+        typedef std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> Heap;
+
+        double forwardDist(int v) const;
+        double backwardDist(int v) const;
+
+        const ContractionHierarchy &ch;
+        unsigned int epoch = 0;
+        std::vector<double> dist[2];
+        std::vector<unsigned int> stamp[2];
+        Heap queues[2];
+    };
+
+private:
+    ContractionHierarchy() = default;
+
+    static double fingerprint(const GraphIndex &g);
+    void upwardSearch(int source, std::vector<double> &dist, std::vector<std::pair<int, double>> &space) const;
+
+    int n = 0;
+    double graphFingerprint = 0;
+    std::vector<int> rank;
+    std::vector<int> offsets;           // upward edges of v are in [offsets[v], offsets[v + 1])
+    std::vector<int> targets;
+    std::vector<double> weights;
+};
+
+#endif //PROJECT2_CONTRACTIONHIERARCHY_H
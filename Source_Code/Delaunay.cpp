@@ -0,0 +1,218 @@
+//
+// Created by lucas on 19/10/2026.
+//
+
+#include "Delaunay.h"
+#include "Ordering.h"
+#include "SpatialGrid.h"
+#include <algorithm>
+#include <cmath>
+
+using namespace std;
+
+/**
+ * @file Delaunay.cpp
+ * @brief Implementation of the Delaunay triangulation (Bowyer-Watson) and of the quadrant neighbours.
+ */
+
+/**
+ * \struct Triangle
+ * Triangle of the triangulation, counterclockwise. neighbour[i] is the triangle across the edge opposite to v[i]
+ * (from v[i + 1] to v[i + 2]), -1 on the outer boundary.
+ */
+struct Triangle {
+    int v[3];
+    int neighbour[3];
+};
+
+/**
+ * Checks on which side of the line from a to b the point c is.
+ * Complexity: O(1)
+ * @return Positive if a, b, c turn counterclockwise, negative if clockwise, 0 if collinear
+ */
+static double orientation(const vector<double> &x, const vector<double> &y, int a, int b, int c) {
+    return (x[b] - x[a]) * (y[c] - y[a]) - (y[b] - y[a]) * (x[c] - x[a]);
+}
+
+/**
+ * Checks if a point is strictly inside the circle through the corners of a triangle. The corners are taken
+ * relative to the point, which keeps the products small.
+ * Complexity: O(1)
+ * @param t Triangle (counterclockwise)
+ * @param p Point
+ * @return true if p is inside the circumcircle
+ */
+static bool inCircumcircle(const vector<double> &x, const vector<double> &y, const Triangle &t, int p) {
+    double ax = x[t.v[0]] - x[p], ay = y[t.v[0]] - y[p];
+    double bx = x[t.v[1]] - x[p], by = y[t.v[1]] - y[p];
+    double cx = x[t.v[2]] - x[p], cy = y[t.v[2]] - y[p];
+    double det = (ax * ax + ay * ay) * (bx * cy - cx * by)
+               - (bx * bx + by * by) * (ax * cy - cx * ay)
+               + (cx * cx + cy * cy) * (ax * by - bx * ay);
+    return det > 0;
+}
+
+/**
+ * Calculates the Delaunay triangulation of the points (projected like in SpatialGrid) by Bowyer-Watson: the points
+ * are added one at a time inside a triangle that holds them all, and each removes the triangles whose circumcircle
+ * holds it (a connected cavity around it) and joins itself to the boundary of the cavity. The points are added
+ * along a Hilbert curve, so the triangle holding the next point is found by a short walk from the last triangle
+ * created and the cavities stay small.
+ * Points with the same coordinates as an earlier one are not triangulated: they get its neighbours and it.
+ * Complexity: O(n log n) for evenly spread points (the sort along the curve), O(n^2) in the worst case
+ * @param nodes Points
+ * @return The neighbours of each point in the triangulation (by position in nodes), by increasing position
+ */
+vector<vector<int>> delaunayNeighbours(const vector<NodeInfo> &nodes) {
+    int n = (int) nodes.size();
+    vector<vector<int>> neighbours(n);
+    if(n < 2) return neighbours;
+    vector<double> x, y;
+    projectCoordinates(nodes, x, y);
+
+    //the first triangle has every point well inside it: its corners are the points n, n + 1 and n + 2
+    double minX = *min_element(x.begin(), x.end()), maxX = *max_element(x.begin(), x.end());
+    double minY = *min_element(y.begin(), y.end()), maxY = *max_element(y.begin(), y.end());
+    double span = max(max(maxX - minX, maxY - minY), 1e-9);
+    double midX = (minX + maxX) / 2, midY = (minY + maxY) / 2;
+    x.push_back(midX - 100 * span);
+    y.push_back(midY - 100 * span);
+    x.push_back(midX + 100 * span);
+    y.push_back(midY - 100 * span);
+    x.push_back(midX);
+    y.push_back(midY + 100 * span);
+
+    vector<Triangle> triangles {{{n, n + 1, n + 2}, {-1, -1, -1}}};
+    vector<int> cavityOf {-1};              // last point whose cavity held each triangle
+    vector<int> cavity, stack, created;
+    vector<int> startsAt(n + 3), endsAt(n + 3); // triangle created for the boundary edge that starts / ends at a point
+    vector<int> twin(n, -1);                // earlier point with the same coordinates
+    int last = 0;
+
+    for(int p : hilbertOrder(nodes)){
+        //walks towards p, crossing an edge that has p on its other side (on a Delaunay triangulation this always ends)
+        int t = last;
+        for(int steps = 0;; steps++){
+            int next = -1;
+            for(int k = 0; k < 3 && next == -1; k++){
+                int i = (k + steps) % 3;
+                const Triangle &triangle = triangles[t];
+                if(triangle.neighbour[i] != -1 && orientation(x, y, triangle.v[(i + 1) % 3], triangle.v[(i + 2) % 3], p) < 0) next = triangle.neighbour[i];
+            }
+            if(next == -1) break;
+            t = next;
+        }
+        for(int corner : triangles[t].v){
+            if(corner < n && x[corner] == x[p] && y[corner] == y[p]) twin[p] = corner;
+        }
+        if(twin[p] != -1) continue;
+
+        //the cavity: the triangles around t whose circumcircle holds p
+        cavity.clear();
+        stack.assign(1, t);
+        cavityOf[t] = p;
+        while(!stack.empty()){
+            int b = stack.back();
+            stack.pop_back();
+            cavity.push_back(b);
+            for(int o : triangles[b].neighbour){
+                if(o != -1 && cavityOf[o] != p && inCircumcircle(x, y, triangles[o], p)){
+                    cavityOf[o] = p;
+                    stack.push_back(o);
+                }
+            }
+        }
+
+        //a triangle from each boundary edge of the cavity to p
+        created.clear();
+        for(int b : cavity){
+            for(int i = 0; i < 3; i++){
+                int o = triangles[b].neighbour[i];
+                if(o != -1 && cavityOf[o] == p) continue;
+                int from = triangles[b].v[(i + 1) % 3], to = triangles[b].v[(i + 2) % 3];
+                int id = (int) triangles.size();
+                triangles.push_back({{from, to, p}, {-1, -1, o}});
+                cavityOf.push_back(-1);
+                if(o != -1){
+                    for(int &back : triangles[o].neighbour) if(back == b) back = id;
+                }
+                startsAt[from] = id;
+                endsAt[to] = id;
+                created.push_back(id);
+            }
+        }
+        //the new triangles around p: the one after (from, to, p) starts at to, the one before ends at from
+        for(int id : created){
+            Triangle &triangle = triangles[id];
+            triangle.neighbour[0] = startsAt[triangle.v[1]];
+            triangle.neighbour[1] = endsAt[triangle.v[0]];
+        }
+        //the last triangles created take the slots of the removed ones (there are two more of them)
+        last = created.back();
+        for(int slot : cavity){
+            int moved = (int) triangles.size() - 1;
+            triangles[slot] = triangles[moved];
+            cavityOf[slot] = cavityOf[moved];
+            for(int o : triangles[slot].neighbour){
+                if(o == -1) continue;
+                for(int &back : triangles[o].neighbour) if(back == moved) back = slot;
+            }
+            if(last == moved) last = slot;
+            triangles.pop_back();
+            cavityOf.pop_back();
+        }
+    }
+
+    for(const Triangle &triangle : triangles){
+        for(int i = 0; i < 3; i++){
+            int u = triangle.v[i], v = triangle.v[(i + 1) % 3];
+            if(u < n && v < n){
+                neighbours[u].push_back(v);
+                neighbours[v].push_back(u);
+            }
+        }
+    }
+    for(int p = 0; p < n; p++){
+        if(twin[p] == -1) continue;
+        neighbours[p] = neighbours[twin[p]];
+        neighbours[p].push_back(twin[p]);
+    }
+    for(int p = 0; p < n; p++){
+        if(twin[p] != -1) neighbours[twin[p]].push_back(p);
+    }
+    for(vector<int> &list : neighbours){
+        sort(list.begin(), list.end());
+        list.erase(unique(list.begin(), list.end()), list.end());
+    }
+    return neighbours;
+}
+
+/**
+ * Adds to each point the points closest to it in each quadrant around it (north-east, north-west, south-west,
+ * south-east of the projection), among its 8 * perQuadrant closest points.
+ * Complexity: O(n * perQuadrant log perQuadrant) for evenly spread points
+ * @param nodes Points
+ * @param perQuadrant Points added per quadrant (at most)
+ * @param neighbours Neighbours of each point, by increasing position (kept that way)
+ */
+void addQuadrantNeighbours(const vector<NodeInfo> &nodes, int perQuadrant, vector<vector<int>> &neighbours) {
+    int n = (int) nodes.size();
+    vector<double> x, y;
+    projectCoordinates(nodes, x, y);
+    SpatialGrid grid(nodes);
+    for(int v = 0; v < n; v++) grid.insert(v);
+
+    vector<int> near;
+    for(int v = 0; v < n; v++){
+        grid.nearest(v, 8 * perQuadrant, near);
+        int taken[4] = {0, 0, 0, 0};
+        for(int u : near){
+            int quadrant = (x[u] >= x[v] ? 0 : 1) + (y[u] >= y[v] ? 0 : 2);
+            if(taken[quadrant] == perQuadrant) continue;
+            taken[quadrant]++;
+            neighbours[v].push_back(u);
+        }
+        sort(neighbours[v].begin(), neighbours[v].end());
+        neighbours[v].erase(unique(neighbours[v].begin(), neighbours[v].end()), neighbours[v].end());
+    }
+}
@@ -0,0 +1,25 @@
+//
+// Created by lucas on 19/10/2026.
+//
+
+#ifndef PROJECT2_DELAUNAY_H
+#define PROJECT2_DELAUNAY_H
+
+#include <vector>
+#include "NodeInfo.h"
+
+/**
+ * @file Delaunay.h
+ * @brief Delaunay triangulation of the coordinates, used as a sparse candidate graph.
+ *
+ * When only the coordinates are known, the edges of the Delaunay triangulation (on the projection of SpatialGrid)
+ * are a good guess of the edges a short tour uses: about 6 per vertex on average, and they hold the Euclidean
+ * minimum spanning tree and almost every edge of the optimal tour. They are found without looking at the O(n^2)
+ * pairs. Clustered points can leave a vertex whose triangulation neighbours are all on one side, so the closest
+ * points in each quadrant around it may be added as well.
+ */
+
+std::vector<std::vector<int>> delaunayNeighbours(const std::vector<NodeInfo> &nodes);
+void addQuadrantNeighbours(const std::vector<NodeInfo> &nodes, int perQuadrant, std::vector<std::vector<int>> &neighbours);
+
+#endif //PROJECT2_DELAUNAY_H
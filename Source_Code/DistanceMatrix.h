@@ -0,0 +1,212 @@
+//
+// Created by lucas on 19/10/2026.
+//
+
+#ifndef PROJECT2_DISTANCEMATRIX_H
+#define PROJECT2_DISTANCEMATRIX_H
+
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <vector>
+#include "GraphIndex.h"
+
+/**
+ * @file DistanceMatrix.h
+ * @brief Definition of the distance matrixes: a layout (how the cells are arranged) and a value type (how each
+ * distance is stored) chosen at compile time, read through the same accessor.
+ *
+ * All our datasets are undirected, so the matrixes are symmetric: set(i, j, d) also sets (j, i).
+ * SolverDistanceMatrix is the type used by the solvers: packed, with the value type of the CMake option
+ * TSP_MATRIX_VALUE (double by default, so exact; float or uint32 take half of that memory, a quarter of a square
+ * double matrix, but round the distances, so the solvers only sum exact matrixes into the costs, see exact()).
+ */
+
+/**
+ * \struct SquareLayout
+ * Every cell stored: n * n cells.
+ */
+struct SquareLayout {
+    static size_t cells(int n) { return (size_t) n * n; }
+    static size_t offset(int i, int j, int n) { return (size_t) i * n + j; }
+};
+
+/**
+ * \struct PackedLayout
+ * Upper triangle (diagonal included) stored row by row: n * (n + 1) / 2 cells.
+ */
+struct PackedLayout {
+    static size_t cells(int n) { return (size_t) n * (n + 1) / 2; }
+    static size_t offset(int i, int j, int n) {
+        if (i > j) std::swap(i, j);
+        return (size_t) i * n - (size_t) i * (i - 1) / 2 + (j - i);
+    }
+};
+
+/**
+ * \struct DoubleValue
+ * Distances stored as double (exact).
+ */
+struct DoubleValue {
+    typedef double Stored;
+    static const bool EXACT = true;
+    static double scaleFor(double) { return 1; }
+    static Stored encode(double d, double) { return d; }
+    static double decode(Stored s, double) { return s; }
+};
+
+/**
+ * \struct FloatValue
+ * Distances stored as float (about 7 significant digits, enough for metre-scale distances).
+ */
+struct FloatValue {
+    typedef float Stored;
+    static const bool EXACT = false;
+    static double scaleFor(double) { return 1; }
+    static Stored encode(double d, double) { return (float) d; }
+    static double decode(Stored s, double) { return s; }
+};
+
+/**
+ * \struct ScaledUInt32Value
+ * Distances stored as multiples of a scale (the largest distance / (2^32 - 2)), so the rounding error is at most
+ * half of the scale. 2^32 - 1 stands for infinity.
+ */
+struct ScaledUInt32Value {
+    typedef uint32_t Stored;
+    static const bool EXACT = false;
+    static const Stored INFINITE = std::numeric_limits<uint32_t>::max();
+    static double scaleFor(double maxValue) { return maxValue > 0 ? maxValue / (INFINITE - 1) : 1; }
+    static Stored encode(double d, double scale) {
+        return d == std::numeric_limits<double>::infinity() ? INFINITE : (Stored) std::llround(d / scale);
+    }
+    static double decode(Stored s, double scale) {
+        return s == INFINITE ? std::numeric_limits<double>::infinity() : s * scale;
+    }
+};
+
+/**
+ * \class DistanceMatrix
+ * Symmetric distance matrix with the given layout and value type. Starts with every distance infinite
+ * (0 in the diagonal).
+ */
+template <class Layout, class Value>
+class DistanceMatrix {
+public:
+    DistanceMatrix(int n, double maxValue);
+
+    int size() const;
+    double operator()(int i, int j) const;
+    void set(int i, int j, double d);
+    size_t bytes() const;
+    static bool exact();
+
+private:
+    int n;
+    double scale;
+    std::vector<typename Value::Stored> cells;
+};
+
+/**
+ * Creates a matrix with every distance infinite.
+ * Complexity: O(n^2)
+ * @tparam Layout Layout of the cells
+ * @tparam Value Value type of the cells
+ * @param n Number of vertexes
+ * @param maxValue Largest finite distance that will be stored (only used by the scaled types)
+ */
+template <class Layout, class Value>
+DistanceMatrix<Layout, Value>::DistanceMatrix(int n, double maxValue) : n(n), scale(Value::scaleFor(maxValue)),
+    cells(Layout::cells(n), Value::encode(std::numeric_limits<double>::infinity(), Value::scaleFor(maxValue))) {
+    for (int i = 0; i < n; i++) set(i, i, 0);
+}
+
+/**
+ * Gets the number of vertexes.
+ * Complexity: O(1)
+ * @return Number of vertexes
+ */
+template <class Layout, class Value>
+int DistanceMatrix<Layout, Value>::size() const {
+    return n;
+}
+
+/**
+ * Gets a distance.
+ * Complexity: O(1)
+ * @param i First vertex
+ * @param j Second vertex
+ * @return Distance, infinity if there is none
+ */
+template <class Layout, class Value>
+double DistanceMatrix<Layout, Value>::operator()(int i, int j) const {
+    return Value::decode(cells[Layout::offset(i, j, n)], scale);
+}
+
+/**
+ * Sets a distance (in both directions).
+ * Complexity: O(1)
+ * @param i First vertex
+ * @param j Second vertex
+ * @param d Distance
+ */
+template <class Layout, class Value>
+void DistanceMatrix<Layout, Value>::set(int i, int j, double d) {
+    cells[Layout::offset(i, j, n)] = Value::encode(d, scale);
+    cells[Layout::offset(j, i, n)] = Value::encode(d, scale);
+}
+
+/**
+ * Gets the memory used by the cells.
+ * Complexity: O(1)
+ * @return Bytes
+ */
+template <class Layout, class Value>
+size_t DistanceMatrix<Layout, Value>::bytes() const {
+    return cells.size() * sizeof(typename Value::Stored);
+}
+
+/**
+ * Checks if the distances are stored without rounding (for the weights of the graphs, see Weight.h).
+ * Complexity: O(1)
+ * @return true for the double matrixes
+ */
+template <class Layout, class Value>
+bool DistanceMatrix<Layout, Value>::exact() {
+    return Value::EXACT;
+}
+
+/**
+ * Builds the matrix of the edge weights of a graph (infinity where there is no edge).
+ * Complexity: O(V^2 + E)
+ * @tparam Matrix Type of the matrix
+ * @param g Index of the graph
+ * @return The matrix
+ */
+template <class Matrix>
+Matrix buildEdgeMatrix(const GraphIndex &g) {
+    double maxValue = 0;
+    for (int v = 0; v < g.size(); v++) {
+        for (const Neighbour *e = g.begin(v); e != g.end(v); e++) maxValue = std::max<double>(maxValue, e->weight);
+    }
+
+    Matrix matrix(g.size(), maxValue);
+    for (int v = 0; v < g.size(); v++) {
+        //the neighbours are sorted by weight, so the first edge to each vertex is the lightest
+        for (const Neighbour *e = g.end(v); e != g.begin(v);) {
+            --e;
+            if (e->to != v) matrix.set(v, e->to, e->weight);
+        }
+    }
+    return matrix;
+}
+
+#if defined(TSP_MATRIX_FLOAT)
+typedef DistanceMatrix<PackedLayout, FloatValue> SolverDistanceMatrix;
+#elif defined(TSP_MATRIX_UINT32)
+typedef DistanceMatrix<PackedLayout, ScaledUInt32Value> SolverDistanceMatrix;
+#else
+typedef DistanceMatrix<PackedLayout, DoubleValue> SolverDistanceMatrix;
+#endif
+
+#endif //PROJECT2_DISTANCEMATRIX_H
@@ -0,0 +1,182 @@
+//
+// Created by lucas on 19/10/2026.
+//
+
+#include "DistanceOracle.h"
+#include <algorithm>
+#include <mutex>
+#include "ShortestPaths.h"
+#include "ThreadPool.h"
+
+using namespace std;
+
+/**
+ * @file DistanceOracle.cpp
+ * @brief Implementation of class DistanceOracle.
+ */
+
+/**
+ * Creates an empty oracle.
+ * Complexity: O(1)
+ * @param g Index of the graph (must outlive the oracle)
+ * @param maxBytes Memory the cached rows may use (at least one row is always kept)
+ * @param singlePrecision If the rows are stored as float instead of double
+ */
+DistanceOracle::DistanceOracle(const GraphIndex &g, size_t maxBytes, bool singlePrecision) : g(g), singlePrecision(singlePrecision) {
+    size_t rowBytes = max<size_t>(1, (size_t) g.size() * (singlePrecision ? sizeof(float) : sizeof(double)));
+    maxRows = max<size_t>(1, maxBytes / rowBytes);
+}
+
+/**
+ * Gets a distance of a row.
+ * Complexity: O(1)
+ * @param v Index of the destination
+ * @return Distance, infinity if v can't be reached
+ */
+double DistanceOracle::Row::at(int v) const {
+    return compact.empty() ? distances[v] : (double) compact[v];
+}
+
+/**
+ * Gets the shortest path distance between two vertexes, calculating the row of u if neither u nor v (the graphs
+ * are undirected) is cached.
+ * Complexity: O(1) if cached, O(E log E) otherwise
+ * @param u Index of the origin
+ * @param v Index of the destination
+ * @return Distance, infinity if there is no route
+ */
+double DistanceOracle::distance(int u, int v) {
+    if(u == v) return 0;
+    shared_ptr<Row> row = findRow(u);
+    if(row != nullptr) return row->at(v);
+    row = findRow(v);
+    if(row != nullptr) return row->at(u);
+
+    missCount++;
+    row = computeRow(u);
+    insertRow(u, row);
+    return row->at(v);
+}
+
+/**
+ * Calculates the rows of several sources at once (in parallel), so the following queries are hits.
+ * Only the first sources that fit in the cache are calculated.
+ * Complexity: O(s * E log E / T) where s is the number of sources and T the number of threads
+ * @param sources Indexes of the sources
+ * @param threads Number of threads
+ */
+void DistanceOracle::prefetch(const vector<int> &sources, unsigned int threads) {
+    vector<int> needed;
+    vector<char> queued(g.size(), 0);
+    for(int source : sources){
+        if(needed.size() >= maxRows) break;
+        if(!queued[source] && findRow(source) == nullptr){
+            queued[source] = 1;
+            needed.push_back(source);
+        }
+    }
+    if(needed.empty()) return;
+
+    atomic<size_t> next(0);
+    auto worker = [&](){
+        for(size_t i = next++; i < needed.size(); i = next++){
+            missCount++;
+            insertRow(needed[i], computeRow(needed[i]));
+        }
+    };
+    threads = (unsigned int) min<size_t>(max(threads, 1u), needed.size());
+    if(threads == 1){
+        worker();
+        return;
+    }
+    ThreadPool pool(threads);
+    for(unsigned int t = 0; t < threads; t++) pool.submit(worker);
+    pool.wait();
+}
+
+/**
+ * Looks for a cached row and marks it as used.
+ * Complexity: O(1)
+ * @param source Index of the source
+ * @return The row, nullptr if it isn't cached
+ */
+shared_ptr<DistanceOracle::Row> DistanceOracle::findRow(int source) {
+    shared_lock<shared_timed_mutex> lock(mutex);
+    auto it = rows.find(source);
+    if(it == rows.end()) return nullptr;
+    it->second->lastUse = ++clock;
+    hitCount++;
+    return it->second;
+}
+
+/**
+ * Calculates the row of a source (no lock is held, so several rows can be calculated at the same time).
+ * Complexity: O(E log E)
+ * @param source Index of the source
+ * @return The row
+ */
+shared_ptr<DistanceOracle::Row> DistanceOracle::computeRow(int source) const {
+    DijkstraSearch search(g);
+    search.start(source);
+    while(search.settleNext() != -1);
+
+    shared_ptr<Row> row = make_shared<Row>();
+    int n = g.size();
+    if(singlePrecision){
+        row->compact.resize(n);
+        for(int v = 0; v < n; v++) row->compact[v] = (float) search.distance(v);
+    }
+    else{
+        row->distances.resize(n);
+        for(int v = 0; v < n; v++) row->distances[v] = search.distance(v);
+    }
+    return row;
+}
+
+/**
+ * Adds a row to the cache, dropping the least recently used rows if it is full.
+ * Complexity: O(r) where r is the number of cached rows (only when a row has to be dropped)
+ * @param source Index of the source
+ * @param row Row of the source
+ */
+void DistanceOracle::insertRow(int source, const shared_ptr<Row> &row) {
+    unique_lock<shared_timed_mutex> lock(mutex);
+    row->lastUse = ++clock;
+    if(!rows.insert({source, row}).second) return; //another thread calculated it first
+
+    while(rows.size() > maxRows){
+        auto oldest = rows.begin();
+        for(auto it = rows.begin(); it != rows.end(); it++){
+            if(it->second->lastUse < oldest->second->lastUse) oldest = it;
+        }
+        rows.erase(oldest); //readers still holding it keep it alive
+    }
+}
+
+/**
+ * Gets the number of cached rows.
+ * Complexity: O(1)
+ * @return Number of rows
+ */
+size_t DistanceOracle::cachedRows() const {
+    shared_lock<shared_timed_mutex> lock(mutex);
+    return rows.size();
+}
+
+/**
+ * Gets the number of queries answered by a cached row.
+ * Complexity: O(1)
+ * @return Number of hits
+ */
+unsigned long long DistanceOracle::hits() const {
+    return hitCount;
+}
+
+/**
+ * Gets the number of rows calculated.
+ * Complexity: O(1)
+ * @return Number of misses
+ */
+unsigned long long DistanceOracle::misses() const {
+    return missCount;
+}
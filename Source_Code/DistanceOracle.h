@@ -0,0 +1,61 @@
+//
+// Created by lucas on 19/10/2026.
+//
+
+#ifndef PROJECT2_DISTANCEORACLE_H
+#define PROJECT2_DISTANCEORACLE_H
+
+#include <atomic>
+#include <memory>
+#include <shared_mutex>
+#include <unordered_map>
+#include <vector>
+#include "GraphIndex.h"
+
+/**
+ * @file DistanceOracle.h
+ * @brief Definition of class DistanceOracle.
+ *
+ * \class DistanceOracle
+ * Answers shortest path distance queries without the full n x n matrix (800 MB for 10000 vertexes).
+ * The rows (all the distances from one source) are calculated with Dijkstra when first needed and kept in a
+ * cache limited in bytes; when it is full the least recently used row is dropped. Rows can be stored as float
+ * to fit twice as many.
+ * Queries can be made by several threads at the same time: hits only take a shared lock.
+ */
+class DistanceOracle {
+public:
+    DistanceOracle(const GraphIndex &g, size_t maxBytes, bool singlePrecision);
+
+    double distance(int u, int v);
+    void prefetch(const std::vector<int> &sources, unsigned int threads);
+
+    size_t cachedRows() const;
+    unsigned long long hits() const;
+    unsigned long long misses() const;
+
+private:
+    struct Row {
+        std::vector<double> distances;      // used with double precision
+        std::vector<float> compact;         // used with single precision
+        std::atomic<unsigned long long> lastUse {0};
+
+        double at(int v) const;
+    };
+
+    std::shared_ptr<Row> findRow(int source);
+    std::shared_ptr<Row> computeRow(int source) const;
+    void insertRow(int source, const std::shared_ptr<Row> &row);
+
+    const GraphIndex &g;
+    size_t maxRows;
+    bool singlePrecision;
+
+    mutable std::shared_timed_mutex mutex;
+    std::unordered_map<int, std::shared_ptr<Row>> rows;
+    std::atomic<unsigned long long> clock {0};
+    std::atomic<unsigned long long> hitCount {0};
+    std::atomic<unsigned long long> missCount {0};
+};
+
+#endif //PROJECT2_DISTANCEORACLE_H
@@ -0,0 +1,164 @@
+//
+// Created by lucas on 19/10/2026.
+//
+
+#ifndef PROJECT2_DISTANCEPOLICY_H
+#define PROJECT2_DISTANCEPOLICY_H
+
+#include <cmath>
+#include <vector>
+#include "ContractionHierarchy.h"
+#include "DistanceMatrix.h"
+#include "DistanceOracle.h"
+#include "GraphIndex.h"
+#include "Weight.h"
+
+/**
+ * @file DistancePolicy.h
+ * @brief Definition of the distance policies: how the templated heuristics (TourHeuristics.h) get the cost
+ * between two vertexes.
+ *
+ * Every policy has size() and operator()(u, v), in the units of the graph weights and with u, v indexes of a
+ * GraphIndex. The policy is chosen once per run, so the compiler inlines the distance in the inner loops
+ * instead of deciding in each evaluation between edges, matrixes and coordinates.
+ */
+
+/**
+ * \class EdgeDistance
+ * Weight of the edge between the vertexes (binary search in the index), infinity if there is none.
+ */
+class EdgeDistance {
+public:
+    explicit EdgeDistance(const GraphIndex &g) : g(g) {}
+    int size() const { return g.size(); }
+    double operator()(int u, int v) const { return u == v ? 0 : g.weight(u, v); }
+
+private:
+    const GraphIndex &g;
+};
+
+/**
+ * \class MatrixDistance
+ * Weight of the edge read from a distance matrix (dense graphs).
+ */
+class MatrixDistance {
+public:
+    explicit MatrixDistance(const SolverDistanceMatrix &matrix) : matrix(matrix) {}
+    int size() const { return matrix.size(); }
+    double operator()(int u, int v) const { return matrix(u, v); }
+
+private:
+    const SolverDistanceMatrix &matrix;
+};
+
+/**
+ * \class GeodesicDistance
+ * Great-circle distance between the coordinates of the vertexes (the haversine formula, with the radians and
+ * cosines of the latitudes calculated beforehand).
+ */
+class GeodesicDistance {
+public:
+    explicit GeodesicDistance(const GraphIndex &g) : unitsPerMetre(1 / WeightTraits<Weight>::toMetres(1)) {
+        for(int v = 0; v < g.size(); v++){
+            latitude.push_back(g.info(v).getLatitude() * M_PI / 180.0);
+            longitude.push_back(g.info(v).getLongitude() * M_PI / 180.0);
+            cosLatitude.push_back(std::cos(latitude.back()));
+        }
+    }
+    int size() const { return (int) latitude.size(); }
+    double operator()(int u, int v) const {
+        double sinLat = std::sin((latitude[v] - latitude[u]) / 2);
+        double sinLon = std::sin((longitude[v] - longitude[u]) / 2);
+        double a = sinLat * sinLat + sinLon * sinLon * cosLatitude[u] * cosLatitude[v];
+        return 2 * 6371000.0 * std::asin(std::sqrt(a)) * unitsPerMetre;
+    }
+
+private:
+    std::vector<double> latitude, longitude, cosLatitude;
+    double unitsPerMetre;
+};
+
+/**
+ * \class EuclideanDistance
+ * Straight line distance on an equirectangular projection of the coordinates (centred on the mean latitude):
+ * no trigonometry per evaluation and close to the geodesic distance within a city.
+ */
+class EuclideanDistance {
+public:
+    explicit EuclideanDistance(const GraphIndex &g) {
+        std::vector<NodeInfo> nodes;
+        for(int v = 0; v < g.size(); v++) nodes.push_back(g.info(v));
+        project(nodes);
+    }
+    explicit EuclideanDistance(const std::vector<NodeInfo> &nodes) {
+        project(nodes);
+    }
+    int size() const { return (int) x.size(); }
+    double operator()(int u, int v) const {
+        double dx = x[u] - x[v], dy = y[u] - y[v];
+        return std::sqrt(dx * dx + dy * dy);
+    }
+
+private:
+    void project(const std::vector<NodeInfo> &nodes) {
+        double meanLatitude = 0;
+        for(const NodeInfo &node : nodes) meanLatitude += node.getLatitude() / nodes.size();
+        double metresPerDegree = 6371000.0 * M_PI / 180.0 / WeightTraits<Weight>::toMetres(1);
+        double xScale = metresPerDegree * std::cos(meanLatitude * M_PI / 180.0);
+        for(const NodeInfo &node : nodes){
+            x.push_back(node.getLongitude() * xScale);
+            y.push_back(node.getLatitude() * metresPerDegree);
+        }
+    }
+
+    std::vector<double> x, y;
+};
+
+/**
+ * \class LocalDistance
+ * Distances between a few vertexes (e.g. a cluster of a large graph), calculated beforehand into a square
+ * matrix: the policy numbers them by their position in that set.
+ */
+class LocalDistance {
+public:
+    explicit LocalDistance(int n) : n(n), dist((size_t) n * n, 0) {}
+    int size() const { return n; }
+    double operator()(int u, int v) const { return dist[(size_t) u * n + v]; }
+    void set(int u, int v, double distance) { dist[(size_t) u * n + v] = dist[(size_t) v * n + u] = distance; }
+
+private:
+    int n;
+    std::vector<double> dist;
+};
+
+/**
+ * \class OracleDistance
+ * Shortest path distance from the distance oracle (rows calculated on demand and cached).
+ */
+class OracleDistance {
+public:
+    OracleDistance(DistanceOracle &oracle, int n) : oracle(&oracle), n(n) {}
+    int size() const { return n; }
+    double operator()(int u, int v) const { return oracle->distance(u, v); }
+
+private:
+    DistanceOracle *oracle;
+    int n;
+};
+
+/**
+ * \class HierarchyDistance
+ * Shortest path distance from a contraction hierarchy (its query buffers belong to this policy).
+ */
+class HierarchyDistance {
+public:
+    explicit HierarchyDistance(const ContractionHierarchy &ch) : query(new ContractionHierarchy::Query(ch)), n(ch.size()) {}
+    int size() const { return n; }
+    double operator()(int u, int v) const { return query->distance(u, v); }
+
+private:
+    std::shared_ptr<ContractionHierarchy::Query> query;
+    int n;
+};
+
+#endif //PROJECT2_DISTANCEPOLICY_H
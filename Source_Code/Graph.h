@@ -5,124 +5,113 @@
 #define DA_TP_CLASSES_GRAPH
 
 #include <iostream>
+#include <memory>
+#include <unordered_map>
 #include <unordered_set>
 #include <vector>
 #include <queue>
 #include <limits>
 #include <algorithm>
 #include "NodeInfo.h"
+#include "ThreadPool.h"
+#include "Weight.h"
 
-template <class T>
+template <class T, class W = Weight>
 class Edge;
 
 /************************* Vertex  **************************/
 
-template <class T>
+template <class T, class W = Weight>
 class Vertex {
 public:
     Vertex(T in);
     T getInfo() const;
-    std::vector<Edge<T> *> getAdj() const;
-    bool isVisited() const;
-    bool isProcessing() const;
+    const std::vector<Edge<T, W> *> &getAdj() const;
     unsigned int getIndegree() const;
-    double getDist() const;
-    Edge<T> *getPath() const;
-    std::vector<Edge<T> *> getIncoming() const;
+    const std::vector<Edge<T, W> *> &getIncoming() const;
 
     void setInfo(T info);
-    void setVisited(bool visited);
-    void setProcesssing(bool processing);
     void setIndegree(unsigned int indegree);
-    void setDist(double dist);
-    void setPath(Edge<T> *path);
-    Edge<T> * addEdge(Vertex<T> *dest, double w);
+    Edge<T, W> * addEdge(Vertex<T, W> *dest, W w);
     bool removeEdge(T in);
     void removeOutgoingEdges();
-    bool operator<(Vertex<T> & vertex) const;
-    bool operator==(Vertex<T> & vertex) const;
+    bool operator==(Vertex<T, W> & vertex) const;
 
     size_t hash() const{
         return std::hash<T>()(info);
     }
 
-    int queueIndex = 0;
 protected:
     T info;                // info node
-    std::vector<Edge<T> *> adj;  // outgoing edges
+    std::vector<Edge<T, W> *> adj;  // outgoing edges
+    unsigned int indegree = 0; // number of incoming edges
 
-    // auxiliary fields
-    bool visited = false; // used by DFS, BFS, Prim ...
-    bool processing = false; // used by isDAG (in addition to the visited attribute)
-    unsigned int indegree; // used by topsort
-    double dist = 0;
-    Edge<T> *path = nullptr;
+    // the state of a search (visited, distance, path...) is kept by the search itself (see SolverState.h),
+    // so the graph is only read by the algorithms and can be shared by several of them at the same time
 
-    std::vector<Edge<T> *> incoming; // incoming edges
+    std::vector<Edge<T, W> *> incoming; // incoming edges
 
-    // required by MutablePriorityQueue and UFDS
-
-    void deleteEdge(Edge<T> *edge);
+    void deleteEdge(Edge<T, W> *edge);
 };
 
-template <class T>
+template <class T, class W = Weight>
 struct HashVertex {
-    size_t operator()(const Vertex<T> *v) const {
+    size_t operator()(const Vertex<T, W> *v) const {
         return v->hash();
     }
 };
 
-template <class T>
+template <class T, class W = Weight>
 struct EqualityVertex{
-    bool operator()(const Vertex<T>* n1, Vertex<T>* n2) const{
+    bool operator()(const Vertex<T, W>* n1, Vertex<T, W>* n2) const{
         return *n1 == *n2;
     }
 };
 
 /********************** Edge  ****************************/
 
-template <class T>
+template <class T, class W>
 class Edge {
 public:
-    Edge(Vertex<T> *orig, Vertex<T> *dest, double w);
+    Edge(Vertex<T, W> *orig, Vertex<T, W> *dest, W w);
 
-    Vertex<T> * getDest() const;
-    double getWeight() const;
-    bool isSelected() const;
-    Vertex<T> * getOrig() const;
-    Edge<T> *getReverse() const;
+    Vertex<T, W> * getDest() const;
+    W getWeight() const;
+    Vertex<T, W> * getOrig() const;
+    Edge<T, W> *getReverse() const;
     double getFlow() const;
 
-    void setSelected(bool selected);
-    void setReverse(Edge<T> *reverse);
+    void setReverse(Edge<T, W> *reverse);
     void setFlow(double flow);
-    void setWeight(double weight);
+    void setWeight(W weight);
 
 
 protected:
-    Vertex<T> * dest; // destination vertex
-    double weight; // edge weight, can also be used for capacity
-
-    // auxiliary fields
-    bool selected = false;
+    Vertex<T, W> * dest; // destination vertex
+    W weight; // edge weight, can also be used for capacity
 
     // used for bidirectional edges
-    Vertex<T> *orig;
-    Edge<T> *reverse = nullptr;
+    Vertex<T, W> *orig;
+    Edge<T, W> *reverse = nullptr;
 
     double flow; // for flow-related problems
 };
 
 /********************** Graph  ****************************/
 
-template <class T>
+template <class T, class W = Weight>
 class Graph {
 public:
+    Graph() = default;
+    Graph(const Graph &other) = delete;
+    Graph &operator=(const Graph &other) = delete;
+    Graph(Graph &&other) noexcept;
+    Graph &operator=(Graph &&other) noexcept;
     ~Graph();
     /*
     * Auxiliary function to find a vertex with a given the content.
     */
-    Vertex<T> *findVertex(const T &in) const;
+    Vertex<T, W> *findVertex(const T &in) const;
     /*
      *  Adds a vertex with a given content or info (in) to a graph (this).
      *  Returns true if successful, and false if a vertex with that content already exists.
@@ -135,26 +124,44 @@ public:
      * destination vertices and the edge weight (w).
      * Returns true if successful, and false if the source or destination vertex does not exist.
      */
-    bool addEdge(const T &sourc, const T &dest, double w);
+    bool addEdge(const T &sourc, const T &dest, W w);
     bool removeEdge(const T &source, const T &dest);
-    bool addBidirectionalEdge(const T &sourc, const T &dest, double w);
+    bool addBidirectionalEdge(const T &sourc, const T &dest, W w);
 
     int getNumVertex() const;
-    std::unordered_set<Vertex<T> *, HashVertex<T>, EqualityVertex<T>> getVertexSet() const;
+    const std::unordered_set<Vertex<T, W> *, HashVertex<T, W>, EqualityVertex<T, W>> &getVertexSet() const;
 
     std:: vector<T> dfs() const;
     std:: vector<T> dfs(const T & source) const;
-    void dfsVisit(Vertex<T> *v,  std::vector<T> & res) const;
+    void dfsVisit(Vertex<T, W> *v, std::unordered_set<Vertex<T, W> *> &visited, std::vector<T> & res) const;
     std::vector<T> bfs(const T & source) const;
 
     bool isDAG() const;
-    bool dfsIsDAG(Vertex<T> *v) const;
+    bool dfsIsDAG(Vertex<T, W> *v, std::unordered_set<Vertex<T, W> *> &visited, std::unordered_set<Vertex<T, W> *> &processing) const;
     std::vector<T> topsort() const;
+
+    /*
+     * All-pairs shortest paths (blocked Floyd-Warshall), stored in distMatrix and pathMatrix.
+     * Row i of the matrixes belongs to the i-th vertex of the order given (by default, the vertex set order).
+     */
+    void floydWarshall(unsigned int threads = 1);
+    void floydWarshall(const std::vector<Vertex<T, W> *> &order, unsigned int threads = 1);
+    int getMatrixSize() const;
+    int getMatrixIndex(Vertex<T, W> *v) const;
+    double getMatrixDist(int i, int j) const;
+    std::vector<T> getFloydWarshallPath(const T &orig, const T &dest) const;
 protected:
-    std::unordered_set<Vertex<T> *, HashVertex<T>, EqualityVertex<T>> vertexSet;    // vertex set
+    std::unordered_set<Vertex<T, W> *, HashVertex<T, W>, EqualityVertex<T, W>> vertexSet;    // vertex set
+
+    double ** distMatrix = nullptr;   // dist matrix for Floyd-Warshall (double for any weight type, so the sums never overflow)
+    int **pathMatrix = nullptr;   // path matrix for Floyd-Warshall (previous vertex in the path, -1 if none)
+    int matrixSize = 0;   // number of rows of the matrixes
+    std::vector<Vertex<T, W> *> matrixVertexes;   // vertex of each row of the matrixes
+    std::unordered_map<Vertex<T, W> *, int> matrixIndex;   // row of each vertex in the matrixes
 
-    double ** distMatrix = nullptr;   // dist matrix for Floyd-Warshall
-    int **pathMatrix = nullptr;   // path matrix for Floyd-Warshall
+    void deleteMatrixes();
+    void deleteVertexes();
+    void relaxTile(int iBlock, int jBlock, int kBlock);
 
     /*
      * Finds the index of the vertex with a given content.
@@ -168,8 +175,8 @@ void deleteMatrix(double **m, int n);
 
 /************************* Vertex  **************************/
 
-template <class T>
-Vertex<T>::Vertex(T in): info(in){}
+template <class T, class W>
+Vertex<T, W>::Vertex(T in): info(in){}
 
 /**
  * Auxiliary function to add an outgoing edge to a vertex (this),
@@ -180,9 +187,9 @@ Vertex<T>::Vertex(T in): info(in){}
  * @param w Weight of the edge
  * @return Pointer to the edges created
  */
-template <class T>
-Edge<T> * Vertex<T>::addEdge(Vertex<T> *d, double w) {
-    auto newEdge = new Edge<T>(this, d, w);
+template <class T, class W>
+Edge<T, W> * Vertex<T, W>::addEdge(Vertex<T, W> *d, W w) {
+    auto newEdge = new Edge<T, W>(this, d, w);
     adj.push_back(newEdge);
     d->incoming.push_back(newEdge);
     d->setIndegree(d->getIndegree() + 1);
@@ -197,13 +204,13 @@ Edge<T> * Vertex<T>::addEdge(Vertex<T> *d, double w) {
  * @param in Information of the destination edge
  * @return true if successful, and false if such edge does not exist.
  */
-template <class T>
-bool Vertex<T>::removeEdge(T in) {
+template <class T, class W>
+bool Vertex<T, W>::removeEdge(T in) {
     bool removedEdge = false;
     auto it = adj.begin();
     while (it != adj.end()) {
-        Edge<T> *edge = *it;
-        Vertex<T> *dest = edge->getDest();
+        Edge<T, W> *edge = *it;
+        Vertex<T, W> *dest = edge->getDest();
         if (dest->getInfo() == in) {
             it = adj.erase(it);
             deleteEdge(edge);
@@ -221,23 +228,18 @@ bool Vertex<T>::removeEdge(T in) {
  * Complexity: O(E^2) where E is the number of outgoing edges of the source vertex / incoming edges of the destination vertex.
  * @tparam T Type of the class
  */
-template <class T>
-void Vertex<T>::removeOutgoingEdges() {
+template <class T, class W>
+void Vertex<T, W>::removeOutgoingEdges() {
     auto it = adj.begin();
     while (it != adj.end()) {
-        Edge<T> *edge = *it;
+        Edge<T, W> *edge = *it;
         it = adj.erase(it);
         deleteEdge(edge);
     }
 }
 
-template <class T>
-bool Vertex<T>::operator<(Vertex<T> & vertex) const {
-    return this->dist < vertex.dist;
-}
-
-template <class T>
-bool Vertex<T>::operator==(Vertex<T> & vertex) const{
+template <class T, class W>
+bool Vertex<T, W>::operator==(Vertex<T, W> & vertex) const{
     return this->info == vertex.info;
 }
 
@@ -247,8 +249,8 @@ bool Vertex<T>::operator==(Vertex<T> & vertex) const{
  * @tparam T Type fo the class
  * @return Vertex's information
  */
-template <class T>
-T Vertex<T>::getInfo() const {
+template <class T, class W>
+T Vertex<T, W>::getInfo() const {
     return this->info;
 }
 
@@ -258,74 +260,30 @@ T Vertex<T>::getInfo() const {
  * @tparam T Type of the class
  * @return Vertex's outgoing edges list.
  */
-template <class T>
-std::vector<Edge<T> *> Vertex<T>::getAdj() const {
+template <class T, class W>
+const std::vector<Edge<T, W> *> &Vertex<T, W>::getAdj() const {
     return this->adj;
 }
 
-/**
- * Gets the vertex's visited state.
- * Complexity: O(1)
- * @tparam T Type of the class
- * @return Vertex's visited state
- */
-template <class T>
-bool Vertex<T>::isVisited() const {
-    return this->visited;
-}
-
-/**
- * Gets the vertex's processing state.
- * Complexity: O(1)
- * @tparam T Type of the class
- * @return Vertex's processing state
- */
-template <class T>
-bool Vertex<T>::isProcessing() const {
-    return this->processing;
-}
-
 /**
  * Gets the vertex's indegree.
  * Complexity: O(1)
  * @tparam T Type of the class
  * @return Vertex's indegree.
  */
-template <class T>
-unsigned int Vertex<T>::getIndegree() const {
+template <class T, class W>
+unsigned int Vertex<T, W>::getIndegree() const {
     return this->indegree;
 }
 
-/**
- * Gets the vertex's distance from a given vertex.
- * Complexity: O(1)
- * @tparam T Type of the class
- * @return Vertex's distance
- */
-template <class T>
-double Vertex<T>::getDist() const {
-    return this->dist;
-}
-
-/**
- * Gets the edge corresponding to a path.
- * Complexity: O(1)
- * @tparam T Type of the class
- * @return Edge corresponding to a path.
- */
-template <class T>
-Edge<T> *Vertex<T>::getPath() const {
-    return this->path;
-}
-
 /**
  * Gets the vertex's incoming edge list.
  *  * Complexity: O(1)
  * @tparam T Type of the class
  * @return Vertex's incoming edge list.
  */
-template <class T>
-std::vector<Edge<T> *> Vertex<T>::getIncoming() const {
+template <class T, class W>
+const std::vector<Edge<T, W> *> &Vertex<T, W>::getIncoming() const {
     return this->incoming;
 }
 
@@ -335,75 +293,31 @@ std::vector<Edge<T> *> Vertex<T>::getIncoming() const {
  * @tparam T Type of the class
  * @param in New information for the vertex.
  */
-template <class T>
-void Vertex<T>::setInfo(T in) {
+template <class T, class W>
+void Vertex<T, W>::setInfo(T in) {
     this->info = in;
 }
 
-/**
- * Sets the vertex's visited state.
- * Complexity: O(1)
- * @tparam T Type of the class
- * @param visited New visited state for the vertex.
- */
-template <class T>
-void Vertex<T>::setVisited(bool visited) {
-    this->visited = visited;
-}
-
-/**
- * Sets the vertex's processing state.
- * Complexity: O(1)
- * @tparam T Type of the class
- * @param processing New processing state for the vertex.
- */
-template <class T>
-void Vertex<T>::setProcesssing(bool processing) {
-    this->processing = processing;
-}
-
 /**
  * Sets the vertex's indegree.
  * Complexity: O(1)
  * @tparam T Type of the class
  * @param indegree New indegree for the vertex.
  */
-template <class T>
-void Vertex<T>::setIndegree(unsigned int indegree) {
+template <class T, class W>
+void Vertex<T, W>::setIndegree(unsigned int indegree) {
     this->indegree = indegree;
 }
 
-/**
- * Sets the vertex's distance to another vertex.
- * Complexity: O(1)
- * @tparam T Type fo the class.
- * @param dist New distance value.
- */
-template <class T>
-void Vertex<T>::setDist(double dist) {
-    this->dist = dist;
-}
-
-/**
- * Sets the vertex's path.
- * Complexity: O(1)
- * @tparam T Type fo the class.
- * @param path New path.
- */
-template <class T>
-void Vertex<T>::setPath(Edge<T> *path) {
-    this->path = path;
-}
-
 /**
  * Deletes a given edge from the incoming edges list.
  * Complexity: O(E) where E is the number of incoming edges.
  * @tparam T Type fo the class.
  * @param edge edge we want to delete.
  */
-template <class T>
-void Vertex<T>::deleteEdge(Edge<T> *edge) {
-    Vertex<T> *dest = edge->getDest();
+template <class T, class W>
+void Vertex<T, W>::deleteEdge(Edge<T, W> *edge) {
+    Vertex<T, W> *dest = edge->getDest();
     // Remove the corresponding edge from the incoming list
     auto it = dest->incoming.begin();
     while (it != dest->incoming.end()) {
@@ -419,8 +333,8 @@ void Vertex<T>::deleteEdge(Edge<T> *edge) {
 
 /********************** Edge  ****************************/
 
-template <class T>
-Edge<T>::Edge(Vertex<T> *orig, Vertex<T> *dest, double w): orig(orig), dest(dest), weight(w) {}
+template <class T, class W>
+Edge<T, W>::Edge(Vertex<T, W> *orig, Vertex<T, W> *dest, W w): orig(orig), dest(dest), weight(w) {}
 
 /**
  * Gets the edge's destination.
@@ -428,8 +342,8 @@ Edge<T>::Edge(Vertex<T> *orig, Vertex<T> *dest, double w): orig(orig), dest(dest
  * @tparam T Type of the class
  * @return Destination Vertex
  */
-template <class T>
-Vertex<T> * Edge<T>::getDest() const {
+template <class T, class W>
+Vertex<T, W> * Edge<T, W>::getDest() const {
     return this->dest;
 }
 
@@ -439,8 +353,8 @@ Vertex<T> * Edge<T>::getDest() const {
  * @tparam T Type of the class
  * @return Weight value
  */
-template <class T>
-double Edge<T>::getWeight() const {
+template <class T, class W>
+W Edge<T, W>::getWeight() const {
     return this->weight;
 }
 
@@ -449,8 +363,8 @@ double Edge<T>::getWeight() const {
  * @tparam T Type of the class
  * @return Origin vertex
  */
-template <class T>
-Vertex<T> * Edge<T>::getOrig() const {
+template <class T, class W>
+Vertex<T, W> * Edge<T, W>::getOrig() const {
     return this->orig;
 }
 
@@ -460,52 +374,30 @@ Vertex<T> * Edge<T>::getOrig() const {
  * @tparam T Type of the class
  * @return Reverse edge
  */
-template <class T>
-Edge<T> *Edge<T>::getReverse() const {
+template <class T, class W>
+Edge<T, W> *Edge<T, W>::getReverse() const {
     return this->reverse;
 }
 
-/**
- * Gets the selected status.
- * Complexity: O(1)
- * @tparam T Type of the class
- * @return Returns the selected status
- */
-template <class T>
-bool Edge<T>::isSelected() const {
-    return this->selected;
-}
-
 /**
  * Gets the edge flow.
  * Complexity: O(1)
  * @tparam T type of th class
  * @return Edge flow
  */
-template <class T>
-double Edge<T>::getFlow() const {
+template <class T, class W>
+double Edge<T, W>::getFlow() const {
     return flow;
 }
 
-/**
- * Sets the selected status.
- * Complexity: O(1)
- * @tparam T Type of the class
- * @param selected New selected status
- */
-template <class T>
-void Edge<T>::setSelected(bool selected) {
-    this->selected = selected;
-}
-
 /**
  * Sets the reverse edge.
  * Complexity: O(1)
  * @tparam T Type of the class
  * @param reverse New reverse edge
  */
-template <class T>
-void Edge<T>::setReverse(Edge<T> *reverse) {
+template <class T, class W>
+void Edge<T, W>::setReverse(Edge<T, W> *reverse) {
     this->reverse = reverse;
 }
 
@@ -515,8 +407,8 @@ void Edge<T>::setReverse(Edge<T> *reverse) {
  * @tparam T Type of the class
  * @param flow New flow value
  */
-template <class T>
-void Edge<T>::setFlow(double flow) {
+template <class T, class W>
+void Edge<T, W>::setFlow(double flow) {
     this->flow = flow;
 }
 
@@ -526,8 +418,8 @@ void Edge<T>::setFlow(double flow) {
  * @tparam T Type of the class
  * @param weight New weight value
  */
-template <class T>
-void Edge<T>::setWeight(double weight) {
+template <class T, class W>
+void Edge<T, W>::setWeight(W weight) {
     this->weight = weight;
 }
 
@@ -539,8 +431,8 @@ void Edge<T>::setWeight(double weight) {
  * @tparam T Type of the class
  * @return  Number of Vertexes
  */
-template <class T>
-int Graph<T>::getNumVertex() const {
+template <class T, class W>
+int Graph<T, W>::getNumVertex() const {
     return vertexSet.size();
 }
 
@@ -550,8 +442,8 @@ int Graph<T>::getNumVertex() const {
  * @tparam T Type of the class
  * @return  vector with the vertexes
  */
-template <class T>
-std::unordered_set<Vertex<T> *, HashVertex<T>, EqualityVertex<T>> Graph<T>::getVertexSet() const {
+template <class T, class W>
+const std::unordered_set<Vertex<T, W> *, HashVertex<T, W>, EqualityVertex<T, W>> &Graph<T, W>::getVertexSet() const {
     return vertexSet;
 }
 
@@ -561,12 +453,12 @@ std::unordered_set<Vertex<T> *, HashVertex<T>, EqualityVertex<T>> Graph<T>::getV
  * @param in Info of the vertex to find.
  * @return Pointer to the vertex found or nullptr if the vertex doesn't exists.
  */
-template <class T>
-Vertex<T> * Graph<T>::findVertex(const T &in) const {
-    Vertex<T> v(in);
-    Vertex<T>* vPointer = &v;
+template <class T, class W>
+Vertex<T, W> * Graph<T, W>::findVertex(const T &in) const {
+    Vertex<T, W> v(in);
+    Vertex<T, W>* vPointer = &v;
     auto it = vertexSet.find(vPointer);
-    if(it == nullptr)
+    if(it == vertexSet.end())
         return nullptr;
     return *it;
 }
@@ -577,8 +469,8 @@ Vertex<T> * Graph<T>::findVertex(const T &in) const {
  * @param in Info of the vertex to find.
  * @return Index of the vertex or -1 if it doesn't exists
  */
-template <class T>
-int Graph<T>::findVertexIdx(const T &in) const {
+template <class T, class W>
+int Graph<T, W>::findVertexIdx(const T &in) const {
     for (unsigned i = 0; i < vertexSet.size(); i++)
         if (vertexSet[i]->getInfo() == in)
             return i;
@@ -592,11 +484,11 @@ int Graph<T>::findVertexIdx(const T &in) const {
  *  @param type Type of hte new vertex.
  *  @return true if successful, and false if a vertex with that content already exists.
  */
-template <class T>
-bool Graph<T>::addVertex(const T &in) {
+template <class T, class W>
+bool Graph<T, W>::addVertex(const T &in) {
     if (findVertex(in) != nullptr)
         return false;
-    vertexSet.insert(new Vertex<T>(in));
+    vertexSet.insert(new Vertex<T, W>(in));
     return true;
 }
 
@@ -607,8 +499,8 @@ bool Graph<T>::addVertex(const T &in) {
  *  @param in Info of the vertex to remove.
  *  @return true if successful, and false if such vertex does not exist.
  */
-template <class T>
-bool Graph<T>::removeVertex(const T &in) {
+template <class T, class W>
+bool Graph<T, W>::removeVertex(const T &in) {
     auto v = findVertex(in);
     if(v == nullptr){
         return false;
@@ -631,8 +523,8 @@ bool Graph<T>::removeVertex(const T &in) {
  * @param w weight of the new edge.
  * @return true if successful, and false if the source or destination vertex does not exist.
  */
-template <class T>
-bool Graph<T>::addEdge(const T &sourc, const T &dest, double w) {
+template <class T, class W>
+bool Graph<T, W>::addEdge(const T &sourc, const T &dest, W w) {
     auto v1 = findVertex(sourc);
     auto v2 = findVertex(dest);
     if (v1 == nullptr || v2 == nullptr)
@@ -649,9 +541,9 @@ bool Graph<T>::addEdge(const T &sourc, const T &dest, double w) {
  * @param sourc info of the vertex that is the source of the edge
  * @return true if successful, and false if such edge does not exist.
  */
-template <class T>
-bool Graph<T>::removeEdge(const T &sourc, const T &dest) {
-    Vertex<T> * srcVertex = findVertex(sourc);
+template <class T, class W>
+bool Graph<T, W>::removeEdge(const T &sourc, const T &dest) {
+    Vertex<T, W> * srcVertex = findVertex(sourc);
     if (srcVertex == nullptr) {
         return false;
     }
@@ -667,8 +559,8 @@ bool Graph<T>::removeEdge(const T &sourc, const T &dest) {
  * @param w Weight of the edge
  * @return False if one of the vertexes (source or destination) doesn't exists. True otherwise
  */
-template <class T>
-bool Graph<T>::addBidirectionalEdge(const T &sourc, const T &dest, double w) {
+template <class T, class W>
+bool Graph<T, W>::addBidirectionalEdge(const T &sourc, const T &dest, W w) {
     auto v1 = findVertex(sourc);
     auto v2 = findVertex(dest);
     if (v1 == nullptr || v2 == nullptr)
@@ -687,14 +579,13 @@ bool Graph<T>::addBidirectionalEdge(const T &sourc, const T &dest, double w) {
  * Complexity: O(V + E)
  * @return a vector with the contents of the vertices by dfs order.
  */
-template <class T>
-std::vector<T> Graph<T>::dfs() const {
+template <class T, class W>
+std::vector<T> Graph<T, W>::dfs() const {
     std::vector<T> res;
+    std::unordered_set<Vertex<T, W> *> visited;
     for (auto v : vertexSet)
-        v->setVisited(false);
-    for (auto v : vertexSet)
-        if (!v->isVisited())
-            dfsVisit(v, res);
+        if (visited.count(v) == 0)
+            dfsVisit(v, visited, res);
     return res;
 }
 
@@ -703,20 +594,18 @@ std::vector<T> Graph<T>::dfs() const {
  * Complexity: O(V + E)
  * @return a vector with the contents of the vertices by dfs order.
  */
-template <class T>
-std::vector<T> Graph<T>::dfs(const T & source) const {
-    std::vector<int> res;
+template <class T, class W>
+std::vector<T> Graph<T, W>::dfs(const T & source) const {
+    std::vector<T> res;
     // Get the source vertex
     auto s = findVertex(source);
     if (s == nullptr) {
         return res;
     }
-    // Set that no vertex has been visited yet
-    for (auto v : vertexSet) {
-        v->setVisited(false);
-    }
+    // No vertex has been visited yet
+    std::unordered_set<Vertex<T, W> *> visited;
     // Perform the actual DFS using recursion
-    dfsVisit(s, res);
+    dfsVisit(s, visited, res);
 
     return res;
 }
@@ -726,16 +615,17 @@ std::vector<T> Graph<T>::dfs(const T & source) const {
  * Updates a parameter with the list of visited node contents.
  * Complexity: O(V + E)
  * @param v vertex we are now visiting
+ * @param visited vertexes already visited by this search
  * @param res vector with the vertex visited in DFS order
  */
-template <class T>
-void Graph<T>::dfsVisit(Vertex<T> *v, std::vector<T> & res) const {
-    v->setVisited(true);
+template <class T, class W>
+void Graph<T, W>::dfsVisit(Vertex<T, W> *v, std::unordered_set<Vertex<T, W> *> &visited, std::vector<T> & res) const {
+    visited.insert(v);
     res.push_back(v->getInfo());
     for (auto & e : v->getAdj()) {
         auto w = e->getDest();
-        if (!w->isVisited()) {
-            dfsVisit(w, res);
+        if (visited.count(w) == 0) {
+            dfsVisit(w, visited, res);
         }
     }
 }
@@ -748,33 +638,28 @@ void Graph<T>::dfsVisit(Vertex<T> *v, std::vector<T> & res) const {
  * @param source Info of the source vertex
  * @return a vector with the contents of the vertices by bfs order.
  */
-template <class T>
-std::vector<T> Graph<T>::bfs(const T & source) const {
-    std::vector<int> res;
+template <class T, class W>
+std::vector<T> Graph<T, W>::bfs(const T & source) const {
+    std::vector<T> res;
     // Get the source vertex
     auto s = findVertex(source);
     if (s == nullptr) {
         return res;
     }
 
-    // Set that no vertex has been visited yet
-    for (auto v : vertexSet) {
-        v->setVisited(false);
-    }
-
     // Perform the actual BFS using a queue
-    std::queue<Vertex<T> *> q;
+    std::unordered_set<Vertex<T, W> *> visited;
+    std::queue<Vertex<T, W> *> q;
     q.push(s);
-    s->setVisited(true);
+    visited.insert(s);
     while (!q.empty()) {
         auto v = q.front();
         q.pop();
         res.push_back(v->getInfo());
         for (auto & e : v->getAdj()) {
             auto w = e->getDest();
-            if ( ! w->isVisited()) {
+            if (visited.insert(w).second) {
                 q.push(w);
-                w->setVisited(true);
             }
         }
     }
@@ -791,15 +676,13 @@ std::vector<T> Graph<T>::bfs(const T & source) const {
  * @return true if the graph is acyclic, and false otherwise.
  */
 
-template <class T>
-bool Graph<T>::isDAG() const {
+template <class T, class W>
+bool Graph<T, W>::isDAG() const {
+    std::unordered_set<Vertex<T, W> *> visited;
+    std::unordered_set<Vertex<T, W> *> processing;
     for (auto v : vertexSet) {
-        v->setVisited(false);
-        v->setProcesssing(false);
-    }
-    for (auto v : vertexSet) {
-        if (! v->isVisited()) {
-            if ( ! dfsIsDAG(v) ) return false;
+        if (visited.count(v) == 0) {
+            if ( ! dfsIsDAG(v, visited, processing) ) return false;
         }
     }
     return true;
@@ -809,20 +692,22 @@ bool Graph<T>::isDAG() const {
  * Auxiliary function that visits a vertex (v) and its adjacent, recursively.
  * Complexity: O(V + E)
  * @param v vertex we are visiting
+ * @param visited vertexes already visited by this search
+ * @param processing vertexes in the stack of recursive calls
  * @return false (not acyclic) if an edge to a vertex in the stack is found.
  */
-template <class T>
-bool Graph<T>::dfsIsDAG(Vertex<T> *v) const {
-    v->setVisited(true);
-    v->setProcesssing(true);
+template <class T, class W>
+bool Graph<T, W>::dfsIsDAG(Vertex<T, W> *v, std::unordered_set<Vertex<T, W> *> &visited, std::unordered_set<Vertex<T, W> *> &processing) const {
+    visited.insert(v);
+    processing.insert(v);
     for (auto e : v->getAdj()) {
         auto w = e->getDest();
-        if (w->isProcessing()) return false;
-        if (! w->isVisited()) {
-            if (! dfsIsDAG(w)) return false;
+        if (processing.count(w) != 0) return false;
+        if (visited.count(w) == 0) {
+            if (! dfsIsDAG(w, visited, processing)) return false;
         }
     }
-    v->setProcesssing(false);
+    processing.erase(v);
     return true;
 }
 
@@ -830,42 +715,39 @@ bool Graph<T>::dfsIsDAG(Vertex<T> *v) const {
 //=============================================================================
 // Exercise 1: Topological Sorting
 //=============================================================================
-// TODO
 /**
  * Performs a topological sorting of the vertices of a graph (this).
  * Complexity: O(V + E)
  * @return a vector with the contents of the vertices by topological order. If the graph has cycles, returns an empty vector.
  */
 
-template<class T>
-std::vector<T> Graph<T>::topsort() const {
-    std::vector<int> res;
+template <class T, class W>
+std::vector<T> Graph<T, W>::topsort() const {
+    std::vector<T> res;
 
+    // indegrees still to satisfy, local to this call
+    std::unordered_map<Vertex<T, W> *, unsigned int> indegree;
     for (auto v : vertexSet) {
-        v->setIndegree(0);
-    }
-    for (auto v : vertexSet) {
+        indegree[v];
         for (auto e : v->getAdj()) {
-            unsigned int indegree = e->getDest()->getIndegree();
-            e->getDest()->setIndegree(indegree + 1);
+            indegree[e->getDest()]++;
         }
     }
 
-    std::queue<Vertex<T> *> q;
+    std::queue<Vertex<T, W> *> q;
     for (auto v : vertexSet) {
-        if (v->getIndegree() == 0) {
+        if (indegree[v] == 0) {
             q.push(v);
         }
     }
 
     while( !q.empty() ) {
-        Vertex<T> * v = q.front();
+        Vertex<T, W> * v = q.front();
         q.pop();
         res.push_back(v->getInfo());
         for(auto e : v->getAdj()) {
             auto w = e->getDest();
-            w->setIndegree(w->getIndegree() - 1);
-            if(w->getIndegree() == 0) {
+            if(--indegree[w] == 0) {
                 q.push(w);
             }
         }
@@ -898,10 +780,250 @@ inline void deleteMatrix(double **m, int n) {
     }
 }
 
-template <class T>
-Graph<T>::~Graph() {
-    deleteMatrix(distMatrix, vertexSet.size());
-    deleteMatrix(pathMatrix, vertexSet.size());
+/************************* Floyd-Warshall  **************************/
+
+const int FLOYD_WARSHALL_BLOCK = 64;   // side of the tiles (a 64x64 tile of doubles fits in L1/L2)
+
+/**
+ * Moves a graph: the vertexes, edges and Floyd-Warshall matrixes change owner and the other graph is left empty.
+ * A graph can't be copied, so each vertex belongs to exactly one graph.
+ * Complexity: O(1)
+ * @tparam T Type of class
+ * @param other Graph to move
+ */
+template <class T, class W>
+Graph<T, W>::Graph(Graph &&other) noexcept {
+    *this = std::move(other);
+}
+
+/**
+ * Moves a graph (see the move constructor), freeing the current one.
+ * Complexity: O(V + E) to free the current graph
+ * @tparam T Type of class
+ * @param other Graph to move
+ * @return This graph
+ */
+template <class T, class W>
+Graph<T, W> &Graph<T, W>::operator=(Graph &&other) noexcept {
+    if (this != &other) {
+        deleteMatrixes();
+        deleteVertexes();
+        vertexSet = std::move(other.vertexSet);
+        other.vertexSet.clear();
+        distMatrix = other.distMatrix;
+        pathMatrix = other.pathMatrix;
+        matrixSize = other.matrixSize;
+        matrixVertexes = std::move(other.matrixVertexes);
+        matrixIndex = std::move(other.matrixIndex);
+        other.distMatrix = nullptr;
+        other.pathMatrix = nullptr;
+        other.deleteMatrixes();
+    }
+    return *this;
+}
+
+template <class T, class W>
+Graph<T, W>::~Graph() {
+    deleteMatrixes();
+    deleteVertexes();
+}
+
+/**
+ * Frees the vertexes and their edges.
+ * Complexity: O(V + E)
+ * @tparam T Type of class
+ */
+template <class T, class W>
+void Graph<T, W>::deleteVertexes() {
+    for (auto v : vertexSet) {
+        for (auto e : v->getAdj()) delete e;
+        delete v;
+    }
+    vertexSet.clear();
+}
+
+/**
+ * Frees the Floyd-Warshall matrixes.
+ * Complexity: O(n) where n is the size of the matrixes.
+ * @tparam T Type of class
+ */
+template <class T, class W>
+void Graph<T, W>::deleteMatrixes() {
+    deleteMatrix(distMatrix, matrixSize);
+    deleteMatrix(pathMatrix, matrixSize);
+    distMatrix = nullptr;
+    pathMatrix = nullptr;
+    matrixSize = 0;
+    matrixVertexes.clear();
+    matrixIndex.clear();
+}
+
+/**
+ * Relaxes the tile (iBlock, jBlock) through the vertexes of kBlock: d[i][j] = min(d[i][j], d[i][k] + d[k][j]).
+ * The inner loop has no branches (selects), so it can be vectorized.
+ * Complexity: O(B^3) where B is the side of the tiles.
+ * @tparam T Type of class
+ * @param iBlock Block of rows
+ * @param jBlock Block of columns
+ * @param kBlock Block of intermediate vertexes
+ */
+template <class T, class W>
+void Graph<T, W>::relaxTile(int iBlock, int jBlock, int kBlock) {
+    const int B = FLOYD_WARSHALL_BLOCK;
+    int iEnd = std::min(matrixSize, (iBlock + 1) * B);
+    int jStart = jBlock * B, jEnd = std::min(matrixSize, (jBlock + 1) * B);
+    int kEnd = std::min(matrixSize, (kBlock + 1) * B);
+
+    for (int k = kBlock * B; k < kEnd; k++) {
+        const double *dk = distMatrix[k];
+        const int *pk = pathMatrix[k];
+        for (int i = iBlock * B; i < iEnd; i++) {
+            double dik = distMatrix[i][k];
+            if (dik == std::numeric_limits<double>::infinity()) continue;
+            double *di = distMatrix[i];
+            int *pi = pathMatrix[i];
+            for (int j = jStart; j < jEnd; j++) {
+                double candidate = dik + dk[j];
+                bool better = candidate < di[j];
+                di[j] = better ? candidate : di[j];
+                pi[j] = better ? pk[j] : pi[j];
+            }
+        }
+    }
+}
+
+/**
+ * Calculates the shortest paths between every pair of vertexes (rows in the vertex set order).
+ * Complexity: O(V^3 / T) where T is the number of threads.
+ * @tparam T Type of class
+ * @param threads Number of threads
+ */
+template <class T, class W>
+void Graph<T, W>::floydWarshall(unsigned int threads) {
+    std::vector<Vertex<T, W> *> order(vertexSet.begin(), vertexSet.end());
+    floydWarshall(order, threads);
+}
+
+/**
+ * Calculates the shortest paths between every pair of the given vertexes, using only the edges between them
+ * (the induced subgraph). Blocked version: for each block k of intermediate vertexes, the diagonal tile is
+ * relaxed first, then the tiles in its row and column (in parallel) and then all the others (in parallel).
+ * Complexity: O(n^3 / T) where n is the number of vertexes given and T is the number of threads.
+ * @tparam T Type of class
+ * @param order Vertexes, in the order of the rows of the matrixes
+ * @param threads Number of threads
+ */
+template <class T, class W>
+void Graph<T, W>::floydWarshall(const std::vector<Vertex<T, W> *> &order, unsigned int threads) {
+    deleteMatrixes();
+    int n = (int) order.size();
+    matrixSize = n;
+    matrixVertexes = order;
+    for (int i = 0; i < n; i++) matrixIndex[order[i]] = i;
+
+    distMatrix = new double *[n];
+    pathMatrix = new int *[n];
+    for (int i = 0; i < n; i++) {
+        distMatrix[i] = new double[n];
+        pathMatrix[i] = new int[n];
+        std::fill(distMatrix[i], distMatrix[i] + n, std::numeric_limits<double>::infinity());
+        std::fill(pathMatrix[i], pathMatrix[i] + n, -1);
+        distMatrix[i][i] = 0;
+        pathMatrix[i][i] = i;
+        for (Edge<T, W> *e : order[i]->getAdj()) {
+            auto it = matrixIndex.find(e->getDest());
+            if (it != matrixIndex.end() && it->second != i && e->getWeight() < distMatrix[i][it->second]) {
+                distMatrix[i][it->second] = e->getWeight();
+                pathMatrix[i][it->second] = i;
+            }
+        }
+    }
+
+    int blocks = (n + FLOYD_WARSHALL_BLOCK - 1) / FLOYD_WARSHALL_BLOCK;
+    std::unique_ptr<ThreadPool> pool(threads > 1 && blocks > 1 ? new ThreadPool(threads) : nullptr);
+    auto run = [&pool](std::function<void()> job) {
+        if (pool == nullptr) job();
+        else pool->submit(std::move(job));
+    };
+
+    for (int kb = 0; kb < blocks; kb++) {
+        relaxTile(kb, kb, kb);
+
+        for (int b = 0; b < blocks; b++) {
+            if (b == kb) continue;
+            run([this, b, kb] { relaxTile(kb, b, kb); });
+            run([this, b, kb] { relaxTile(b, kb, kb); });
+        }
+        if (pool != nullptr) pool->wait();
+
+        for (int ib = 0; ib < blocks; ib++) {
+            if (ib == kb) continue;
+            run([this, ib, kb, blocks] {
+                for (int jb = 0; jb < blocks; jb++) {
+                    if (jb != kb) relaxTile(ib, jb, kb);
+                }
+            });
+        }
+        if (pool != nullptr) pool->wait();
+    }
+}
+
+/**
+ * Gets the number of rows of the Floyd-Warshall matrixes.
+ * Complexity: O(1)
+ * @tparam T Type of class
+ * @return Size of the matrixes (0 if not calculated)
+ */
+template <class T, class W>
+int Graph<T, W>::getMatrixSize() const {
+    return matrixSize;
+}
+
+/**
+ * Gets the row of a vertex in the Floyd-Warshall matrixes.
+ * Complexity: O(1)
+ * @tparam T Type of class
+ * @param v Vertex
+ * @return Row of the vertex, -1 if it isn't in the matrixes
+ */
+template <class T, class W>
+int Graph<T, W>::getMatrixIndex(Vertex<T, W> *v) const {
+    auto it = matrixIndex.find(v);
+    return it == matrixIndex.end() ? -1 : it->second;
+}
+
+/**
+ * Gets a shortest path distance from the Floyd-Warshall matrixes.
+ * Complexity: O(1)
+ * @tparam T Type of class
+ * @param i Row of the origin
+ * @param j Row of the destination
+ * @return Distance, infinity if there is no path
+ */
+template <class T, class W>
+double Graph<T, W>::getMatrixDist(int i, int j) const {
+    return distMatrix[i][j];
+}
+
+/**
+ * Rebuilds a shortest path from the Floyd-Warshall matrixes.
+ * Complexity: O(p) where p is the number of vertexes in the path.
+ * @tparam T Type of class
+ * @param orig Info of the origin
+ * @param dest Info of the destination
+ * @return Contents of the vertexes of the path (orig and dest included), empty if there is none
+ */
+template <class T, class W>
+std::vector<T> Graph<T, W>::getFloydWarshallPath(const T &orig, const T &dest) const {
+    std::vector<T> res;
+    int i = getMatrixIndex(findVertex(orig));
+    int j = getMatrixIndex(findVertex(dest));
+    if (i == -1 || j == -1 || pathMatrix[i][j] == -1) return res;
+
+    for (; j != i; j = pathMatrix[i][j]) res.push_back(matrixVertexes[j]->getInfo());
+    res.push_back(matrixVertexes[i]->getInfo());
+    std::reverse(res.begin(), res.end());
+    return res;
 }
 
 #endif /* DA_TP_CLASSES_GRAPH */
\ No newline at end of file
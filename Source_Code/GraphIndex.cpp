@@ -0,0 +1,235 @@
+//
+// Created by lucas on 19/10/2026.
+//
+
+#include "GraphIndex.h"
+#include <algorithm>
+
+using namespace std;
+
+/**
+ * @file GraphIndex.cpp
+ * @brief Implementation of class GraphIndex.
+ */
+
+/**
+ * Builds the index of a graph. Vertexes are numbered by increasing id, then renumbered by the ordering.
+ * Complexity: O(V log V + E log E) where V is the number of vertexes and E is the number of edges
+ * @param graph Graph to index
+ * @param ordering How the vertexes are numbered
+ */
+GraphIndex::GraphIndex(const Graph<NodeInfo> &graph, VertexOrdering ordering) {
+    const auto &vertexSet = graph.getVertexSet();
+    vector<Vertex<NodeInfo> *> order(vertexSet.begin(), vertexSet.end());
+    sort(order.begin(), order.end(), [](Vertex<NodeInfo> *a, Vertex<NodeInfo> *b){
+        return a->getInfo().getId() < b->getInfo().getId();
+    });
+    if(ordering != VertexOrdering::ID) order = renumber(order, ordering);
+
+    int n = (int) order.size();
+    unordered_map<Vertex<NodeInfo> *, int> vertexToIndex;
+    vertexToIndex.reserve(n);
+    ids.reserve(n);
+    infos.reserve(n);
+    vertexes.reserve(n);
+    idToIndex.reserve(n);
+    for(int i = 0; i < n; i++){
+        vertexToIndex[order[i]] = i;
+        ids.push_back(order[i]->getInfo().getId());
+        infos.push_back(order[i]->getInfo());
+        vertexes.push_back(order[i]);
+        idToIndex[ids.back()] = i;
+    }
+
+    offsets.assign(n + 1, 0);
+    for(int i = 0; i < n; i++){
+        offsets[i + 1] = offsets[i] + (int) order[i]->getAdj().size();
+    }
+
+    neighbours.resize(offsets[n]);
+    for(int i = 0; i < n; i++){
+        int k = offsets[i];
+        for(Edge<NodeInfo> *e : order[i]->getAdj()){
+            neighbours[k++] = {vertexToIndex[e->getDest()], e->getWeight()};
+        }
+        sort(neighbours.begin() + offsets[i], neighbours.begin() + offsets[i + 1], [](const Neighbour &a, const Neighbour &b){
+            return a.weight < b.weight || (a.weight == b.weight && a.to < b.to);
+        });
+    }
+
+    byTarget = neighbours;
+    for(int i = 0; i < n; i++){
+        //stable, so with parallel edges the lightest one comes first
+        stable_sort(byTarget.begin() + offsets[i], byTarget.begin() + offsets[i + 1], [](const Neighbour &a, const Neighbour &b){
+            return a.to < b.to;
+        });
+    }
+}
+
+/**
+ * Renumbers the vertexes with a locality ordering.
+ * Complexity: O(V log V + E log E)
+ * @param order Vertexes by increasing id
+ * @param ordering Ordering to apply
+ * @return Vertexes in the new order
+ */
+vector<Vertex<NodeInfo> *> GraphIndex::renumber(const vector<Vertex<NodeInfo> *> &order, VertexOrdering ordering) {
+    vector<NodeInfo> nodes;
+    nodes.reserve(order.size());
+    for(Vertex<NodeInfo> *v : order) nodes.push_back(v->getInfo());
+    if(ordering == VertexOrdering::AUTO) ordering = hasCoordinates(nodes) ? VertexOrdering::HILBERT : VertexOrdering::RCM;
+
+    vector<int> permutation;
+    if(ordering == VertexOrdering::HILBERT){
+        permutation = hilbertOrder(nodes);
+    }
+    else{
+        unordered_map<Vertex<NodeInfo> *, int> position;
+        for(int i = 0; i < (int) order.size(); i++) position[order[i]] = i;
+        vector<int> offsets {0}, targets;
+        for(Vertex<NodeInfo> *v : order){
+            for(Edge<NodeInfo> *e : v->getAdj()) targets.push_back(position[e->getDest()]);
+            offsets.push_back((int) targets.size());
+        }
+        permutation = reverseCuthillMcKee(offsets, targets);
+    }
+
+    vector<Vertex<NodeInfo> *> renumbered;
+    renumbered.reserve(order.size());
+    for(int i : permutation) renumbered.push_back(order[i]);
+    return renumbered;
+}
+
+/**
+ * Gets the number of vertexes.
+ * Complexity: O(1)
+ * @return Number of vertexes
+ */
+int GraphIndex::size() const {
+    return (int) ids.size();
+}
+
+/**
+ * Gets the index of a vertex id.
+ * Complexity: O(1)
+ * @param id Id of the vertex
+ * @return Index of the vertex or -1 if it doesn't exist
+ */
+int GraphIndex::indexOf(int id) const {
+    auto it = idToIndex.find(id);
+    return it == idToIndex.end() ? -1 : it->second;
+}
+
+/**
+ * Gets the id of the vertex with a given index.
+ * Complexity: O(1)
+ * @param index Index of the vertex
+ * @return Id of the vertex
+ */
+int GraphIndex::idOf(int index) const {
+    return ids[index];
+}
+
+/**
+ * Gets the info of the vertex with a given index.
+ * Complexity: O(1)
+ * @param index Index of the vertex
+ * @return Info of the vertex
+ */
+const NodeInfo &GraphIndex::info(int index) const {
+    return infos[index];
+}
+
+/**
+ * Gets the graph vertex with a given index.
+ * Complexity: O(1)
+ * @param index Index of the vertex
+ * @return Vertex of the original graph
+ */
+Vertex<NodeInfo> *GraphIndex::vertex(int index) const {
+    return vertexes[index];
+}
+
+/**
+ * Gets the number of outgoing edges of a vertex.
+ * Complexity: O(1)
+ * @param v Index of the vertex
+ * @return Degree of the vertex
+ */
+int GraphIndex::degree(int v) const {
+    return offsets[v + 1] - offsets[v];
+}
+
+/**
+ * Gets the first outgoing edge of a vertex (the lightest one).
+ * Complexity: O(1)
+ * @param v Index of the vertex
+ * @return Pointer to the first edge
+ */
+const Neighbour *GraphIndex::begin(int v) const {
+    return neighbours.data() + offsets[v];
+}
+
+/**
+ * Gets the end of the outgoing edges of a vertex.
+ * Complexity: O(1)
+ * @param v Index of the vertex
+ * @return Pointer after the last edge
+ */
+const Neighbour *GraphIndex::end(int v) const {
+    return neighbours.data() + offsets[v + 1];
+}
+
+/**
+ * Gets the position of an edge among all the edges, so the solvers can keep per-edge state in dense arrays.
+ * Complexity: O(1)
+ * @param e Pointer to an edge (from begin / end)
+ * @return Id of the edge, in [0, numEdges())
+ */
+int GraphIndex::edgeId(const Neighbour *e) const {
+    return (int) (e - neighbours.data());
+}
+
+/**
+ * Gets the weight of the edge between two vertexes.
+ * Complexity: O(log d) where d is the degree of u
+ * @param u Index of the origin
+ * @param v Index of the destination
+ * @return Weight of the edge or infinity() if there is none
+ */
+double GraphIndex::weight(int u, int v) const {
+    auto first = byTarget.begin() + offsets[u];
+    auto last = byTarget.begin() + offsets[u + 1];
+    auto it = lower_bound(first, last, v, [](const Neighbour &a, int target){ return a.to < target; });
+    if(it == last || it->to != v) return infinity();
+    return it->weight;
+}
+
+/**
+ * Checks if there is an edge between two vertexes.
+ * Complexity: O(log d) where d is the degree of u
+ * @param u Index of the origin
+ * @param v Index of the destination
+ * @return true if the edge exists
+ */
+bool GraphIndex::hasEdge(int u, int v) const {
+    return weight(u, v) != infinity();
+}
+
+/**
+ * Gets the number of (directed) edges.
+ * Complexity: O(1)
+ * @return Number of edges
+ */
+size_t GraphIndex::numEdges() const {
+    return neighbours.size();
+}
+
+/**
+ * Weight used for missing edges and unreachable vertexes.
+ * Complexity: O(1)
+ * @return Infinity
+ */
+double GraphIndex::infinity() {
+    return numeric_limits<double>::infinity();
+}
@@ -0,0 +1,65 @@
+//
+// Created by lucas on 19/10/2026.
+//
+
+#ifndef PROJECT2_GRAPHINDEX_H
+#define PROJECT2_GRAPHINDEX_H
+
+#include <limits>
+#include <unordered_map>
+#include <vector>
+#include "Graph.h"
+#include "NodeInfo.h"
+#include "Ordering.h"
+
+/**
+ * @file GraphIndex.h
+ * @brief Definition of class GraphIndex.
+ *
+ * \class GraphIndex
+ * Read-only, array based copy of a Graph<NodeInfo>: the vertexes are numbered 0..n-1 (by id or by one of the
+ * locality orderings of Ordering.h) and the outgoing edges of each vertex are stored contiguously (compressed
+ * sparse rows), sorted by weight.
+ * It is built once per loaded graph and shared by the algorithms that need dense indexes, so it is never
+ * modified after construction and can be read by several threads at the same time.
+ */
+
+struct Neighbour {
+    int to;
+    Weight weight;     // same type as the graph, so integer weight builds keep half-size rows
+};
+
+class GraphIndex {
+public:
+    explicit GraphIndex(const Graph<NodeInfo> &graph, VertexOrdering ordering = VertexOrdering::ID);
+
+    int size() const;
+    int indexOf(int id) const;
+    int idOf(int index) const;
+    const NodeInfo &info(int index) const;
+    Vertex<NodeInfo> *vertex(int index) const;
+
+    int degree(int v) const;
+    const Neighbour *begin(int v) const;
+    const Neighbour *end(int v) const;
+    int edgeId(const Neighbour *e) const;
+    double weight(int u, int v) const;
+    bool hasEdge(int u, int v) const;
+    size_t numEdges() const;
+
+    static double infinity();
+
+private:
+    static std::vector<Vertex<NodeInfo> *> renumber(const std::vector<Vertex<NodeInfo> *> &order, VertexOrdering ordering);
+
+    std::vector<int> ids;
+    std::unordered_map<int, int> idToIndex;
+    std::vector<NodeInfo> infos;
+    std::vector<Vertex<NodeInfo> *> vertexes;
+
+    std::vector<int> offsets;               // edges of v are in [offsets[v], offsets[v + 1])
+    std::vector<Neighbour> neighbours;      // sorted by weight
+    std::vector<Neighbour> byTarget;        // same edges sorted by destination (for weight lookups)
+};
+
+#endif //PROJECT2_GRAPHINDEX_H
@@ -0,0 +1,231 @@
+//
+// Created by lucas on 19/10/2026.
+//
+
+#ifndef PROJECT2_HELDKARP_H
+#define PROJECT2_HELDKARP_H
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <tuple>
+#include <vector>
+#include "TourHeuristics.h"
+
+/**
+ * @file HeldKarp.h
+ * @brief Held-Karp lower bound of the optimal tour cost, templated on a distance policy (see DistancePolicy.h).
+ *
+ * A 1-tree is a spanning tree of every vertex but one (the special vertex) plus the two cheapest edges of that
+ * vertex. Every tour is a 1-tree, so the cheapest 1-tree is a lower bound. Adding a penalty pi[v] to both ends of
+ * every edge of v adds 2 * sum(pi) to every tour but not to every 1-tree, so
+ *     L(pi) = cost of the cheapest 1-tree with the penalties - 2 * sum(pi)
+ * is a lower bound for any pi. Subgradient ascent raises the penalties of the vertexes with degree above 2 and
+ * lowers those of the leaves, pushing the 1-tree towards a tour and L(pi) towards the optimal cost.
+ *
+ * The same 1-tree gives the alpha-nearness of the edges (Helsgaun): alpha(i, j) is how much the cheapest 1-tree
+ * grows when it is forced to hold (i, j). Optimal tour edges have small alpha far more often than they are among
+ * the lightest edges of their vertexes, so the alpha-nearest vertexes make better candidate lists.
+ */
+
+/**
+ * \struct HeldKarpBound
+ * Outcome of the subgradient ascent.
+ */
+struct HeldKarpBound {
+    double bound = 0;       // best L(pi) found (0 if the distances have no 1-tree)
+    int iterations = 0;
+    bool tour = false;      // the best 1-tree was a tour, so the bound is the optimal cost
+    std::vector<double> penalties; // pi of the best bound (empty if there is none)
+};
+
+/**
+ * Calculates the cheapest 1-tree with penalties.
+ * Complexity: O(V^2) distance evaluations
+ * @tparam Distance Distance policy
+ * @param d Distances
+ * @param pi Penalty of each vertex
+ * @param degree Where the degree of each vertex in the 1-tree is stored
+ * @return Cost of the 1-tree with the penalties (without subtracting 2 * sum(pi)), infinity if there is none
+ */
+template <class Distance>
+double oneTree(const Distance &d, const std::vector<double> &pi, std::vector<int> &degree) {
+    int n = d.size();
+    const int special = 0;
+    auto cost = [&d, &pi](int u, int v){ return d(u, v) + pi[u] + pi[v]; };
+
+    std::vector<int> parentOf;
+    std::vector<int> order = minimumSpanningTree(n, cost, 1, parentOf, special);
+    degree.assign(n, 0);
+    double total = 0;
+    for (int v : order) {
+        if (parentOf[v] == -1) continue;
+        total += cost(v, parentOf[v]);
+        degree[v]++;
+        degree[parentOf[v]]++;
+    }
+
+    //the two cheapest edges of the special vertex
+    int first = -1, second = -1;
+    for (int v = 0; v < n; v++) {
+        if (v == special) continue;
+        if (first == -1 || cost(special, v) < cost(special, first)) {
+            second = first;
+            first = v;
+        }
+        else if (second == -1 || cost(special, v) < cost(special, second)) {
+            second = v;
+        }
+    }
+    total += cost(special, first) + cost(special, second);
+    degree[special] = 2;
+    degree[first]++;
+    degree[second]++;
+    return total;
+}
+
+/**
+ * Held-Karp bound by subgradient ascent on the vertex penalties. The step is Polyak's, from an upper bound
+ * (the cost of a known tour), with its scale halved when the bound stops improving.
+ * Complexity: O(V^2) distance evaluations per iteration
+ * @tparam Distance Distance policy
+ * @tparam Stop Callable given the best bound so far and returning true when the ascent must stop
+ * @param d Distances (complete: every pair of vertexes must have a finite distance for the bound to exist)
+ * @param upperBound Cost of a tour
+ * @param maxIterations Maximum number of 1-trees calculated
+ * @param stop When to stop
+ * @return Best bound found
+ */
+template <class Distance, class Stop>
+HeldKarpBound heldKarpBound(const Distance &d, double upperBound, int maxIterations, Stop stop) {
+    HeldKarpBound result;
+    int n = d.size();
+    if (n < 3 || upperBound == std::numeric_limits<double>::infinity()) return result;
+
+    std::vector<double> pi(n, 0);
+    std::vector<int> degree;
+    double best = -std::numeric_limits<double>::infinity();
+    double scale = 2;
+    int sinceImprovement = 0;
+    const int period = 20;  // iterations without improvement before the step is halved
+
+    for (int it = 0; it < maxIterations && scale > 1e-4; it++) {
+        double penalties = 0;
+        for (double p : pi) penalties += p;
+        double bound = oneTree(d, pi, degree) - 2 * penalties;
+        result.iterations++;
+        if (bound == std::numeric_limits<double>::infinity() || std::isnan(bound)) return HeldKarpBound();
+
+        double norm = 0;
+        for (int v = 0; v < n; v++) norm += (double) (degree[v] - 2) * (degree[v] - 2);
+
+        if (bound > best) {
+            best = bound;
+            result.penalties = pi;
+            sinceImprovement = 0;
+            if (norm == 0) {
+                result.tour = true;
+                break;
+            }
+        }
+        else if (++sinceImprovement >= period) {
+            scale /= 2;
+            sinceImprovement = 0;
+        }
+
+        if (norm == 0 || best >= upperBound || stop(best)) break;
+        double step = scale * (upperBound - bound) / norm;
+        for (int v = 0; v < n; v++) pi[v] += step * (degree[v] - 2);
+    }
+
+    result.bound = std::max(best, 0.0);
+    return result;
+}
+
+/**
+ * Calculates the k alpha-nearest vertexes of every vertex, over the cheapest 1-tree with penalties.
+ * For i and j other than the special vertex, adding (i, j) to the spanning tree closes a cycle, and the cheapest
+ * tree holding (i, j) drops the heaviest edge of that cycle, so alpha(i, j) = c(i, j) - beta(i, j) where beta is
+ * the heaviest edge on the tree path between them. The betas of a row are found in one pass over the vertexes in
+ * the order Prim added them (a vertex comes after its parent): beta(i, j) = max(beta(i, parent of j), c(j, parent
+ * of j)), except along the path from i to the root, which is set first. For the special vertex, the forced edge
+ * replaces its second cheapest one.
+ * Complexity: O(V^2) distance evaluations and O(V^2 log k) time, O(V) memory besides the k candidates per vertex
+ * @tparam Distance Distance policy
+ * @param d Distances (complete)
+ * @param k Number of candidates per vertex
+ * @param pi Penalty of each vertex (empty for none), e.g. the penalties of the Held-Karp bound
+ * @return The candidates of each vertex, by increasing alpha (ties by increasing cost)
+ */
+template <class Distance>
+std::vector<std::vector<int>> alphaCandidates(const Distance &d, int k, const std::vector<double> &pi = {}) {
+    int n = d.size();
+    std::vector<std::vector<int>> candidates(n);
+    if (n < 3) {
+        for (int i = 0; i < n; i++) {
+            for (int j = 0; j < n; j++) if (j != i) candidates[i].push_back(j);
+        }
+        return candidates;
+    }
+    const int special = 0;
+    auto cost = [&d, &pi](int u, int v){ return pi.empty() ? (double) d(u, v) : d(u, v) + pi[u] + pi[v]; };
+
+    std::vector<int> parentOf;
+    std::vector<int> order = minimumSpanningTree(n, cost, 1, parentOf, special);
+    std::vector<double> parentCost(n, 0);
+    for (int v : order) if (parentOf[v] != -1) parentCost[v] = cost(v, parentOf[v]);
+
+    //the edges of the special vertex: the two cheapest are in the 1-tree, the others replace the second
+    int first = -1, second = -1;
+    for (int v = 1; v < n; v++) {
+        if (first == -1 || cost(special, v) < cost(special, first)) {
+            second = first;
+            first = v;
+        }
+        else if (second == -1 || cost(special, v) < cost(special, second)) {
+            second = v;
+        }
+    }
+    double secondCost = cost(special, second);
+    auto specialAlpha = [&](int v){ return v == first || v == second ? 0.0 : cost(special, v) - secondCost; };
+
+    std::vector<double> beta(n);
+    std::vector<int> mark(n, -1);
+    std::vector<std::tuple<double, double, int>> row;   // (alpha, cost, vertex)
+    row.reserve(n);
+    auto keep = [&](int i){
+        size_t m = std::min(row.size(), (size_t) k);
+        std::partial_sort(row.begin(), row.begin() + m, row.end());
+        for (size_t r = 0; r < m; r++) candidates[i].push_back(std::get<2>(row[r]));
+        row.clear();
+    };
+
+    for (int i = 1; i < n; i++) {
+        //beta along the path from i to the root
+        mark[i] = i;
+        beta[i] = -std::numeric_limits<double>::infinity();
+        for (int u = i; parentOf[u] != -1; u = parentOf[u]) {
+            beta[parentOf[u]] = std::max(beta[u], parentCost[u]);
+            mark[parentOf[u]] = i;
+        }
+        //then every other vertex from its parent (a vertex Prim couldn't reach is in no cycle with i)
+        for (int j : order) {
+            if (mark[j] == i) continue;
+            if (parentOf[j] == -1) beta[j] = std::numeric_limits<double>::infinity();
+            else beta[j] = std::max(beta[parentOf[j]], parentCost[j]);
+        }
+        for (int j : order) {
+            if (j == i) continue;
+            double c = cost(i, j);
+            row.emplace_back(c - beta[j], c, j);
+        }
+        double c = cost(i, special);
+        row.emplace_back(specialAlpha(i), c, special);
+        keep(i);
+    }
+    for (int j = 1; j < n; j++) row.emplace_back(specialAlpha(j), cost(special, j), j);
+    keep(special);
+    return candidates;
+}
+
+#endif //PROJECT2_HELDKARP_H
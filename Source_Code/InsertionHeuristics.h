@@ -0,0 +1,390 @@
+//
+// Created by lucas on 19/10/2026.
+//
+
+#ifndef PROJECT2_INSERTIONHEURISTICS_H
+#define PROJECT2_INSERTIONHEURISTICS_H
+
+#include <cmath>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <queue>
+#include <vector>
+#include "NodeInfo.h"
+#include "SpatialGrid.h"
+
+/**
+ * @file InsertionHeuristics.h
+ * @brief Insertion tour construction heuristics (cheapest, farthest and convex hull insertion), templated on a
+ * distance policy (see DistancePolicy.h).
+ *
+ * A tour is grown from a few vertexes by inserting the remaining ones, one at a time, in the edge where they
+ * cost the least. Done naively that is O(V^3): every step looks at every vertex against every edge. Here each
+ * vertex keeps its best insertion in a priority queue, and an insertion only updates the vertexes around the
+ * inserted one; an entry whose edge was split in the meantime is found when it reaches the top of the queue and
+ * is calculated again. With coordinates, the edges tried for a vertex are those of the tour vertexes closest to it
+ * and the vertexes updated after an insertion are those closest to the inserted one (see SpatialGrid), so a step
+ * costs O(INSERTION_NEIGHBOURS) distances instead of O(V).
+ */
+
+const int INSERTION_NEIGHBOURS = 8;     // closest vertexes looked at by each step, when there are coordinates
+
+/**
+ * \class TourInsertion
+ * Tour being built by insertion, as a circular doubly linked list over the vertex indexes.
+ * @tparam Distance Distance policy
+ */
+template <class Distance>
+class TourInsertion {
+public:
+    /**
+     * Creates an empty tour.
+     * Complexity: O(V)
+     * @param d Distances
+     * @param nodes Coordinates of the vertexes, by index (empty if there are none)
+     */
+    TourInsertion(const Distance &d, const std::vector<NodeInfo> &nodes) : d(d), next(d.size(), -1), prev(d.size(), -1),
+        edgeCost(d.size(), 0), outsidePosition(d.size()) {
+        for (int v = 0; v < d.size(); v++) {
+            outsidePosition[v] = v;
+            outside.push_back(v);
+        }
+        if (!nodes.empty()) {
+            inside.reset(new SpatialGrid(nodes));
+            nearOutside.reset(new SpatialGrid(nodes));
+            for (int v = 0; v < d.size(); v++) nearOutside->insert(v);
+        }
+    }
+
+    /**
+     * Checks if a vertex is in the tour.
+     * Complexity: O(1)
+     * @param v Vertex
+     * @return true if v is in the tour
+     */
+    bool contains(int v) const {
+        return next[v] != -1;
+    }
+
+    /**
+     * Gets the vertex after another in the tour.
+     * Complexity: O(1)
+     * @param v Vertex of the tour
+     * @return Next vertex
+     */
+    int after(int v) const {
+        return next[v];
+    }
+
+    /**
+     * Gets the number of vertexes of the graph.
+     * Complexity: O(1)
+     * @return Number of vertexes
+     */
+    int size() const {
+        return (int) next.size();
+    }
+
+    /**
+     * Gets the vertexes not in the tour yet.
+     * Complexity: O(1)
+     * @return The vertexes, in no particular order
+     */
+    const std::vector<int> &remaining() const {
+        return outside;
+    }
+
+    /**
+     * Calculates how much inserting a vertex between a and the vertex after it adds to the tour.
+     * Complexity: O(1) distance evaluations
+     * @param u Vertex not in the tour
+     * @param a Vertex of the tour
+     * @return Added cost (infinity if u can't reach the edge)
+     */
+    double insertionCost(int u, int a) const {
+        int b = next[a];
+        double cost = d(a, u) + d(u, b) - edgeCost[a];
+        return std::isnan(cost) ? std::numeric_limits<double>::infinity() : cost;
+    }
+
+    /**
+     * Gets the cost of the edge from a vertex to the next one.
+     * Complexity: O(1)
+     * @param a Vertex of the tour
+     * @return Cost of the edge (0 while a is the only vertex)
+     */
+    double edge(int a) const {
+        return edgeCost[a];
+    }
+
+    /**
+     * Finds the cheapest edge to insert a vertex in: among the edges of the closest tour vertexes, or among every
+     * edge without coordinates (or while the tour is small).
+     * Complexity: O(INSERTION_NEIGHBOURS) distance evaluations with coordinates, O(V) without
+     * @param u Vertex not in the tour
+     * @param a Where the first vertex of the edge is stored
+     * @return Cost of the insertion
+     */
+    double bestInsertion(int u, int &a) const {
+        double best = std::numeric_limits<double>::infinity();
+        a = first;
+        auto consider = [&](int edgeStart){
+            double cost = insertionCost(u, edgeStart);
+            if (cost < best) {
+                best = cost;
+                a = edgeStart;
+            }
+        };
+        if (inside != nullptr && inside->size() > 2 * INSERTION_NEIGHBOURS) {
+            //a small tour is quicker to scan than to look up in a grid made for the whole graph
+            inside->nearest(u, INSERTION_NEIGHBOURS, near);
+            for (int p : near) {
+                consider(p);
+                if (prev[p] != p) consider(prev[p]);
+            }
+        }
+        else {
+            int v = first;
+            do {
+                consider(v);
+                v = next[v];
+            } while (v != first);
+        }
+        return best;
+    }
+
+    /**
+     * Gets the vertexes not in the tour whose insertion may have changed after a vertex was inserted: the closest
+     * ones with coordinates, every one without.
+     * Complexity: O(INSERTION_NEIGHBOURS) with coordinates, O(V) without
+     * @param v Vertex just inserted
+     * @param result Where the vertexes are stored
+     */
+    void affectedBy(int v, std::vector<int> &result) const {
+        if (nearOutside != nullptr) nearOutside->nearest(v, INSERTION_NEIGHBOURS, result);
+        else result = outside;
+    }
+
+    /**
+     * Inserts a vertex after another (or as the first vertex of the tour).
+     * Complexity: O(1) distance evaluations
+     * @param u Vertex not in the tour
+     * @param a Vertex of the tour (-1 if the tour is empty)
+     */
+    void insert(int u, int a) {
+        if (a == -1) {
+            first = u;
+            next[u] = prev[u] = u;
+            edgeCost[u] = 0;
+        }
+        else {
+            int b = next[a];
+            next[a] = u;
+            prev[u] = a;
+            next[u] = b;
+            prev[b] = u;
+            edgeCost[a] = d(a, u);
+            edgeCost[u] = d(u, b);
+        }
+
+        int last = outside.back();
+        outside[outsidePosition[u]] = last;
+        outsidePosition[last] = outsidePosition[u];
+        outside.pop_back();
+        if (inside != nullptr) {
+            inside->insert(u);
+            nearOutside->erase(u);
+        }
+    }
+
+    /**
+     * Gets the tour, starting at a given vertex.
+     * Complexity: O(V)
+     * @param start Vertex of the tour
+     * @return The tour
+     */
+    std::vector<int> tour(int start) const {
+        std::vector<int> res;
+        int v = start;
+        do {
+            res.push_back(v);
+            v = next[v];
+        } while (v != start);
+        return res;
+    }
+
+private:
+    const Distance &d;
+    std::vector<int> next, prev;
+    std::vector<double> edgeCost;               // edgeCost[v] is the cost of the edge from v to next[v]
+    std::vector<int> outside;                   // vertexes not in the tour
+    std::vector<int> outsidePosition;           // position of each vertex in outside
+    std::unique_ptr<SpatialGrid> inside;        // tour vertexes, by coordinates (nullptr without coordinates)
+    std::unique_ptr<SpatialGrid> nearOutside;   // vertexes not in the tour, by coordinates
+    mutable std::vector<int> near;
+    int first = -1;
+};
+
+/**
+ * Inserts the vertexes not in the tour yet, always the one with the smallest key first. The key of a vertex comes
+ * from its cheapest insertion: its cost (cheapest insertion) or the ratio of the new edges to the edge they
+ * replace (convex hull insertion, which keeps the tour close to its outline).
+ * Complexity: O(V log V) queue operations, O(V * INSERTION_NEIGHBOURS) distance evaluations with coordinates
+ * (plus the recalculations of the entries whose edge was split)
+ * @tparam Distance Distance policy
+ * @param tour Tour with at least one vertex
+ * @param ratio If the key is the ratio instead of the cost
+ */
+template <class Distance>
+void insertByKey(TourInsertion<Distance> &tour, bool ratio) {
+    struct Entry {
+        double key;
+        int u, a, b;    // u goes between a and b
+        bool operator>(const Entry &other) const { return key != other.key ? key > other.key : u > other.u; }
+    };
+    std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> queue;
+    std::vector<double> bestKey(tour.size(), std::numeric_limits<double>::infinity());
+    auto key = [&tour, ratio](double cost, int a){
+        double replaced = tour.edge(a);
+        return ratio && replaced > 0 ? (cost + replaced) / replaced : cost;
+    };
+    auto evaluate = [&](int u){
+        int a;
+        double cost = tour.bestInsertion(u, a);
+        bestKey[u] = key(cost, a);
+        queue.push({bestKey[u], u, a, tour.after(a)});
+    };
+
+    for (int u : tour.remaining()) evaluate(u);
+
+    std::vector<int> affected;
+    while (!queue.empty()) {
+        Entry e = queue.top();
+        queue.pop();
+        if (tour.contains(e.u) || e.key > bestKey[e.u]) continue;
+        if (tour.after(e.a) != e.b) {
+            //the edge was split by another insertion
+            evaluate(e.u);
+            continue;
+        }
+        tour.insert(e.u, e.a);
+
+        //only the vertexes around the new edges can get a cheaper insertion
+        tour.affectedBy(e.u, affected);
+        for (int w : affected) {
+            for (int a : {e.a, e.u}) {
+                double k = key(tour.insertionCost(w, a), a);
+                if (k < bestKey[w]) {
+                    bestKey[w] = k;
+                    queue.push({k, w, a, tour.after(a)});
+                }
+            }
+        }
+    }
+}
+
+/**
+ * Builds a tour by cheapest insertion: from the start vertex, always inserts the vertex that adds the least.
+ * Complexity: see insertByKey
+ * @tparam Distance Distance policy
+ * @param d Distances
+ * @param nodes Coordinates of the vertexes, by index (empty if there are none)
+ * @param start Index of the first vertex
+ * @return The tour
+ */
+template <class Distance>
+std::vector<int> cheapestInsertionTour(const Distance &d, const std::vector<NodeInfo> &nodes, int start) {
+    TourInsertion<Distance> tour(d, nodes);
+    tour.insert(start, -1);
+    insertByKey(tour, false);
+    return tour.tour(start);
+}
+
+/**
+ * Builds a tour by farthest insertion: from the start vertex, always inserts (where it costs the least) the
+ * vertex farthest from the tour, so the outline of the tour is laid out first and then filled in.
+ * With coordinates, "farthest" is measured on the coordinates, in a max-priority queue of distances to the tour
+ * that are only refreshed when they reach the top: the distance of a vertex only decreases as the tour grows, so
+ * an entry that is still exact when it is on top is the farthest vertex. Without coordinates, the distance of every
+ * vertex to the tour is updated after each insertion.
+ * Complexity: O(V log V) grid queries with coordinates (plus the refreshed entries), O(V^2) distance evaluations without
+ * @tparam Distance Distance policy
+ * @param d Distances
+ * @param nodes Coordinates of the vertexes, by index (empty if there are none)
+ * @param start Index of the first vertex
+ * @return The tour
+ */
+template <class Distance>
+std::vector<int> farthestInsertionTour(const Distance &d, const std::vector<NodeInfo> &nodes, int start) {
+    int n = d.size();
+    TourInsertion<Distance> tour(d, nodes);
+    tour.insert(start, -1);
+    int a;
+
+    if (!nodes.empty()) {
+        SpatialGrid inside(nodes);
+        inside.insert(start);
+        std::priority_queue<std::pair<double, int>> queue;
+        for (int v : tour.remaining()) queue.push({inside.distance(start, v), v});
+        std::vector<int> closest;
+        while (!queue.empty()) {
+            std::pair<double, int> top = queue.top();
+            queue.pop();
+            int v = top.second;
+            if (tour.contains(v)) continue;
+            inside.nearest(v, 1, closest);
+            double toTour = inside.distance(v, closest[0]);
+            if (toTour < top.first) {
+                //the tour got closer since the entry was pushed
+                queue.push({toTour, v});
+                continue;
+            }
+            tour.bestInsertion(v, a);
+            tour.insert(v, a);
+            inside.insert(v);
+        }
+        return tour.tour(start);
+    }
+
+    std::vector<double> toTour(n, std::numeric_limits<double>::infinity());
+    int inserted = start;
+    while (!tour.remaining().empty()) {
+        //updates the distances to the tour with the vertex just inserted, and finds the farthest vertex
+        int farthest = -1;
+        for (int v : tour.remaining()) {
+            toTour[v] = std::min(toTour[v], d(inserted, v));
+            if (farthest == -1 || toTour[v] > toTour[farthest] || (toTour[v] == toTour[farthest] && v < farthest)) farthest = v;
+        }
+        tour.bestInsertion(farthest, a);
+        tour.insert(farthest, a);
+        inserted = farthest;
+    }
+    return tour.tour(start);
+}
+
+/**
+ * Builds a tour by convex hull insertion: starts from the convex hull of the coordinates, and inserts the vertex
+ * whose cheapest insertion stretches its edge the least (see insertByKey). Without coordinates (or when they are
+ * all on a line) it falls back to cheapest insertion.
+ * Complexity: O(V log V) plus insertByKey
+ * @tparam Distance Distance policy
+ * @param d Distances
+ * @param nodes Coordinates of the vertexes, by index (empty if there are none)
+ * @param start Index of the first vertex
+ * @return The tour
+ */
+template <class Distance>
+std::vector<int> convexHullInsertionTour(const Distance &d, const std::vector<NodeInfo> &nodes, int start) {
+    std::vector<int> hull;
+    if (!nodes.empty()) hull = convexHull(nodes);
+    if (hull.size() < 3) return cheapestInsertionTour(d, nodes, start);
+
+    TourInsertion<Distance> tour(d, nodes);
+    tour.insert(hull[0], -1);
+    for (size_t k = 1; k < hull.size(); k++) tour.insert(hull[k], hull[k - 1]);
+    insertByKey(tour, true);
+    return tour.tour(start);
+}
+
+#endif //PROJECT2_INSERTIONHEURISTICS_H
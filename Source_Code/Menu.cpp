@@ -51,6 +51,7 @@ int Menu::inputCheck(int &option, int min, int max) {
  */
 int Menu::mainMenu(){
     cout << "\nWELCOME TO THE TSP ALGORITHM ANALYSER SYSTEM\n\n";
+    tsp.setLowerBound(true, 0); //the heuristics are shown with their gap to the lower bound
     int s;
     while(true) {
         if (isSystemReset) {
@@ -124,7 +125,7 @@ int Menu::mainMenu(){
  * @return 1 if an error occurred. 0 otherwise
  */
 int Menu::backtracking() {
-    tsp.backtrackingSolution(0);
+    tsp.displayResult(tsp.backtrackingSolution(0));
     return 0;
 }
 
@@ -133,7 +134,7 @@ int Menu::backtracking() {
  * @return 1 if an error occurred. 0 otherwise
  */
 int Menu::otherHeuristic() {
-    tsp.otherHeuristic();
+    tsp.displayResult(tsp.withRoute(tsp.withLowerBound(tsp.otherHeuristic())));
     return 0;
 }
 
@@ -142,7 +143,7 @@ int Menu::otherHeuristic() {
  * @return 1 if an error occurred. 0 otherwise
  */
 int Menu::triangularAproximation() {
-    tsp.triangularAproxSolution();
+    tsp.displayResult(tsp.withRoute(tsp.withLowerBound(tsp.triangularAproxSolution())));
     return 0;
 }
 
@@ -153,11 +154,11 @@ int Menu::triangularAproximation() {
 int Menu::realWorld() {
     cout<<"Please input the id of the vertex where you want to start\n";
     int id;
-    int s = inputCheck(id,0,(int) tsp.getGraph().getVertexSet().size() - 1);
+    int s = inputCheck(id,0,(int) tsp.getGraph().getNumVertex() - 1);
     if(s !=0){
         return 1;
     }
-    tsp.tspRealWord(id);
+    tsp.displayResult(tsp.withLowerBound(tsp.tspRealWord(id)));
     return 0;
 }
 
@@ -168,11 +169,11 @@ int Menu::realWorld() {
 int Menu::realWorld2() {
     cout<<"Please input the id of the vertex where you want to start\n";
     int id;
-    int s = inputCheck(id,0,(int) tsp.getGraph().getVertexSet().size() - 1);
+    int s = inputCheck(id,0,(int) tsp.getGraph().getNumVertex() - 1);
     if(s !=0){
         return 1;
     }
-    tsp.tspRealWord2(id);
+    tsp.displayResult(tsp.withLowerBound(tsp.tspRealWord2(id)));
     return 0;
 }
 
@@ -260,8 +261,8 @@ int Menu::smallDataset() {
             return EXIT_FAILURE;
     }
 
-    tsp.setIdToNode(map);
-    tsp.setGraph(g);
+    tsp.setIdToNode(std::move(map));
+    tsp.setGraph(std::move(g));
 
     return EXIT_SUCCESS;
 
@@ -355,8 +356,8 @@ int Menu::mediumDataset() {
             return EXIT_FAILURE;
     }
 
-    tsp.setIdToNode(map);
-    tsp.setGraph(g);
+    tsp.setIdToNode(std::move(map));
+    tsp.setGraph(std::move(g));
 
     return EXIT_SUCCESS;
 
@@ -405,8 +406,8 @@ int Menu::bigDataset() {
 
     }
 
-    tsp.setIdToNode(map);
-    tsp.setGraph(g);
+    tsp.setIdToNode(std::move(map));
+    tsp.setGraph(std::move(g));
 
     return EXIT_SUCCESS;
 }
\ No newline at end of file
@@ -0,0 +1,144 @@
+//
+// Created by lucas on 19/10/2026.
+//
+
+#include "Ordering.h"
+#include <algorithm>
+#include <cstdint>
+
+using namespace std;
+
+/**
+ * @file Ordering.cpp
+ * @brief Implementation of the vertex orderings.
+ */
+
+/**
+ * Gets an ordering by its name (id, hilbert, rcm or auto).
+ * Complexity: O(1)
+ * @param name Name of the ordering
+ * @param ordering Where the ordering is stored
+ * @return false if the name is unknown
+ */
+bool parseOrdering(const string &name, VertexOrdering &ordering) {
+    if(name == "id") ordering = VertexOrdering::ID;
+    else if(name == "hilbert") ordering = VertexOrdering::HILBERT;
+    else if(name == "rcm") ordering = VertexOrdering::RCM;
+    else if(name == "auto") ordering = VertexOrdering::AUTO;
+    else return false;
+    return true;
+}
+
+/**
+ * Position of a cell in the Hilbert curve that fills a 2^16 x 2^16 grid.
+ * Complexity: O(16)
+ * @param x Column of the cell
+ * @param y Row of the cell
+ * @return Distance along the curve
+ */
+static uint64_t hilbertDistance(uint32_t x, uint32_t y) {
+    const uint32_t side = 1u << 16;
+    uint64_t d = 0;
+    for(uint32_t s = side / 2; s > 0; s /= 2){
+        uint32_t rx = (x & s) > 0;
+        uint32_t ry = (y & s) > 0;
+        d += (uint64_t) s * s * ((3 * rx) ^ ry);
+        //rotates the quadrant so the curve stays continuous
+        if(ry == 0){
+            if(rx == 1){
+                x = side - 1 - x;
+                y = side - 1 - y;
+            }
+            swap(x, y);
+        }
+    }
+    return d;
+}
+
+/**
+ * Orders vertexes along a Hilbert curve over their coordinates (the bounding box is scaled to the curve's grid).
+ * Complexity: O(V log V)
+ * @param nodes Vertexes
+ * @return The new order: order[k] is the position in nodes of the k-th vertex
+ */
+vector<int> hilbertOrder(const vector<NodeInfo> &nodes) {
+    int n = (int) nodes.size();
+    vector<int> order(n);
+    for(int i = 0; i < n; i++) order[i] = i;
+    if(n == 0) return order;
+
+    double minLat = nodes[0].getLatitude(), maxLat = minLat;
+    double minLon = nodes[0].getLongitude(), maxLon = minLon;
+    for(const NodeInfo &node : nodes){
+        minLat = min(minLat, node.getLatitude());
+        maxLat = max(maxLat, node.getLatitude());
+        minLon = min(minLon, node.getLongitude());
+        maxLon = max(maxLon, node.getLongitude());
+    }
+    double latScale = maxLat > minLat ? 65535 / (maxLat - minLat) : 0;
+    double lonScale = maxLon > minLon ? 65535 / (maxLon - minLon) : 0;
+
+    vector<uint64_t> key(n);
+    for(int i = 0; i < n; i++){
+        uint32_t x = (uint32_t) ((nodes[i].getLongitude() - minLon) * lonScale);
+        uint32_t y = (uint32_t) ((nodes[i].getLatitude() - minLat) * latScale);
+        key[i] = hilbertDistance(x, y);
+    }
+    stable_sort(order.begin(), order.end(), [&key](int a, int b){ return key[a] < key[b]; });
+    return order;
+}
+
+/**
+ * Orders vertexes by reverse Cuthill-McKee: a breadth-first search from a vertex of smallest degree, visiting
+ * the neighbours by increasing degree, reversed. Every component is ordered this way.
+ * Complexity: O(V + E log E)
+ * @param offsets Edges of v are in [offsets[v], offsets[v + 1]) of targets
+ * @param targets Destinations of the edges
+ * @return The new order: order[k] is the old number of the k-th vertex
+ */
+vector<int> reverseCuthillMcKee(const vector<int> &offsets, const vector<int> &targets) {
+    int n = (int) offsets.size() - 1;
+    auto degree = [&offsets](int v){ return offsets[v + 1] - offsets[v]; };
+
+    vector<int> byDegree(n);
+    for(int v = 0; v < n; v++) byDegree[v] = v;
+    stable_sort(byDegree.begin(), byDegree.end(), [&degree](int a, int b){ return degree(a) < degree(b); });
+
+    vector<int> order;
+    order.reserve(n);
+    vector<char> placed(n, 0);
+    vector<int> next;
+    for(int root : byDegree){
+        if(placed[root]) continue;
+        placed[root] = 1;
+        order.push_back(root);
+        for(size_t head = order.size() - 1; head < order.size(); head++){
+            int v = order[head];
+            next.clear();
+            for(int k = offsets[v]; k < offsets[v + 1]; k++){
+                int w = targets[k];
+                if(!placed[w]){
+                    placed[w] = 1;
+                    next.push_back(w);
+                }
+            }
+            stable_sort(next.begin(), next.end(), [&degree](int a, int b){ return degree(a) < degree(b); });
+            order.insert(order.end(), next.begin(), next.end());
+        }
+    }
+    reverse(order.begin(), order.end());
+    return order;
+}
+
+/**
+ * Checks if the vertexes have coordinates (the toy graphs only have ids).
+ * Complexity: O(V)
+ * @param nodes Vertexes
+ * @return true if some vertex has a non-zero latitude or longitude
+ */
+bool hasCoordinates(const vector<NodeInfo> &nodes) {
+    for(const NodeInfo &node : nodes){
+        if(node.getLatitude() != 0 || node.getLongitude() != 0) return true;
+    }
+    return false;
+}
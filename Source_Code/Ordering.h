@@ -0,0 +1,35 @@
+//
+// Created by lucas on 19/10/2026.
+//
+
+#ifndef PROJECT2_ORDERING_H
+#define PROJECT2_ORDERING_H
+
+#include <string>
+#include <vector>
+#include "NodeInfo.h"
+
+/**
+ * @file Ordering.h
+ * @brief Vertex orderings for memory locality.
+ *
+ * The index of a graph (GraphIndex) numbers the vertexes by increasing id by default, which scatters the
+ * neighbours of a vertex in memory. Numbering them so that close vertexes get close numbers makes the searches
+ * over the index touch far fewer cache lines: a Hilbert curve over the coordinates keeps geographically close
+ * vertexes together, reverse Cuthill-McKee (for graphs without coordinates) keeps the adjacency near the diagonal.
+ * The ids of the vertexes don't change, so the results are mapped back to them as before.
+ */
+
+enum class VertexOrdering {
+    ID,         // increasing id
+    HILBERT,    // Hilbert curve over latitude / longitude
+    RCM,        // reverse Cuthill-McKee over the edges
+    AUTO        // Hilbert if the vertexes have coordinates, RCM otherwise
+};
+
+bool parseOrdering(const std::string &name, VertexOrdering &ordering);
+std::vector<int> hilbertOrder(const std::vector<NodeInfo> &nodes);
+std::vector<int> reverseCuthillMcKee(const std::vector<int> &offsets, const std::vector<int> &targets);
+bool hasCoordinates(const std::vector<NodeInfo> &nodes);
+
+#endif //PROJECT2_ORDERING_H
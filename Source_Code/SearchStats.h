@@ -0,0 +1,83 @@
+//
+// Created by lucas on 19/10/2026.
+//
+
+#ifndef PROJECT2_SEARCHSTATS_H
+#define PROJECT2_SEARCHSTATS_H
+
+#include <iostream>
+#include <vector>
+
+/**
+ * @file SearchStats.h
+ * @brief Definition of the search statistics collected by the exact solvers.
+ *
+ * The counters are only updated when the project is compiled with TSP_SEARCH_STATS
+ * (CMake option of the same name). Without it every TSP_STAT(...) disappears and the
+ * searches run exactly as before.
+ */
+
+#ifdef TSP_SEARCH_STATS
+#define TSP_STAT(statement) do { statement; } while(false)
+#else
+#define TSP_STAT(statement) do { } while(false)
+#endif
+
+/**
+ * \struct SearchStats
+ * Counters of one run of a search algorithm.
+ */
+struct SearchStats {
+    unsigned long long nodesExpanded = 0;      // partial paths extended by one vertex (by BacktrackingEngine or the real world walks)
+    unsigned long long boundPrunes = 0;        // edges discarded because the path would already cost more than the best
+    unsigned long long incumbentUpdates = 0;   // times a better cycle was found
+    unsigned long long improvingMoves = 0;     // moves applied by the local search of the heuristics (2-opt)
+    unsigned long long tries = 0;              // attempts consumed by backtrackingForRealWorld
+    unsigned long long startsWalked = 0;       // starts walked by multiStartNearestNeighbour
+    unsigned long long triesGoingBack = 0;     // steps back consumed by tspRealWord2
+    std::vector<unsigned long long> depthHistogram; // nodes expanded at each depth
+
+    /**
+     * Counts a node expanded at a given depth.
+     * Complexity: O(1) amortized
+     * @param depth Number of vertexes in the current path
+     */
+    void expand(int depth) {
+        nodesExpanded++;
+        if(depthHistogram.size() <= (size_t) depth) depthHistogram.resize(depth + 1, 0);
+        depthHistogram[depth]++;
+    }
+
+    /**
+     * Checks if anything was recorded.
+     * Complexity: O(1)
+     * @return true if no counter was updated
+     */
+    bool empty() const {
+        return nodesExpanded == 0 && boundPrunes == 0 && incumbentUpdates == 0 && improvingMoves == 0 && tries == 0 && startsWalked == 0 && triesGoingBack == 0;
+    }
+
+    /**
+     * Prints the counters.
+     * Complexity: O(d) where d is the maximum depth reached
+     * @param out Where to print
+     */
+    void print(std::ostream &out) const {
+        out << "Nodes expanded: " << nodesExpanded << '\n';
+        out << "Prunes by bound: " << boundPrunes << '\n';
+        out << "Incumbent updates: " << incumbentUpdates << '\n';
+        if(improvingMoves != 0) out << "Improving moves: " << improvingMoves << '\n';
+        if(tries != 0) out << "Tries: " << tries << '\n';
+        if(startsWalked != 0) out << "Starts walked: " << startsWalked << '\n';
+        if(triesGoingBack != 0) out << "Tries going back: " << triesGoingBack << '\n';
+        if(!depthHistogram.empty()){
+            out << "Depth histogram:";
+            for(size_t d = 0; d < depthHistogram.size(); d++){
+                if(depthHistogram[d] != 0) out << ' ' << d << ':' << depthHistogram[d];
+            }
+            out << '\n';
+        }
+    }
+};
+
+#endif //PROJECT2_SEARCHSTATS_H
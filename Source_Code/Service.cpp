@@ -0,0 +1,704 @@
+//
+// Created by lucas on 19/10/2026.
+//
+
+#include "Service.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <iomanip>
+#include <sstream>
+#include <thread>
+#include <vector>
+#include "Batch.h"
+#include "parse.h"
+#include "ThreadPool.h"
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#define PROJECT2_HAS_UNIX_SOCKETS
+#endif
+
+using namespace std;
+
+/**
+ * @file Service.cpp
+ * @brief Implementation of the solve service.
+ */
+
+// ===================================================== LATENCY HISTOGRAM ======================================================================
+
+/**
+ * Adds a latency to the histogram.
+ * Complexity: O(1)
+ * @param seconds Latency of the request
+ */
+void LatencyHistogram::record(double seconds) {
+    double micro = seconds * 1e6;
+    int bucket = micro < 1 ? 0 : (int) log2(micro);
+    if(bucket >= BUCKETS) bucket = BUCKETS - 1;
+    buckets[bucket]++;
+    total++;
+    sum += seconds;
+    maxLatency = max(maxLatency, seconds);
+}
+
+/**
+ * Gets the number of latencies recorded.
+ * Complexity: O(1)
+ * @return Number of requests
+ */
+unsigned long long LatencyHistogram::count() const {
+    return total;
+}
+
+/**
+ * Gets an upper bound of a percentile (the end of the bucket where it falls).
+ * Complexity: O(b) where b is the number of buckets
+ * @param p Percentile between 0 and 1
+ * @return Latency in seconds
+ */
+double LatencyHistogram::percentile(double p) const {
+    if(total == 0) return 0;
+    unsigned long long target = (unsigned long long) ceil(p * (double) total);
+    unsigned long long seen = 0;
+    for(int i = 0; i < BUCKETS; i++){
+        seen += buckets[i];
+        if(seen >= target) return min(ldexp(1.0, i + 1) * 1e-6, maxLatency);
+    }
+    return maxLatency;
+}
+
+/**
+ * Writes the histogram as a JSON object: count, mean, p50, p90, p99, max and the non-empty buckets
+ * (keyed by the upper bound of the bucket in microseconds).
+ * Complexity: O(b) where b is the number of buckets
+ * @return JSON object
+ */
+string LatencyHistogram::toJson() const {
+    ostringstream out;
+    out << setprecision(6);
+    out << "{\"count\":" << total << ",\"mean\":" << (total == 0 ? 0 : sum / (double) total)
+        << ",\"p50\":" << percentile(0.5) << ",\"p90\":" << percentile(0.9) << ",\"p99\":" << percentile(0.99)
+        << ",\"max\":" << maxLatency << ",\"buckets\":{";
+    bool first = true;
+    for(int i = 0; i < BUCKETS; i++){
+        if(buckets[i] == 0) continue;
+        out << (first ? "" : ",") << "\"" << (1ULL << (i + 1)) << "us\":" << buckets[i];
+        first = false;
+    }
+    out << "}}";
+    return out.str();
+}
+
+// ========================================================== JSON ===================================================================================
+
+/**
+ * Skips the spaces of a JSON text.
+ * Complexity: O(n)
+ * @param text JSON text
+ * @param i Current position (updated)
+ */
+static void skipSpaces(const string &text, size_t &i) {
+    while(i < text.size() && isspace((unsigned char) text[i])) i++;
+}
+
+/**
+ * Reads the four hexadecimal digits of a unicode escape.
+ * Complexity: O(1)
+ * @param text JSON text
+ * @param i Position of the first digit (updated to after the last one)
+ * @param code Where the value is stored
+ * @return false if there aren't four hexadecimal digits
+ */
+static bool readHexCode(const string &text, size_t &i, unsigned int &code) {
+    if(i + 4 > text.size()) return false;
+    code = 0;
+    for(size_t end = i + 4; i < end; i++){
+        char c = text[i];
+        if(!isxdigit((unsigned char) c)) return false;
+        code = code * 16 + (isdigit((unsigned char) c) ? c - '0' : tolower((unsigned char) c) - 'a' + 10);
+    }
+    return true;
+}
+
+/**
+ * Appends a code point to a text in UTF-8.
+ * Complexity: O(1)
+ * @param code Code point
+ * @param value Text
+ */
+static void appendUtf8(unsigned int code, string &value) {
+    if(code < 0x80){
+        value += (char) code;
+    }
+    else if(code < 0x800){
+        value += (char) (0xC0 | (code >> 6));
+        value += (char) (0x80 | (code & 0x3F));
+    }
+    else if(code < 0x10000){
+        value += (char) (0xE0 | (code >> 12));
+        value += (char) (0x80 | ((code >> 6) & 0x3F));
+        value += (char) (0x80 | (code & 0x3F));
+    }
+    else{
+        value += (char) (0xF0 | (code >> 18));
+        value += (char) (0x80 | ((code >> 12) & 0x3F));
+        value += (char) (0x80 | ((code >> 6) & 0x3F));
+        value += (char) (0x80 | (code & 0x3F));
+    }
+}
+
+/**
+ * Reads a JSON string starting at the opening quote.
+ * Complexity: O(n) where n is the length of the string
+ * @param text JSON text
+ * @param i Position of the opening quote (updated to after the closing quote)
+ * @param value Where the unescaped string is stored
+ * @return false if the string is not valid
+ */
+static bool readJsonString(const string &text, size_t &i, string &value) {
+    value.clear();
+    i++;
+    while(i < text.size() && text[i] != '"'){
+        if(text[i] == '\\'){
+            if(++i >= text.size()) return false;
+            switch(text[i]){
+                case 'n': value += '\n'; break;
+                case 't': value += '\t'; break;
+                case 'r': value += '\r'; break;
+                case 'b': value += '\b'; break;
+                case 'f': value += '\f'; break;
+                case 'u': {
+                    //a code point, written in UTF-8 (the ones outside the first plane come as a pair of surrogates)
+                    unsigned int code;
+                    i++;
+                    if(!readHexCode(text, i, code)) return false;
+                    if(code >= 0xD800 && code <= 0xDBFF){
+                        unsigned int low;
+                        if(text.compare(i, 2, "\\u") != 0) return false;
+                        i += 2;
+                        if(!readHexCode(text, i, low) || low < 0xDC00 || low > 0xDFFF) return false;
+                        code = 0x10000 + ((code - 0xD800) << 10) + (low - 0xDC00);
+                    }
+                    else if(code >= 0xDC00 && code <= 0xDFFF){
+                        return false;
+                    }
+                    appendUtf8(code, value);
+                    continue;
+                }
+                case '"': case '\\': case '/': value += text[i]; break;
+                default: return false;
+            }
+            i++;
+        }
+        else{
+            value += text[i++];
+        }
+    }
+    if(i >= text.size()) return false;
+    i++;
+    return true;
+}
+
+/**
+ * Skips any JSON value (used for numbers, literals, arrays and nested objects, which are kept as raw text).
+ * Complexity: O(n) where n is the length of the value
+ * @param text JSON text
+ * @param i Position where the value starts (updated to after it)
+ * @return false if the value is not valid
+ */
+static bool skipJsonValue(const string &text, size_t &i) {
+    if(i >= text.size()) return false;
+    if(text[i] == '"'){
+        string ignored;
+        return readJsonString(text, i, ignored);
+    }
+    if(text[i] == '[' || text[i] == '{'){
+        char close = text[i] == '[' ? ']' : '}';
+        i++;
+        skipSpaces(text, i);
+        if(i < text.size() && text[i] == close){
+            i++;
+            return true;
+        }
+        while(true){
+            skipSpaces(text, i);
+            if(close == '}'){
+                string key;
+                if(i >= text.size() || text[i] != '"' || !readJsonString(text, i, key)) return false;
+                skipSpaces(text, i);
+                if(i >= text.size() || text[i] != ':') return false;
+                i++;
+                skipSpaces(text, i);
+            }
+            if(!skipJsonValue(text, i)) return false;
+            skipSpaces(text, i);
+            if(i >= text.size()) return false;
+            if(text[i] == close){
+                i++;
+                return true;
+            }
+            if(text[i] != ',') return false;
+            i++;
+        }
+    }
+    size_t start = i;
+    while(i < text.size() && (isalnum((unsigned char) text[i]) || text[i] == '-' || text[i] == '+' || text[i] == '.')) i++;
+    return i > start;
+}
+
+/**
+ * Parses a flat JSON object. String values are stored unescaped; any other value is stored as its raw text.
+ * Complexity: O(n) where n is the length of the text
+ * @param text JSON text
+ * @param fields Where the fields are stored
+ * @param rawFields Where the raw JSON text of every value is stored, quotes and escapes included (nullptr to skip)
+ * @return false if the text is not a valid JSON object
+ */
+bool parseJsonObject(const string &text, unordered_map<string, string> &fields, unordered_map<string, string> *rawFields) {
+    size_t i = 0;
+    skipSpaces(text, i);
+    if(i >= text.size() || text[i] != '{') return false;
+    i++;
+    skipSpaces(text, i);
+    if(i < text.size() && text[i] == '}') return true;
+
+    while(true){
+        skipSpaces(text, i);
+        string key, value;
+        if(i >= text.size() || text[i] != '"' || !readJsonString(text, i, key)) return false;
+        skipSpaces(text, i);
+        if(i >= text.size() || text[i] != ':') return false;
+        i++;
+        skipSpaces(text, i);
+        size_t start = i;
+        if(i < text.size() && text[i] == '"'){
+            if(!readJsonString(text, i, value)) return false;
+        }
+        else{
+            if(!skipJsonValue(text, i)) return false;
+            value = text.substr(start, i - start);
+        }
+        fields[key] = value;
+        if(rawFields != nullptr) (*rawFields)[key] = text.substr(start, i - start);
+
+        skipSpaces(text, i);
+        if(i >= text.size()) return false;
+        if(text[i] == '}') return true;
+        if(text[i] != ',') return false;
+        i++;
+    }
+}
+
+// ======================================================= SOLVE SERVICE =============================================================================
+
+/**
+ * Creates the service.
+ * Complexity: O(1)
+ * @param threads Number of requests served at the same time
+ */
+SolveService::SolveService(unsigned int threads) : threads(threads == 0 ? 1 : threads), stopping(false) {}
+
+/**
+ * Makes the datasets loaded from now on use a contraction hierarchy for shortest path distances,
+ * saved next to their edges file.
+ * Complexity: O(1)
+ * @param enabled If the hierarchy is used
+ */
+void SolveService::setHierarchy(bool enabled) {
+    hierarchy = enabled;
+}
+
+/**
+ * Sets how the datasets loaded from now on number the vertexes of their index (see Ordering.h).
+ * Complexity: O(1)
+ * @param ordering_ The ordering
+ */
+void SolveService::setOrdering(VertexOrdering ordering_) {
+    ordering = ordering_;
+}
+
+/**
+ * Checks if a shutdown was requested.
+ * Complexity: O(1)
+ * @return true if the service is stopping
+ */
+bool SolveService::isStopping() const {
+    return stopping.load();
+}
+
+/**
+ * Gets a dataset, loading it the first time it is requested. Concurrent requests for a dataset that is
+ * being loaded wait for it instead of loading it again; once it is loaded, they only share its lock to check it.
+ * Complexity: O(n) where n is the size of the dataset files (only in the first request)
+ * @param name Name or path of the dataset
+ * @return The dataset, or nullptr if it could not be loaded
+ */
+shared_ptr<SolveService::Dataset> SolveService::getDataset(const string &name) {
+    shared_ptr<Dataset> dataset;
+    {
+        lock_guard<mutex> lock(datasetsMutex);
+        shared_ptr<Dataset> &entry = datasets[name];
+        if(entry == nullptr) entry = make_shared<Dataset>();
+        dataset = entry;
+    }
+
+    {
+        shared_lock<shared_timed_mutex> lock(dataset->mutex);
+        if(dataset->loaded) return dataset;
+    }
+
+    unique_lock<shared_timed_mutex> lock(dataset->mutex);
+    if(!dataset->loaded && !dataset->failed){
+        unordered_map<int, NodeInfo> map;
+        Graph<NodeInfo> g;
+        string edgesFile;
+        if(loadDataset(name, map, g, &edgesFile)){
+            dataset->tsp.setIdToNode(std::move(map));
+            dataset->tsp.setGraph(std::move(g));
+            dataset->tsp.setOrdering(ordering);
+            dataset->tsp.setHierarchy(hierarchy, edgesFile + ".ch");
+            dataset->loaded = true;
+        }
+        else{
+            dataset->failed = true;
+        }
+    }
+
+    if(dataset->failed){
+        lock_guard<mutex> mapLock(datasetsMutex);
+        auto it = datasets.find(name);
+        if(it != datasets.end() && it->second == dataset) datasets.erase(it); //allows trying again later
+        return nullptr;
+    }
+    return dataset;
+}
+
+/**
+ * Records the latency of a request.
+ * Complexity: O(log k) where k is the number of request kinds
+ * @param key Kind of request (e.g. "load" or "solve:realworld2")
+ * @param seconds Latency
+ */
+void SolveService::recordLatency(const string &key, double seconds) {
+    lock_guard<mutex> lock(statsMutex);
+    latencies[key].record(seconds);
+}
+
+/**
+ * Writes the latency histograms of every kind of request as a JSON object.
+ * Complexity: O(k * b) where k is the number of request kinds and b the number of buckets
+ * @return JSON object
+ */
+string SolveService::statsJson() const {
+    lock_guard<mutex> lock(statsMutex);
+    string res = "{";
+    bool first = true;
+    for(const auto &entry : latencies){
+        res += (first ? "\"" : ",\"") + jsonEscape(entry.first) + "\":" + entry.second.toJson();
+        first = false;
+    }
+    return res + "}";
+}
+
+/**
+ * Answers one request.
+ * Complexity: depends on the request
+ * @param line JSON request
+ * @return JSON response (without the final newline)
+ */
+string SolveService::handle(const string &line) {
+    auto clockStart = chrono::high_resolution_clock::now();
+    unordered_map<string, string> request, raw;
+    ostringstream out;
+    out << setprecision(12);
+
+    if(!parseJsonObject(line, request, &raw)){
+        out << "{\"ok\":false,\"error\":\"invalid JSON\"}";
+        return out.str();
+    }
+
+    string id = raw.count("id") ? raw["id"] : "null"; //echoed as it was written
+    string op = request["op"];
+    string key = op;
+    string body;
+    string error;
+
+    if(op == "load"){
+        shared_ptr<Dataset> dataset = getDataset(request["dataset"]);
+        if(dataset == nullptr){
+            error = "unable to load the dataset";
+        }
+        else{
+            shared_lock<shared_timed_mutex> lock(dataset->mutex);
+            body = ",\"dataset\":\"" + jsonEscape(request["dataset"]) + "\",\"vertexes\":" + to_string(dataset->tsp.getGraph().getNumVertex());
+        }
+    }
+    else if(op == "solve"){
+        string algorithm = request["algorithm"];
+        key = "solve:" + algorithm;
+        if(!isKnownAlgorithm(algorithm)){
+            error = "unknown algorithm";
+        }
+        else{
+            shared_ptr<Dataset> dataset = getDataset(request["dataset"]);
+            if(dataset == nullptr){
+                error = "unable to load the dataset";
+            }
+            else{
+                BatchRow row {request["dataset"], algorithm, 0, TSPResult()};
+                if(algorithmUsesStart(algorithm) && request.count("start")) row.start = atoi(request["start"].c_str());
+
+                double budget = request.count("budget") ? atof(request["budget"].c_str()) : 0;
+                runAlgorithm(dataset->tsp, algorithm, row.start, budget, row.result);
+                if(request["path"] == "true") row.result = dataset->tsp.withRoute(row.result);
+                body = "," + batchRowJsonFields(row, request["path"] == "true");
+            }
+        }
+    }
+    else if(op == "unload"){
+        lock_guard<mutex> lock(datasetsMutex);
+        body = ",\"unloaded\":" + string(datasets.erase(request["dataset"]) ? "true" : "false");
+    }
+    else if(op == "stats"){
+        body = ",\"latency\":" + statsJson();
+    }
+    else if(op == "shutdown"){
+        stopping = true;
+    }
+    else{
+        error = "unknown op";
+    }
+
+    double latency = chrono::duration<double>(chrono::high_resolution_clock::now() - clockStart).count();
+    if(error.empty()) recordLatency(key, latency);
+
+    out << "{\"id\":" << id << ",\"op\":\"" << jsonEscape(op) << "\",\"ok\":" << (error.empty() ? "true" : "false");
+    if(!error.empty()) out << ",\"error\":\"" << error << '"';
+    out << body;
+    if(op != "stats") out << ",\"latency\":" << latency;
+    out << '}';
+    return out.str();
+}
+
+/**
+ * Serves the requests read from a stream until it ends or a shutdown is requested.
+ * Complexity: depends on the requests
+ * @param in Where the requests are read
+ * @param out Where the responses are written
+ * @return 0
+ */
+int SolveService::serveStream(istream &in, ostream &out) {
+    mutex outMutex;
+    {
+        ThreadPool pool(threads);
+        string line;
+        while(!isStopping() && getline(in, line)){
+            if(line.find_first_not_of(" \t\r") == string::npos) continue;
+
+            unordered_map<string, string> request;
+            if(parseJsonObject(line, request) && request["op"] == "shutdown"){
+                pool.wait();
+                lock_guard<mutex> lock(outMutex);
+                out << handle(line) << endl;
+                break;
+            }
+
+            pool.submit([this, line, &out, &outMutex]{
+                string response = handle(line);
+                lock_guard<mutex> lock(outMutex);
+                out << response << endl;
+            });
+        }
+        pool.wait();
+    }
+
+    cerr << "Latency: " << statsJson() << '\n';
+    return EXIT_SUCCESS;
+}
+
+#ifdef PROJECT2_HAS_UNIX_SOCKETS
+
+/**
+ * Writes a whole buffer to a socket.
+ * Complexity: O(n) where n is the size of the buffer
+ * @param fd Socket
+ * @param data Buffer to write
+ * @return false if the connection was closed
+ */
+static bool writeAll(int fd, const string &data) {
+    size_t written = 0;
+    while(written < data.size()){
+        ssize_t n = write(fd, data.data() + written, data.size() - written);
+        if(n <= 0) return false;
+        written += (size_t) n;
+    }
+    return true;
+}
+
+/**
+ * Serves the clients of a Unix domain socket until a shutdown is requested. Each client sends JSON lines
+ * and gets the responses in the same connection.
+ * Complexity: depends on the requests
+ * @param path Path of the socket
+ * @return 1 if an error occurred. 0 otherwise
+ */
+int SolveService::serveSocket(const string &path) {
+    int listenFd = socket(AF_UNIX, SOCK_STREAM, 0);
+    sockaddr_un address {};
+    address.sun_family = AF_UNIX;
+    if(listenFd < 0 || path.size() >= sizeof(address.sun_path)){
+        cerr << "Error: Unable to create the socket." << '\n';
+        return EXIT_FAILURE;
+    }
+    strncpy(address.sun_path, path.c_str(), sizeof(address.sun_path) - 1);
+    unlink(path.c_str());
+    if(::bind(listenFd, (sockaddr *) &address, sizeof(address)) != 0 || listen(listenFd, 16) != 0){
+        cerr << "Error: Unable to listen on " << path << '\n';
+        close(listenFd);
+        return EXIT_FAILURE;
+    }
+
+    struct Connection {
+        int fd;
+        mutex writeMutex;
+        explicit Connection(int fd) : fd(fd) {}
+        ~Connection() { close(fd); }
+    };
+
+    ThreadPool pool(threads);
+    vector<thread> readers;
+    mutex connectionsMutex;
+    vector<int> openFds;
+
+    while(!isStopping()){
+        int fd = accept(listenFd, nullptr, nullptr);
+        if(fd < 0) break;
+        {
+            lock_guard<mutex> lock(connectionsMutex);
+            openFds.push_back(fd);
+        }
+
+        readers.emplace_back([this, fd, listenFd, &pool, &connectionsMutex, &openFds]{
+            auto connection = make_shared<Connection>(fd);
+            string buffer;
+            char chunk[4096];
+            ssize_t n;
+            while(!isStopping() && (n = read(fd, chunk, sizeof(chunk))) > 0){
+                buffer.append(chunk, (size_t) n);
+                size_t newline;
+                while((newline = buffer.find('\n')) != string::npos){
+                    string line = buffer.substr(0, newline);
+                    buffer.erase(0, newline + 1);
+                    if(line.find_first_not_of(" \t\r") == string::npos) continue;
+
+                    unordered_map<string, string> request;
+                    if(parseJsonObject(line, request) && request["op"] == "shutdown"){
+                        string response = handle(line) + "\n";
+                        {
+                            lock_guard<mutex> lock(connection->writeMutex);
+                            writeAll(fd, response);
+                        }
+                        //wakes up the accept loop and the other readers
+                        shutdown(listenFd, SHUT_RDWR);
+                        lock_guard<mutex> lock(connectionsMutex);
+                        for(int other : openFds) if(other != fd) shutdown(other, SHUT_RD);
+                        return;
+                    }
+
+                    pool.submit([this, line, connection]{
+                        string response = handle(line) + "\n";
+                        lock_guard<mutex> lock(connection->writeMutex);
+                        writeAll(connection->fd, response);
+                    });
+                }
+            }
+
+            lock_guard<mutex> lock(connectionsMutex);
+            openFds.erase(remove(openFds.begin(), openFds.end(), fd), openFds.end());
+        });
+    }
+
+    for(thread &reader : readers) reader.join();
+    pool.wait();
+    close(listenFd);
+    unlink(path.c_str());
+
+    cerr << "Latency: " << statsJson() << '\n';
+    return EXIT_SUCCESS;
+}
+
+#else
+
+int SolveService::serveSocket(const string &path) {
+    cerr << "Error: Unix domain sockets are not available in this system, use stdin instead." << '\n';
+    return EXIT_FAILURE;
+}
+
+#endif
+
+// ====================================================== COMMAND LINE ===============================================================================
+
+/**
+ * Checks if the program was called in service mode.
+ * Complexity: O(1)
+ * @param argc Number of arguments
+ * @param argv Arguments
+ * @return true if the first argument is --serve
+ */
+bool isServiceInvocation(int argc, char *argv[]) {
+    return argc > 1 && strcmp(argv[1], "--serve") == 0;
+}
+
+/**
+ * Reads the service options from the command line.
+ * Complexity: O(n) where n is the number of arguments
+ * @param argc Number of arguments
+ * @param argv Arguments
+ * @param options Where the options are stored
+ * @return 1 if an error occurred. 0 otherwise
+ */
+int parseServiceOptions(int argc, char *argv[], ServiceOptions &options) {
+    options.threads = ThreadPool::defaultThreads();
+    for(int i = 2; i < argc; i++){
+        string arg = argv[i];
+        if(arg == "--socket" && i + 1 < argc){
+            options.socketPath = argv[++i];
+        }
+        else if(arg == "--threads" && i + 1 < argc){
+            int threads = atoi(argv[++i]);
+            options.threads = threads <= 0 ? ThreadPool::defaultThreads() : (unsigned int) threads;
+        }
+        else if(arg == "--hierarchy"){
+            options.hierarchy = true;
+        }
+        else if(arg == "--ordering" && i + 1 < argc && parseOrdering(argv[i + 1], options.ordering)){
+            i++;
+        }
+        else{
+            cerr << "Unknown option: " << arg << '\n';
+            return EXIT_FAILURE;
+        }
+    }
+    return EXIT_SUCCESS;
+}
+
+/**
+ * Runs the service until it is shut down.
+ * Complexity: depends on the requests
+ * @param options Options of the service
+ * @return 1 if an error occurred. 0 otherwise
+ */
+int runService(const ServiceOptions &options) {
+    SolveService service(options.threads);
+    service.setHierarchy(options.hierarchy);
+    service.setOrdering(options.ordering);
+    if(options.socketPath.empty()){
+        return service.serveStream(cin, cout);
+    }
+    return service.serveSocket(options.socketPath);
+}
@@ -0,0 +1,110 @@
+//
+// Created by lucas on 19/10/2026.
+//
+
+#ifndef PROJECT2_SERVICE_H
+#define PROJECT2_SERVICE_H
+
+#include <atomic>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+#include "TSP.h"
+
+/**
+ * @file Service.h
+ * @brief Definition of the solve service (long running mode that keeps the graphs in memory).
+ *
+ * Usage: main --serve [--socket path] [--threads n] [--hierarchy] [--ordering id|hilbert|rcm|auto]
+ *
+ * Requests and responses are JSON objects, one per line, read from stdin (or from the clients of a Unix domain socket):
+ *   {"id":1,"op":"load","dataset":"big:1"}
+ *   {"id":2,"op":"solve","dataset":"big:1","algorithm":"realworld2","start":5,"budget":10,"path":true}
+ *   {"id":3,"op":"unload","dataset":"big:1"}
+ *   {"id":4,"op":"stats"}
+ *   {"op":"shutdown"}
+ * "path":true adds the path and, when some of its steps have no edge, the route driven (see TSP::withRoute).
+ * Every response has the "id" of its request, "ok" and "latency" (seconds). Requests are served concurrently,
+ * so responses may come out of order.
+ */
+
+/**
+ * \class LatencyHistogram
+ * Histogram of request latencies with power of two buckets (in microseconds).
+ */
+class LatencyHistogram {
+public:
+    void record(double seconds);
+    unsigned long long count() const;
+    double percentile(double p) const;
+    std::string toJson() const;
+
+private:
+    static const int BUCKETS = 40; // bucket i has the latencies in [2^i, 2^(i+1)) microseconds
+    unsigned long long buckets[BUCKETS] = {};
+    unsigned long long total = 0;
+    double sum = 0;
+    double maxLatency = 0;
+};
+
+/**
+ * \struct ServiceOptions
+ * Options of the service, as given in the command line.
+ */
+struct ServiceOptions {
+    std::string socketPath; // empty to serve stdin/stdout
+    unsigned int threads = 1;
+    bool hierarchy = false; // use contraction hierarchies (saved next to the datasets) for shortest path distances
+    VertexOrdering ordering = VertexOrdering::ID; // numbering of the vertexes of the indexes
+};
+
+/**
+ * \class SolveService
+ * Keeps the loaded datasets (and everything the TSP object derives from them) in memory and answers requests.
+ * Requests are solved concurrently, also for the same dataset: each run keeps its own state and time budget (see TSP).
+ */
+class SolveService {
+public:
+    explicit SolveService(unsigned int threads);
+    void setHierarchy(bool enabled);
+    void setOrdering(VertexOrdering ordering);
+
+    std::string handle(const std::string &line);
+    int serveStream(std::istream &in, std::ostream &out);
+    int serveSocket(const std::string &path);
+    std::string statsJson() const;
+    bool isStopping() const;
+
+private:
+    struct Dataset {
+        std::shared_timed_mutex mutex; // shared to check if the dataset is loaded, exclusive to load it
+        bool loaded = false;
+        bool failed = false;
+        TSP tsp;
+    };
+
+    std::shared_ptr<Dataset> getDataset(const std::string &name);
+    void recordLatency(const std::string &key, double seconds);
+
+    unsigned int threads;
+    bool hierarchy = false;
+    VertexOrdering ordering = VertexOrdering::ID;
+    std::atomic<bool> stopping;
+
+    std::mutex datasetsMutex;
+    std::unordered_map<std::string, std::shared_ptr<Dataset>> datasets;
+
+    mutable std::mutex statsMutex;
+    std::map<std::string, LatencyHistogram> latencies;
+};
+
+bool isServiceInvocation(int argc, char *argv[]);
+int parseServiceOptions(int argc, char *argv[], ServiceOptions &options);
+bool parseJsonObject(const std::string &text, std::unordered_map<std::string, std::string> &fields, std::unordered_map<std::string, std::string> *rawFields = nullptr);
+int runService(const ServiceOptions &options);
+
+#endif //PROJECT2_SERVICE_H
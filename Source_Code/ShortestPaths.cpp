@@ -0,0 +1,139 @@
+//
+// Created by lucas on 19/10/2026.
+//
+
+#include "ShortestPaths.h"
+#include <algorithm>
+
+using namespace std;
+
+/**
+ * @file ShortestPaths.cpp
+ * @brief Implementation of the shortest path algorithms.
+ */
+
+// ======================================================= DIJKSTRA SEARCH ====================================================================
+/**
+ * Creates a search over an index.
+ * Complexity: O(V) where V is the number of vertexes
+ * @param g Index of the graph
+ */
+DijkstraSearch::DijkstraSearch(const GraphIndex &g) : g(g), dist(g.size(), GraphIndex::infinity()), parents(g.size(), -1), settled(g.size(), 0) {}
+
+/**
+ * Starts a new search, clearing what the previous one touched.
+ * Complexity: O(t) where t is the number of vertexes touched by the previous search
+ * @param source Index of the source vertex
+ */
+void DijkstraSearch::start(int source) {
+    for(int v : touched){
+        dist[v] = GraphIndex::infinity();
+        parents[v] = -1;
+        settled[v] = 0;
+    }
+    touched.clear();
+    queue = priority_queue<Entry, vector<Entry>, greater<Entry>>();
+
+    dist[source] = 0;
+    touched.push_back(source);
+    queue.push({0, source});
+}
+
+/**
+ * Settles the next closest vertex and relaxes its edges.
+ * Complexity: O(d log E) where d is the degree of the vertex settled
+ * @return Index of the vertex settled, -1 if every reachable vertex is already settled
+ */
+int DijkstraSearch::settleNext() {
+    while(!queue.empty()){
+        Entry top = queue.top();
+        queue.pop();
+        int v = top.second;
+        if(settled[v] || top.first > dist[v]) continue;
+        settled[v] = 1;
+
+        for(const Neighbour *e = g.begin(v); e != g.end(v); e++){
+            double d = top.first + e->weight;
+            if(d < dist[e->to]){
+                if(dist[e->to] == GraphIndex::infinity()) touched.push_back(e->to);
+                dist[e->to] = d;
+                parents[e->to] = v;
+                queue.push({d, e->to});
+            }
+        }
+        return v;
+    }
+    return -1;
+}
+
+/**
+ * Gets the distance found to a vertex (final once the vertex is settled).
+ * Complexity: O(1)
+ * @param v Index of the vertex
+ * @return Distance from the source, infinity if not reached
+ */
+double DijkstraSearch::distance(int v) const {
+    return dist[v];
+}
+
+/**
+ * Gets the previous vertex in the path from the source.
+ * Complexity: O(1)
+ * @param v Index of the vertex
+ * @return Index of the previous vertex, -1 for the source and the vertexes not reached
+ */
+int DijkstraSearch::previous(int v) const {
+    return parents[v];
+}
+
+/**
+ * Gets the path from the source to a settled vertex.
+ * Complexity: O(p) where p is the number of vertexes of the path
+ * @param v Index of the destination
+ * @return Indexes of the vertexes of the path (source and v included), empty if v wasn't reached
+ */
+vector<int> DijkstraSearch::pathTo(int v) const {
+    vector<int> path;
+    if(dist[v] == GraphIndex::infinity()) return path;
+    for(int u = v; u != -1; u = parents[u]) path.push_back(u);
+    reverse(path.begin(), path.end());
+    return path;
+}
+
+// ======================================================= ROUTES ====================================================================
+/**
+ * Finds the cheapest route between two vertexes.
+ * Complexity: O(E log E)
+ * @param g Index of the graph
+ * @param source Index of the source
+ * @param target Index of the target
+ * @return Indexes of the vertexes of the route (source and target included), empty if there is none
+ */
+vector<int> shortestPath(const GraphIndex &g, int source, int target) {
+    DijkstraSearch search(g);
+    search.start(source);
+    for(int v = search.settleNext(); v != -1; v = search.settleNext()){
+        if(v == target) return search.pathTo(target);
+    }
+    return {};
+}
+
+/**
+ * Finds the closest marked vertex (other than the source) by shortest path distance.
+ * Complexity: O(E log E) in the worst case, usually much less since the search stops at the first marked vertex
+ * @param search Search to use
+ * @param source Index of the source
+ * @param marked Which vertexes are wanted
+ * @param distance Where the distance to the vertex found is stored
+ * @return Index of the vertex found, -1 if no marked vertex is reachable
+ */
+int nearestMarked(DijkstraSearch &search, int source, const vector<char> &marked, double &distance) {
+    search.start(source);
+    for(int v = search.settleNext(); v != -1; v = search.settleNext()){
+        if(v != source && marked[v]){
+            distance = search.distance(v);
+            return v;
+        }
+    }
+    return -1;
+}
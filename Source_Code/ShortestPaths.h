@@ -0,0 +1,52 @@
+//
+// Created by lucas on 19/10/2026.
+//
+
+#ifndef PROJECT2_SHORTESTPATHS_H
+#define PROJECT2_SHORTESTPATHS_H
+
+#include <functional>
+#include <queue>
+#include <utility>
+#include <vector>
+#include "GraphIndex.h"
+
+/**
+ * @file ShortestPaths.h
+ * @brief Shortest paths over a GraphIndex: Dijkstra and the cheapest route between two vertexes.
+ *
+ * The incomplete (real world) graphs don't have an edge between every pair of vertexes, so the heuristics use
+ * these distances (the cost of the cheapest route between two vertexes) instead of the straight line distance.
+ */
+
+/**
+ * \class DijkstraSearch
+ * Dijkstra from one source that settles one vertex at a time, so the caller can stop as soon as it has
+ * what it needs. The arrays are reused between searches and only the touched entries are reset.
+ * Each thread must use its own object.
+ */
+class DijkstraSearch {
+public:
+    explicit DijkstraSearch(const GraphIndex &g);
+
+    void start(int source);
+    int settleNext();
+    double distance(int v) const;
+    int previous(int v) const;
+    std::vector<int> pathTo(int v) const;
+
+private:
+    typedef std::pair<double, int> Entry;
+
+    const GraphIndex &g;
+    std::vector<double> dist;
+    std::vector<int> parents;
+    std::vector<char> settled;
+    std::vector<int> touched;
+    std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> queue;
+};
+
+std::vector<int> shortestPath(const GraphIndex &g, int source, int target);
+int nearestMarked(DijkstraSearch &search, int source, const std::vector<char> &marked, double &distance);
+
+#endif //PROJECT2_SHORTESTPATHS_H
@@ -0,0 +1,212 @@
+//
+// Created by lucas on 19/10/2026.
+//
+
+#ifndef PROJECT2_SOLVERSTATE_H
+#define PROJECT2_SOLVERSTATE_H
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <vector>
+#include "SearchStats.h"
+
+/**
+ * @file SolverState.h
+ * @brief Per-run state of the solvers, kept out of the graph.
+ *
+ * The graph (and its GraphIndex) only hold the problem, so several solves can read them at the same time.
+ * What a single run marks or updates (visited vertexes, tentative distances, the tree being built) lives in
+ * these dense arrays over the vertex indexes of the GraphIndex, owned by the run, and so do its statistics and
+ * time budget (SearchRun).
+ */
+
+/**
+ * \class VisitedSet
+ * Set of vertex indexes as a bitset: 64 vertexes per word, so the whole set of a large graph stays in cache
+ * and clearing it is a memset of V / 64 words.
+ */
+class VisitedSet {
+public:
+    VisitedSet() = default;
+
+    /**
+     * Creates an empty set for indexes in [0, n).
+     * Complexity: O(n / 64)
+     * @param n Number of vertexes
+     */
+    explicit VisitedSet(int n) : words((n + 63) / 64, 0), count(0) {}
+
+    /**
+     * Checks if an index is in the set.
+     * Complexity: O(1)
+     * @param v Index of the vertex
+     * @return true if v is in the set
+     */
+    bool test(int v) const {
+        return (words[v >> 6] >> (v & 63)) & 1;
+    }
+
+    /**
+     * Adds an index to the set.
+     * Complexity: O(1)
+     * @param v Index of the vertex
+     */
+    void set(int v) {
+        uint64_t bit = (uint64_t) 1 << (v & 63);
+        count += (words[v >> 6] & bit) == 0;
+        words[v >> 6] |= bit;
+    }
+
+    /**
+     * Removes an index from the set.
+     * Complexity: O(1)
+     * @param v Index of the vertex
+     */
+    void reset(int v) {
+        uint64_t bit = (uint64_t) 1 << (v & 63);
+        count -= (words[v >> 6] & bit) != 0;
+        words[v >> 6] &= ~bit;
+    }
+
+    /**
+     * Empties the set.
+     * Complexity: O(n / 64)
+     */
+    void clear() {
+        std::fill(words.begin(), words.end(), 0);
+        count = 0;
+    }
+
+    /**
+     * Gets the number of indexes in the set.
+     * Complexity: O(1)
+     * @return Size of the set
+     */
+    int size() const {
+        return count;
+    }
+
+private:
+    std::vector<uint64_t> words;
+    int count = 0;
+};
+
+/**
+ * \class StampedArray
+ * Array over the vertex indexes whose entries are only valid for the current epoch: an entry that wasn't
+ * written since the last clear reads as the default value, so clearing is O(1) (a new epoch) instead of a pass
+ * over the array. The stamps are only rewritten when the epoch counter wraps around.
+ * @tparam V Type of the values
+ */
+template <class V>
+class StampedArray {
+public:
+    StampedArray() = default;
+
+    /**
+     * Creates an array of n entries, all with the default value.
+     * Complexity: O(n)
+     * @param n Number of entries
+     * @param empty Value of the entries not written in the current epoch
+     */
+    StampedArray(int n, V empty) : values(n), stamps(n, 0), empty(empty) {}
+
+    /**
+     * Gets an entry.
+     * Complexity: O(1)
+     * @param i Index of the entry
+     * @return The value written in the current epoch, or the default value
+     */
+    V get(int i) const {
+        return stamps[i] == epoch ? values[i] : empty;
+    }
+
+    /**
+     * Checks if an entry was written in the current epoch.
+     * Complexity: O(1)
+     * @param i Index of the entry
+     * @return true if the entry was written
+     */
+    bool has(int i) const {
+        return stamps[i] == epoch;
+    }
+
+    /**
+     * Writes an entry.
+     * Complexity: O(1)
+     * @param i Index of the entry
+     * @param value New value
+     */
+    void set(int i, V value) {
+        values[i] = value;
+        stamps[i] = epoch;
+    }
+
+    /**
+     * Resets every entry to the default value.
+     * Complexity: O(1) (O(n) once every 2^32 clears)
+     */
+    void clear() {
+        if(++epoch == 0){
+            //the stamps wrapped around: clears them so old entries aren't taken as current
+            std::fill(stamps.begin(), stamps.end(), 0);
+            epoch = 1;
+        }
+    }
+
+private:
+    std::vector<V> values;
+    std::vector<uint32_t> stamps;
+    uint32_t epoch = 1;
+    V empty = V();
+};
+
+/**
+ * \class SearchRun
+ * Statistics and time budget of one run of a search. The TSP object only holds its settings, so runs on the
+ * same graph at the same time don't share any of this.
+ */
+class SearchRun {
+public:
+    /**
+     * Starts a run, with its time budget counted from now.
+     * Complexity: O(1)
+     * @param timeBudget Seconds the run may take (0 for no limit)
+     */
+    explicit SearchRun(double timeBudget) : limited(timeBudget > 0),
+        deadline(std::chrono::high_resolution_clock::now() + std::chrono::duration_cast<std::chrono::high_resolution_clock::duration>(std::chrono::duration<double>(timeBudget))) {}
+
+    /**
+     * Checks if the time budget has ended. The clock is only read once every 1024 calls, so it can be called for
+     * every node of a search; once it ends, timedOut is set.
+     * Only the thread of the run may call it (see clockExpired for the threads of a parallel run).
+     * Complexity: O(1)
+     * @return true if the search must stop
+     */
+    bool budgetExceeded() {
+        if(timedOut) return true;
+        if(!limited || (++checks & 1023) != 0) return false;
+        timedOut = std::chrono::high_resolution_clock::now() >= deadline;
+        return timedOut;
+    }
+
+    /**
+     * Checks if the time budget has ended, reading the clock. Changes nothing, so any thread can call it.
+     * Complexity: O(1)
+     * @return true if there is a budget and it has ended
+     */
+    bool clockExpired() const {
+        return limited && std::chrono::high_resolution_clock::now() >= deadline;
+    }
+
+    SearchStats stats;
+    bool timedOut = false;
+
+private:
+    bool limited;
+    std::chrono::high_resolution_clock::time_point deadline;
+    unsigned int checks = 0;
+};
+
+#endif //PROJECT2_SOLVERSTATE_H
@@ -0,0 +1,208 @@
+//
+// Created by lucas on 19/10/2026.
+//
+
+#include "SpatialGrid.h"
+#include <algorithm>
+#include <cmath>
+
+using namespace std;
+
+/**
+ * @file SpatialGrid.cpp
+ * @brief Implementation of class SpatialGrid and of the convex hull over the same projection.
+ */
+
+/**
+ * Projects coordinates to a plane: x is the longitude scaled by the cosine of the mean latitude, y the latitude.
+ * Complexity: O(n)
+ * @param nodes Points
+ * @param x Where the x coordinates are stored
+ * @param y Where the y coordinates are stored
+ */
+void projectCoordinates(const vector<NodeInfo> &nodes, vector<double> &x, vector<double> &y) {
+    double meanLatitude = 0;
+    for(const NodeInfo &node : nodes) meanLatitude += node.getLatitude();
+    if(!nodes.empty()) meanLatitude /= (double) nodes.size();
+    double scale = cos(meanLatitude * M_PI / 180);
+
+    x.resize(nodes.size());
+    y.resize(nodes.size());
+    for(size_t i = 0; i < nodes.size(); i++){
+        x[i] = nodes[i].getLongitude() * scale;
+        y[i] = nodes[i].getLatitude();
+    }
+}
+
+/**
+ * Creates an empty grid over the points (see insert).
+ * Complexity: O(n)
+ * @param nodes Points, numbered by their position
+ */
+SpatialGrid::SpatialGrid(const vector<NodeInfo> &nodes) : slot(nodes.size(), -1) {
+    projectCoordinates(nodes, x, y);
+    int n = (int) nodes.size();
+    if(n == 0) return;
+
+    minX = *min_element(x.begin(), x.end());
+    minY = *min_element(y.begin(), y.end());
+    double width = *max_element(x.begin(), x.end()) - minX;
+    double height = *max_element(y.begin(), y.end()) - minY;
+
+    //about two points per cell
+    double cellsWanted = max(1.0, n / 2.0);
+    if(width > 0 && height > 0) side = sqrt(width * height / cellsWanted);
+    else if(width > 0 || height > 0) side = max(width, height) / cellsWanted;
+    if((width / side + 1) * (height / side + 1) > 4 * cellsWanted) side = max(width, height) / cellsWanted; //a thin strip
+    columns = (int) (width / side) + 1;
+    rows = (int) (height / side) + 1;
+    cells.resize((size_t) columns * rows);
+}
+
+/**
+ * Gets the cell of a point.
+ * Complexity: O(1)
+ * @param v Point
+ * @return Index of the cell in cells
+ */
+int SpatialGrid::cellOf(int v) const {
+    int i = min(columns - 1, (int) ((x[v] - minX) / side));
+    int j = min(rows - 1, (int) ((y[v] - minY) / side));
+    return j * columns + i;
+}
+
+/**
+ * Adds a point to the grid (nothing happens if it is already there).
+ * Complexity: O(1)
+ * @param v Point
+ */
+void SpatialGrid::insert(int v) {
+    if(slot[v] != -1) return;
+    vector<int> &cell = cells[cellOf(v)];
+    slot[v] = (int) cell.size();
+    cell.push_back(v);
+    count++;
+}
+
+/**
+ * Removes a point from the grid (nothing happens if it isn't there).
+ * Complexity: O(1)
+ * @param v Point
+ */
+void SpatialGrid::erase(int v) {
+    if(slot[v] == -1) return;
+    vector<int> &cell = cells[cellOf(v)];
+    int last = cell.back();
+    cell[slot[v]] = last;
+    slot[last] = slot[v];
+    cell.pop_back();
+    slot[v] = -1;
+    count--;
+}
+
+/**
+ * Checks if a point is in the grid.
+ * Complexity: O(1)
+ * @param v Point
+ * @return true if v is in the grid
+ */
+bool SpatialGrid::contains(int v) const {
+    return slot[v] != -1;
+}
+
+/**
+ * Gets the number of points in the grid.
+ * Complexity: O(1)
+ * @return Number of points
+ */
+int SpatialGrid::size() const {
+    return count;
+}
+
+/**
+ * Calculates the distance between two points in the projection (in degrees of latitude).
+ * Complexity: O(1)
+ * @param u First point
+ * @param v Second point
+ * @return Distance
+ */
+double SpatialGrid::distance(int u, int v) const {
+    return hypot(x[u] - x[v], y[u] - y[v]);
+}
+
+/**
+ * Finds the points of the grid closest to a point (which doesn't need to be in the grid, and is never returned).
+ * The cells are visited in rings around the cell of v; the points of the ring r + 1 and beyond are at least
+ * r cells away, so the search ends once k points closer than that are known.
+ * Complexity: O(k log k) for evenly spread points
+ * @param v Point
+ * @param k Number of points wanted
+ * @param result Where the points are stored, closest first (fewer than k if the grid doesn't have them)
+ */
+void SpatialGrid::nearest(int v, int k, vector<int> &result) const {
+    result.clear();
+    if(k <= 0 || count == 0) return;
+    int ci = min(columns - 1, (int) ((x[v] - minX) / side));
+    int cj = min(rows - 1, (int) ((y[v] - minY) / side));
+
+    vector<pair<double, int>> found;
+    auto visit = [&](int i, int j){
+        if(i < 0 || j < 0 || i >= columns || j >= rows) return;
+        for(int w : cells[(size_t) j * columns + i]){
+            if(w != v) found.push_back({hypot(x[w] - x[v], y[w] - y[v]), w});
+        }
+    };
+
+    int maxRing = max(max(ci, columns - 1 - ci), max(cj, rows - 1 - cj));
+    for(int r = 0; r <= maxRing; r++){
+        if(r == 0) visit(ci, cj);
+        for(int i = ci - r; i <= ci + r && r > 0; i++){
+            visit(i, cj - r);
+            visit(i, cj + r);
+        }
+        for(int j = cj - r + 1; j < cj + r; j++){
+            visit(ci - r, j);
+            visit(ci + r, j);
+        }
+        if((int) found.size() >= k){
+            nth_element(found.begin(), found.begin() + (k - 1), found.end());
+            if(found[k - 1].first <= r * side) break;
+        }
+    }
+
+    size_t wanted = min(found.size(), (size_t) k);
+    partial_sort(found.begin(), found.begin() + wanted, found.end());
+    for(size_t i = 0; i < wanted; i++) result.push_back(found[i].second);
+}
+
+/**
+ * Calculates the convex hull of the points, in the projection of SpatialGrid (Andrew's monotone chain).
+ * Points on the edges of the hull are left out.
+ * Complexity: O(n log n)
+ * @param nodes Points
+ * @return Positions of the points of the hull, counterclockwise (fewer than 3 if the points are collinear)
+ */
+vector<int> convexHull(const vector<NodeInfo> &nodes) {
+    vector<double> x, y;
+    projectCoordinates(nodes, x, y);
+    int n = (int) nodes.size();
+    vector<int> points(n);
+    for(int i = 0; i < n; i++) points[i] = i;
+    sort(points.begin(), points.end(), [&x, &y](int a, int b){ return x[a] != x[b] ? x[a] < x[b] : y[a] < y[b]; });
+    if(n < 3) return points;
+
+    auto cross = [&x, &y](int o, int a, int b){ return (x[a] - x[o]) * (y[b] - y[o]) - (y[a] - y[o]) * (x[b] - x[o]); };
+    vector<int> hull(2 * (size_t) n);
+    int k = 0;
+    //lower chain, then upper chain
+    for(int i = 0; i < n; i++){
+        while(k >= 2 && cross(hull[k - 2], hull[k - 1], points[i]) <= 0) k--;
+        hull[k++] = points[i];
+    }
+    for(int i = n - 2, lower = k + 1; i >= 0; i--){
+        while(k >= lower && cross(hull[k - 2], hull[k - 1], points[i]) <= 0) k--;
+        hull[k++] = points[i];
+    }
+    hull.resize(k - 1);
+    return hull;
+}
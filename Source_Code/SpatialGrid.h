@@ -0,0 +1,47 @@
+//
+// Created by lucas on 19/10/2026.
+//
+
+#ifndef PROJECT2_SPATIALGRID_H
+#define PROJECT2_SPATIALGRID_H
+
+#include <vector>
+#include "NodeInfo.h"
+
+/**
+ * @file SpatialGrid.h
+ * @brief Definition of class SpatialGrid.
+ *
+ * \class SpatialGrid
+ * Uniform grid over the coordinates of a set of points, for nearest neighbour queries among the points currently
+ * in it (points come and go as a solver runs, e.g. the vertexes already in a tour). The coordinates are projected
+ * to a plane (longitude scaled by the cosine of the mean latitude), which keeps the order of the distances within
+ * a city or a region. The cells are sized for about two points each, so a query looks at a few cells around the
+ * point, widening ring by ring only while the nearest points found could still be beaten.
+ */
+class SpatialGrid {
+public:
+    explicit SpatialGrid(const std::vector<NodeInfo> &nodes);
+
+    void insert(int v);
+    void erase(int v);
+    bool contains(int v) const;
+    int size() const;
+    void nearest(int v, int k, std::vector<int> &result) const;
+    double distance(int u, int v) const;
+
+private:
+    int cellOf(int v) const;
+
+    std::vector<double> x, y;               // projected coordinates of every point
+    double minX = 0, minY = 0, side = 1;    // the cell (i, j) covers [minX + i * side, minX + (i + 1) * side) x ...
+    int columns = 1, rows = 1;
+    std::vector<std::vector<int>> cells;    // points in the grid, by cell
+    std::vector<int> slot;                  // position of each point in its cell (-1 if not in the grid)
+    int count = 0;
+};
+
+void projectCoordinates(const std::vector<NodeInfo> &nodes, std::vector<double> &x, std::vector<double> &y);
+std::vector<int> convexHull(const std::vector<NodeInfo> &nodes);
+
+#endif //PROJECT2_SPATIALGRID_H
@@ -3,9 +3,22 @@
 //
 
 #include "TSP.h"
+#include <algorithm>
+#include <atomic>
 #include <chrono>
 #include <cmath>
-#include "MutablePriorityQueue.h"
+#include <queue>
+#include "BacktrackingEngine.h"
+#include "Clustering.h"
+#include "Delaunay.h"
+#include "DistancePolicy.h"
+#include "HeldKarp.h"
+#include "InsertionHeuristics.h"
+#include "Ordering.h"
+#include "ShortestPaths.h"
+#include "SolverState.h"
+#include "ThreadPool.h"
+#include "TourHeuristics.h"
 
 using namespace std;
 /**
@@ -19,7 +32,7 @@ using namespace std;
  * Complexity: O(1)
  * @return Map with the id and node information
  */
-unordered_map<int, NodeInfo> TSP::getIdToNode() const{
+const unordered_map<int, NodeInfo> &TSP::getIdToNode() const{
     return idToNode;
 }
 
@@ -28,30 +41,260 @@ unordered_map<int, NodeInfo> TSP::getIdToNode() const{
  *  Complexity: O(1).
  * @return Graph
  */
-Graph<NodeInfo> TSP::getGraph() const{
+const Graph<NodeInfo> &TSP::getGraph() const{
     return graph;
 }
 
+/**
+ * Gets the array based index of the graph, building it the first time it is needed.
+ * Complexity: O(V log V + E log E) the first time, O(1) afterwards.
+ * @return Index of the current graph
+ */
+const GraphIndex &TSP::getIndex() const {
+    return *index.get([this](){ return make_shared<const GraphIndex>(graph, ordering); });
+}
+
+/**
+ * Gets the shortest path distance oracle of the graph, creating it (empty) the first time it is needed.
+ * It can be queried by several threads.
+ * Complexity: O(V log V + E log E) the first time, O(1) afterwards.
+ * @return Oracle of the current graph
+ */
+DistanceOracle &TSP::getOracle() const {
+    return *oracle.get([this](){ return make_shared<DistanceOracle>(getIndex(), oracleBytes, oracleSinglePrecision); });
+}
+
+/**
+ * Gets the contraction hierarchy of the graph, if enabled. The first time, it is loaded from the hierarchy file
+ * or, if the file is missing or belongs to another graph, built and saved there.
+ * Complexity: O(V + E) to load, see ContractionHierarchy to build, O(1) afterwards.
+ * @return The hierarchy, nullptr if disabled
+ */
+const ContractionHierarchy *TSP::getHierarchy() const {
+    if(!useHierarchy) return nullptr;
+    return hierarchy.get([this](){
+        const GraphIndex &g = getIndex();
+        shared_ptr<const ContractionHierarchy> loaded;
+        if(!hierarchyFile.empty()) loaded = ContractionHierarchy::load(hierarchyFile, g);
+        if(loaded == nullptr){
+            auto built = make_shared<const ContractionHierarchy>(g);
+            if(!hierarchyFile.empty() && !built->save(hierarchyFile)){
+                cerr << "Unable to save the contraction hierarchy to " << hierarchyFile << "\n";
+            }
+            loaded = built;
+        }
+        hierarchyQuery = make_shared<ContractionHierarchy::Query>(*loaded);
+        return loaded;
+    });
+}
+
+/**
+ * Gets the matrix of the edge weights, building it the first time it is needed. Only dense graphs (at least half
+ * of the possible edges) get one: for them it is much faster than findEdge and, being packed, it takes half of the
+ * memory of a square matrix (a quarter with TSP_MATRIX_VALUE float or uint32, whose distances are rounded).
+ * The pairs without an edge are infinite (see getCompleteMatrix).
+ * Complexity: O(V^2 + E) the first time, O(1) afterwards.
+ * @return The matrix, nullptr if the graph is sparse
+ */
+const SolverDistanceMatrix *TSP::getEdgeMatrix() const {
+    const GraphIndex &g = getIndex();
+    if(g.numEdges() < (size_t) g.size() * (g.size() - 1) / 2) return nullptr;
+    return edgeMatrix.get([this, &g](){
+        auto matrix = make_shared<const SolverDistanceMatrix>(buildEdgeMatrix<SolverDistanceMatrix>(g));
+        edgeMatrixComplete = true;
+        for(int u = 0; u < g.size() && edgeMatrixComplete; u++){
+            for(int v = u + 1; v < g.size(); v++){
+                if((*matrix)(u, v) == GraphIndex::infinity()){
+                    edgeMatrixComplete = false;
+                    break;
+                }
+            }
+        }
+        return matrix;
+    });
+}
+
+/**
+ * Gets the matrix of the edge weights when every pair of vertexes has an edge, so it gives the distances the
+ * heuristics compare; a dense graph missing some edges must pay them with their shortest paths instead.
+ * Complexity: see getEdgeMatrix
+ * @return The matrix, nullptr if the graph is not complete
+ */
+const SolverDistanceMatrix *TSP::getCompleteMatrix() const {
+    const SolverDistanceMatrix *matrix = getEdgeMatrix();
+    return matrix != nullptr && edgeMatrixComplete ? matrix : nullptr;
+}
+
+/**
+ * Gets the shortest path distance between two vertexes, from the all-pairs matrix if calculated, from the
+ * contraction hierarchy if enabled or else from the distance oracle. When there is no route (different components), the straight line distance is used.
+ * Complexity: O(S log S) with the hierarchy (S the size of the search spaces), see DistanceOracle otherwise.
+ * @param u Index of the origin
+ * @param v Index of the destination
+ * @return Distance
+ */
+double TSP::roadDistance(int u, int v) const {
+    double distance;
+    if(graph.getMatrixSize() == getIndex().size()) distance = graph.getMatrixDist(u, v);
+    else if(getHierarchy() != nullptr){
+        lock_guard<mutex> lock(hierarchyQueryMutex);
+        distance = hierarchyQuery->distance(u, v);
+    }
+    else distance = getOracle().distance(u, v);
+    if(distance == GraphIndex::infinity()){
+        const NodeInfo &a = getIndex().info(u);
+        const NodeInfo &b = getIndex().info(v);
+        distance = WeightTraits<Weight>::fromMetres(haversine(a.getLatitude(), a.getLongitude(), b.getLatitude(), b.getLongitude()));
+    }
+    return distance;
+}
+
 // ========================================================= Setters ==================================================================================
 /**
- * Sets a new graph.
- * Complexity: O(1).
+ * Sets a new graph, taking it over (the previous one is freed).
+ * Complexity: O(V + E) to free the previous graph.
  * @param graph_ The new graph
  */
-void TSP::setGraph(const Graph<NodeInfo>& graph_) {
-    this->graph = graph_;
+void TSP::setGraph(Graph<NodeInfo> &&graph_) {
+    //the derived objects point into the current graph, so they go first
+    this->hierarchyQuery.reset();
+    this->hierarchy.reset();
+    this->candidates.reset();
+    this->edgeMatrix.reset();
+    this->oracle.reset();
+    this->index.reset();
+    this->lowerBound.reset();
+    this->graph = std::move(graph_);
 }
 
 /**
- * Sets the id to node map to a new one.
+ * Sets the id to node map to a new one, taking it over.
  * Complexity: O(1).
  * @param idToNode_ The new map
  */
-void TSP::setIdToNode(const unordered_map<int, NodeInfo>& idToNode_) {
-    this->idToNode = idToNode_;
+void TSP::setIdToNode(unordered_map<int, NodeInfo> &&idToNode_) {
+    this->idToNode = std::move(idToNode_);
+}
+
+/**
+ * Sets how many threads the preprocessing stages (e.g. the shortest path distances) may use.
+ * Complexity: O(1).
+ * @param threads_ Number of threads (0 for one per hardware thread)
+ */
+void TSP::setThreads(unsigned int threads_) {
+    this->threads = threads_ == 0 ? ThreadPool::defaultThreads() : threads_;
+}
+
+/**
+ * Sets how much memory the shortest path distance oracle may use (the cached rows are dropped).
+ * Complexity: O(1).
+ * @param maxBytes Memory for the cached rows
+ * @param singlePrecision If the rows are stored as float (twice as many rows fit)
+ */
+void TSP::setDistanceCache(size_t maxBytes, bool singlePrecision) {
+    this->oracleBytes = maxBytes;
+    this->oracleSinglePrecision = singlePrecision;
+    this->oracle.reset();
+}
+
+/**
+ * Sets how the index numbers the vertexes (see Ordering.h). Everything built over the index is dropped, and the
+ * all-pairs matrix, if calculated, is calculated again in the new order.
+ * Complexity: O(1), or see computeAllPairs.
+ * @param ordering_ The ordering
+ */
+void TSP::setOrdering(VertexOrdering ordering_) {
+    if(ordering_ == this->ordering) return;
+    this->ordering = ordering_;
+    this->hierarchyQuery.reset();
+    this->hierarchy.reset();
+    this->candidates.reset();
+    this->edgeMatrix.reset();
+    this->oracle.reset();
+    this->index.reset();
+    if(graph.getMatrixSize() > 0) computeAllPairs();
+}
+
+/**
+ * Calculates the shortest paths between every pair of vertexes (Floyd-Warshall) and keeps them in the graph,
+ * with the rows in the order of the index, so roadDistance reads them directly.
+ * Meant for graphs up to a few thousand vertexes (the matrixes take 12 * V^2 bytes).
+ * Complexity: O(V^3 / T) where T is the number of threads.
+ */
+void TSP::computeAllPairs() {
+    const GraphIndex &g = getIndex();
+    vector<Vertex<NodeInfo> *> order(g.size());
+    for(int i = 0; i < g.size(); i++) order[i] = g.vertex(i);
+    graph.floydWarshall(order, threads);
+}
+
+/**
+ * Enables the contraction hierarchy for the shortest path distances (instead of the distance oracle).
+ * Complexity: O(1).
+ * @param enabled If the hierarchy is used
+ * @param file Where the hierarchy is loaded from / saved to (empty to build it without saving)
+ */
+void TSP::setHierarchy(bool enabled, const string &file) {
+    this->useHierarchy = enabled;
+    this->hierarchyFile = file;
+    this->hierarchyQuery.reset();
+    this->hierarchy.reset();
+}
+
+/**
+ * Enables the lower bound of the results (see withLowerBound) and the early stop of the time budgeted searches
+ * (backtracking and the 2-opt heuristics) once their cycle is close enough to it.
+ * Complexity: O(1).
+ * @param enabled If the results get the lower bound
+ * @param targetGap_ Relative gap to the bound at which the searches stop (e.g. 0.02 for 2%, 0 to never stop early)
+ */
+void TSP::setLowerBound(bool enabled, double targetGap_) {
+    this->reportBound = enabled;
+    this->targetGap = targetGap_;
 }
 
 // ===================================================== DISPLAY FUNCTIONS ======================================================================
+/**
+ * Displays the result of an algorithm: the path found (and the route driven, if added by withRoute) or the reason
+ * why there is none, followed by the search statistics (when they were collected).
+ * Complexity: O(n) where n is the number of vertexes.
+ * @param result Result of the algorithm
+ */
+void TSP::displayResult(const TSPResult &result) const {
+    if(result.found){
+        displayPathFound(result.cost, result.path, result.time);
+        if(result.cycleFrom != -1){
+            cout << "Cycle found from vertex " << result.cycleFrom << " and rotated to this start\n";
+        }
+    }
+    else{
+        displayNoSolution(result.error);
+    }
+
+    if(!result.route.empty()){
+        cout << "Route driven (the steps without an edge follow their shortest path):\n";
+        for(const NodeInfo &info : result.route) cout << info.getId() << '\n';
+        cout << '\n';
+    }
+
+    if(result.timedOut){
+        cout << "The time budget ended before the search finished\n";
+    }
+
+    if(result.lowerBound > 0){
+        cout << "Lower bound: " << result.lowerBound << "\n";
+    }
+
+    if(result.gap() >= 0){
+        cout << "Gap: " << 100 * result.gap() << "%\n";
+    }
+
+    if(!result.stats.empty()){
+        result.stats.print(cout);
+        cout << "\n";
+    }
+}
+
 /**
  * Displays the results obtained by the algorithms.
  * Complexity: O(n) where n is the number of vertexes.
@@ -71,11 +314,55 @@ void TSP::displayPathFound(double minWeight, const vector<NodeInfo>& solution, s
 
 }
 
+/**
+ * Expands a tour into the route really driven: every step between two vertexes that are not connected by an edge
+ * (the heuristics pay their shortest path distance) is replaced by the vertexes of that shortest path.
+ * Complexity: O(s * E log E) where s is the number of steps without an edge.
+ * @param tour Tour found by an algorithm
+ * @return Route with every step being an edge of the graph
+ */
+vector<NodeInfo> TSP::expandRoute(const vector<NodeInfo> &tour) const {
+    const GraphIndex &g = getIndex();
+    vector<NodeInfo> route;
+    for(size_t i = 0; i < tour.size(); i++){
+        if(i == 0){
+            route.push_back(tour[i]);
+            continue;
+        }
+        int u = g.indexOf(tour[i - 1].getId());
+        int v = g.indexOf(tour[i].getId());
+        vector<int> path;
+        if(u != -1 && v != -1 && !g.hasEdge(u, v)) path = shortestPath(g, u, v);
+
+        if(path.size() > 2){
+            for(size_t k = 1; k < path.size(); k++) route.push_back(g.info(path[k]));
+        }
+        else{
+            route.push_back(tour[i]);
+        }
+    }
+    return route;
+}
+
+/**
+ * Adds to a result the route really driven (see expandRoute), when some step of its path has no edge: that is
+ * the route whose cost the heuristics report.
+ * Complexity: see expandRoute
+ * @param result Result of an algorithm
+ * @return The result with the route (left empty if every step of the path is an edge)
+ */
+TSPResult TSP::withRoute(TSPResult result) const {
+    if(!result.found) return result;
+    vector<NodeInfo> route = expandRoute(result.path);
+    if(route.size() != result.path.size()) result.route = std::move(route);
+    return result;
+}
+
 /**
  * Displays a error message to the user
  * @param error error number
  */
-void TSP::displayNoSolution(int error) {
+void TSP::displayNoSolution(int error) const {
     switch (error) {
         case 1:
             cout << "That vertex does not exist" << "\n";
@@ -91,87 +378,65 @@ void TSP::displayNoSolution(int error) {
 
 // ================================================================== BACKTRACKING SOLUTION ==========================================================================
 /**
- * DFS for seeking the best solution for the TSP problem.
+ * Searches the best cycle that extends a partial solution (see BacktrackingEngine).
+ * The cycle starts and ends in the first vertex of the prefix.
  * Complexity: O(N!) where n is number os vertexes.
- * @param v Starting vertex.
- * @param currentWeight Current calculated weight
- * @param minWeight The minimum weight calculated
- * @param currentSol The current solution found
- * @param bestSol The best solution found
- * @param count Counts the number of iterations taken
+ * @param prefix The partial solution, as vertex indexes (see getIndex)
+ * @param minWeight The minimum weight calculated (updated if a better cycle is found)
+ * @param bestSol The best solution found (updated, with the first vertex at both ends)
+ * @param timeBudget Seconds the search may take (0 for no limit)
  */
-void TSP::backtrackingSolutionDFS(Vertex<NodeInfo> *v, double currentWeight, double *minWeight, vector<NodeInfo> currentSol, vector<NodeInfo> *bestSol, int count, int finalID) const{
-    for(auto e: v->getAdj()){
-        Vertex<NodeInfo> *w = e->getDest();
-
-
-        if(currentWeight + e->getWeight() >= *minWeight){
-            //this path isn't the solution
-            continue;
-        }
-
-        if((size_t) count == graph.getVertexSet().size() && w->getInfo().getId() == finalID){
-            //found a solution
-            currentWeight += e->getWeight();
-            currentSol.push_back(w->getInfo());
-
-            if(currentWeight < *minWeight){
-                //found a better solution
-                *minWeight = currentWeight;
-                *bestSol = currentSol;
-            }
-        }
-
-
-        //if the node isn't visited continues the search with this node
-        if(!w->isVisited() && w->getInfo().getId() != 0){
-            w->setVisited(true);
-            currentSol.push_back(w->getInfo());
-            currentWeight += e->getWeight();
-            backtrackingSolutionDFS(w,currentWeight, minWeight, currentSol, bestSol, count + 1, finalID);
-
-            //eliminates the node from the solution for searching other solutions
-            currentWeight -= e->getWeight();
-            currentSol.erase(currentSol.end()--);
-        }
-
-
-
+void TSP::backtrackingSolutionDFS(const vector<int> &prefix, WeightSum *minWeight, vector<NodeInfo> *bestSol, double timeBudget) const{
+    if(prefix.empty()) return;
+    const GraphIndex &g = getIndex();
+    SearchRun run(timeBudget);
+    BacktrackingEngine engine(g);
+    if(engine.run(prefix, *minWeight, 0, [&run](){ return run.budgetExceeded(); }, run.stats)){
+        *minWeight = engine.bestCost();
+        bestSol->clear();
+        for(int u : engine.bestCycle()) bestSol->push_back(g.info(u));
+        bestSol->push_back(g.info(prefix[0]));
     }
-
-    v->setVisited(false);
 }
 
 /**
  * Calculates the backtracking solution for the TSP problem.
  * Complexity: O(N!) where n is number os vertexes.
+ * @param id Id of the vertex where the cycle starts and ends
+ * @param timeBudget Seconds the search may take (0 for no limit)
+ * @return Best cycle found
  */
-void TSP::backtrackingSolution(int id) const{
+TSPResult TSP::backtrackingSolution(int id, double timeBudget) const{
     auto clockStart= chrono::high_resolution_clock::now();
-    //reset the Graph
-    for(Vertex<NodeInfo> *v : graph.getVertexSet()){
-        v->setVisited(false);
-        v->setPath(nullptr);
-        v->setProcesssing(false);
-    }
-
-    //create auxiliary data
-    double currentWeight = 0;
-    double minWeight = ULONG_LONG_MAX;
-    NodeInfo info = idToNode.find(id)->second; //get the starting node info
-    Vertex<NodeInfo> *start = graph.findVertex(info); //find the starting node in the graph
-    vector<NodeInfo> currentSol {start->getInfo()};
-    vector<NodeInfo> bestSol;
-
+    SearchRun run(timeBudget);
 
     //executes the backtracking search
-    backtrackingSolutionDFS(start, currentWeight, &minWeight, currentSol, &bestSol, 1, id);
+    const GraphIndex &g = getIndex();
+    vector<NodeInfo> bestSol;
+    WeightSum minWeight = WeightTraits<WeightSum>::infinity();
+    int start = g.indexOf(id);
+    if(start != -1){
+        BacktrackingEngine engine(g);
+        double bound = targetBound();
+        auto stop = [this, &engine, &run, bound](){ return run.budgetExceeded() || gapReached((double) engine.bestCost(), bound); };
+        if(engine.run({start}, minWeight, 0, stop, run.stats)){
+            minWeight = engine.bestCost();
+            for(int v : engine.bestCycle()) bestSol.push_back(g.info(v));
+            bestSol.push_back(g.info(start));
+        }
+    }
 
     auto clockEnd= chrono::high_resolution_clock::now();
 
-    auto duration = clockEnd - clockStart;
-    //displays the results
-    displayPathFound(minWeight, bestSol, duration);
+    TSPResult result;
+    result.found = !bestSol.empty();
+    result.timedOut = run.timedOut;
+    result.error = bestSol.empty() ? 2 : 0;
+    result.cost = WeightTraits<Weight>::toMetres(minWeight);
+    result.path = bestSol;
+    result.time = clockEnd - clockStart;
+    result.stats = run.stats;
+    return result;
 }
 
 
@@ -182,59 +447,43 @@ void TSP::backtrackingSolution(int id) const{
 /**
  * Gets the pre-order-walk of the prim algorithm.
  * Complexity: O(E * log(V)) where E is the number of edges and V is the number of vertexes
- * @param v origin vertex
- * @param g graph
- * @return pre-order-walk of the prim algorithm
+ * @param g Index of the graph
+ * @param start Index of the origin vertex
+ * @return pre-order-walk of the prim algorithm (vertex indexes)
  */
-vector<Vertex<NodeInfo> * > getPrimMst(Vertex<NodeInfo> *v,Graph<NodeInfo> &g){
-    vector<Vertex<NodeInfo> * > mst;
-    if (g.getVertexSet().empty()) {
+vector<int> getPrimMst(const GraphIndex &g, int start){
+    vector<int> mst;
+    if (g.size() == 0) {
         return {};
     }
 
-    for(auto s : g.getVertexSet()) {
-        s->setDist(ULONG_LONG_MAX); // Set distance to infinity
-        s->setPath(nullptr); // Set path to null
-        s->setVisited(false); // Mark as not visited
-    }
+    //state of this run: the graph itself is never written
+    VisitedSet visited(g.size());
+    StampedArray<Weight> dist(g.size(), WeightTraits<Weight>::infinity());
 
     // Select the first vertex as the starting point
-    v->setDist(0); // Set distance of the starting vertex to 0
+    dist.set(start, 0);
 
-    // Priority queue to store vertices based on their distances
-    MutablePriorityQueue<Vertex<NodeInfo>> q;
-    q.insert(v);
+    // Priority queue to store vertices based on their distances (stale entries are skipped when extracted)
+    typedef pair<Weight, int> Entry;
+    priority_queue<Entry, vector<Entry>, greater<Entry>> q;
+    q.push({0, start});
 
     // Main loop for the Prim's algorithm
     while(!q.empty()) {
         // Extract the vertex with the minimum distance from the priority queue
-        auto a = q.extractMin();
-        a->setVisited(true); // Mark the vertex as visited
+        int a = q.top().second;
+        q.pop();
+        if (visited.test(a)) continue;
+        visited.set(a); // Mark the vertex as visited
         mst.push_back(a);
 
         // Iterate through the adjacent edges of the current vertex
-        for(auto &e : a->getAdj()) {
-            Vertex<NodeInfo>* w = e->getDest(); // Get the destination vertex of the edge
-
-            // Check if the destination vertex is not visited
-            if (!w->isVisited()) {
-                auto oldDist = w->getDist(); // Get the current distance of the destination vertex
-
-                // Check if the weight of the edge is less than the current distance of the destination vertex
-                if(e->getWeight() < oldDist) {
-                    w->setDist(e->getWeight()); // Update the distance of the destination vertex
-                    w->setPath(e); // Update the path to the current edge
-
-                    // If the destination vertex had infinite distance, insert it into the priority queue
-                    if (oldDist == ULONG_LONG_MAX) {
-                        q.insert(w);
-                    }
-
-                    // If the destination vertex had finite distance, decrease its key in the priority queue
-                    else {
-                        q.decreaseKey(w);
-                    }
-                }
+        for(const Neighbour *e = g.begin(a); e != g.end(a); e++) {
+            // Check if the destination vertex is not visited and the edge is lighter than its current distance
+            if (!visited.test(e->to) && e->weight < dist.get(e->to)) {
+                dist.set(e->to, e->weight);
+                q.push({e->weight, e->to});
             }
         }
 
@@ -281,390 +530,1092 @@ Edge<NodeInfo> * findEdge(Vertex<NodeInfo> * first,Vertex<NodeInfo> * second){
     return nullptr;
 }
 
+/**
+ * Calculates the cost of a walk over the index: each step is paid with its edge, or with its shortest path
+ * distance when there is none (see roadDistance).
+ * Complexity: O(V log E) for the steps with an edge, plus a shortest path search per distinct source without one
+ * @param walk Indexes of the vertexes, in order
+ * @return Cost, in graph units
+ */
+WeightSum TSP::walkCost(const vector<int> &walk) const {
+    const GraphIndex &g = getIndex();
+    WeightSum cost = 0;
+    vector<pair<int, int>> missing; //steps without an edge, paid with their shortest path distance
+    //O(1) edge weights on dense graphs, unless the matrix rounds them
+    const SolverDistanceMatrix *matrix = SolverDistanceMatrix::exact() ? getEdgeMatrix() : nullptr;
+
+    for(size_t i = 0; i + 1 < walk.size(); i++){
+        int first = walk[i];
+        int second = walk[i + 1];
+        double weight = matrix != nullptr ? (double) (*matrix)(first, second) : g.weight(first, second);
+        if(weight == GraphIndex::infinity()) missing.push_back({first, second});
+        else cost += weight;
+    }
+
+    if(!missing.empty()){
+        if(getHierarchy() == nullptr){
+            //the oracle rows are calculated in parallel beforehand
+            vector<int> sources;
+            for(const pair<int, int> &step : missing) sources.push_back(step.first);
+            getOracle().prefetch(sources, threads);
+        }
+        for(const pair<int, int> &step : missing){
+            cost += roadDistance(step.first, step.second);
+        }
+    }
+    return cost;
+}
+
 /**
  * Calculates the triangular approximation solution for the TSP problem.
+ * Consecutive vertexes of the walk that are not connected cost their shortest path distance (see expandRoute).
  * Complexity: O(v * E) where V is the number of vertexes and E is the number of edges
+ * @return Cycle found (error 1 if there is no vertex 0)
  */
-void TSP::triangularAproxSolution() {
+TSPResult TSP::triangularAproxSolution() {
 
     auto clockStart= chrono::high_resolution_clock::now();
 
-    NodeInfo info = idToNode.find(0)->second; //get the starting node info
-    Vertex<NodeInfo> *v = graph.findVertex(info);
-
-    vector<Vertex<NodeInfo> * > mst_pre_order = getPrimMst(v,graph);
+    TSPResult result;
+    const GraphIndex &g = getIndex();
+    int start = g.indexOf(0); //get the starting vertex
+    if(start == -1){
+        result.error = 1;
+        return result;
+    }
 
-    mst_pre_order.push_back(v);
+    vector<int> mst_pre_order = getPrimMst(g, start);
 
-    for (auto x : graph.getVertexSet()) x->setVisited(false);
+    mst_pre_order.push_back(start);
 
     vector<NodeInfo> res;
-    double cost = 0;
-
-    for (auto i = 0; i<mst_pre_order.size() - 1 ; i++){
-        Vertex<NodeInfo> * first = mst_pre_order[i];
-        Vertex<NodeInfo> * second = mst_pre_order[i+1];
-
-        res.push_back(first->getInfo());
-
-        Edge<NodeInfo> * edge = findEdge(first,second);
-
-        if(edge == nullptr){
-            auto weight =  haversine(first->getInfo().getLatitude(), first->getInfo().getLongitude(),second->getInfo().getLatitude(),second->getInfo().getLongitude());
-            cost += weight;
-        }
-
-        if (edge != nullptr) cost += edge->getWeight();
+    for (size_t i = 0; i + 1 < mst_pre_order.size(); i++){
+        res.push_back(g.info(mst_pre_order[i]));
     }
+    WeightSum cost = walkCost(mst_pre_order);
 
-    res.push_back(v->getInfo());
+    res.push_back(g.info(start));
 
 
     auto clockEnd= chrono::high_resolution_clock::now();
 
-    displayPathFound(cost, res, clockEnd-clockStart);
+    result.found = true;
+    result.cost = WeightTraits<Weight>::toMetres(cost);
+    result.path = res;
+    result.time = clockEnd - clockStart;
+    return result;
 }
 
 //========================================================== OTHER HEURISTIC =====================================================================================================
 /**
- * Gets the edge with the smallest cost from a given vertex.
+ * Gets the edge with the smallest cost from a given vertex to a vertex not visited yet.
  * Complexity: O(E) where E is the number of outgoing edges of v.
+ * @param g Index of the graph
  * @param v Vertex we are analysing
- * @return edge with the smallest cost
+ * @param visited Vertexes already in the path
+ * @param tried Edges that must be skipped (nullptr for none)
+ * @return edge with the smallest cost (nullptr if there is none)
  */
-Edge<NodeInfo>* getShortestEdge(Vertex<NodeInfo> *v){
-    double minWeight = LONG_LONG_MAX;
-    Edge<NodeInfo> * minEdge = nullptr;
-
-    for(Edge<NodeInfo> *e: v->getAdj()){
-        if((e->getWeight() < minWeight) && (!e->getDest()->isVisited())){
-            minEdge = e;
-            minWeight = e->getWeight();
+const Neighbour *getShortestEdge(const GraphIndex &g, int v, const VisitedSet &visited, const VisitedSet *tried = nullptr){
+    //the edges are sorted by weight, so the first one that can be used is the shortest
+    for(const Neighbour *e = g.begin(v); e != g.end(v); e++){
+        if(!visited.test(e->to) && (tried == nullptr || !tried->test(g.edgeId(e)))){
+            return e;
         }
     }
-
-
-    return minEdge;
+    return nullptr;
 }
 
 /**
- * Gets the smallest cost for a edge between given vertex and the unvisited nodes (only used if there is not possible to find a feasible outgoing edge in a not fully connected graphs)
- * Complexity: O(V) where v is the number of unvisited edges.
+ * Gets the closest unvisited vertex in a straight line (only used if there is not possible to find a feasible outgoing edge in a not fully connected graphs)
+ * Complexity: O(V) where v is the number of vertexes.
+ * @param g Index of the graph
  * @param v Vertex to analyse
- * @param g graph
- * @param unvisited unvisited nodes
- * @return smallest cost for a edge between given vertex and the unvisited nodes
+ * @param visited Vertexes already in the path
+ * @param distance Where the straight line distance (in graph units) is stored
+ * @return closest unvisited vertex (-1 if every vertex was visited)
  */
-Edge<NodeInfo> getShortestEdgeUnvisited(Vertex<NodeInfo> *v,Graph<NodeInfo> &g, unordered_map<int, NodeInfo> unvisited){
-    int minVertexIDX = INT_MAX;
-    double minDist = LONG_LONG_MAX;
-
-    for(pair<int, NodeInfo> intToNode: unvisited){
-        NodeInfo inf1 = v->getInfo();
-        NodeInfo inf2 = intToNode.second;
+int getShortestEdgeUnvisited(const GraphIndex &g, int v, const VisitedSet &visited, WeightSum &distance){
+    int minVertex = -1;
+    double minDist = numeric_limits<double>::infinity();
+    const NodeInfo &inf1 = g.info(v);
+
+    for(int u = 0; u < g.size(); u++){
+        if(visited.test(u)) continue;
+        const NodeInfo &inf2 = g.info(u);
         double dist = haversine(inf1.getLatitude(), inf1.getLongitude(), inf2.getLatitude(), inf2.getLongitude());
         if(dist < minDist){
             minDist = dist;
-            minVertexIDX = intToNode.first;
+            minVertex = u;
         }
     }
-    NodeInfo destInf = unvisited.find(minVertexIDX)->second;
-    Vertex<NodeInfo> *dest = g.findVertex(destInf);
+    distance = WeightTraits<Weight>::fromMetres(minDist);
+    return minVertex;
+}
+
+/**
+ * \struct WalkBuffers
+ * State of the nearest neighbour walks of one thread, reused from one start to the next.
+ */
+struct WalkBuffers {
+    explicit WalkBuffers(const GraphIndex &g) : visited(g.size()) {}
+
+    VisitedSet visited;
+    vector<char> marked;                // targets of the shortest path searches (created when first needed)
+    unique_ptr<DijkstraSearch> search;
+};
+
+/**
+ * Nearest neighbour walk from one start over the index. The edges of each vertex are sorted by weight, so the
+ * next vertex is usually found after a few of them. When the current vertex has no edge to an unvisited vertex,
+ * the closest unvisited vertex by shortest path distance is chosen (see expandRoute), and the cycle is closed the
+ * same way if there is no edge back.
+ * Complexity: O(V * k) where k is the number of visited neighbours skipped per step, plus a Dijkstra per missing edge.
+ * @param g Index of the graph
+ * @param start Index of the start vertex
+ * @param buffers State of the walk (reused)
+ * @param tour Where the vertexes of the walk are stored (without the return to the start)
+ * @return Cost of the cycle, in graph units
+ */
+static WeightSum nearestNeighbourWalk(const GraphIndex &g, int start, WalkBuffers &buffers, vector<int> &tour) {
+    int n = g.size();
+    VisitedSet &visited = buffers.visited;
+    visited.clear();
+    bool marksValid = false;
+    tour.clear();
+    tour.push_back(start);
+    visited.set(start);
+    WeightSum cost = 0;
+    int v = start;
+
+    //check for the closest neighbor and inserts it into the path
+    while(visited.size() < n){
+        const Neighbour *e = getShortestEdge(g, v, visited);
 
-    Edge<NodeInfo> e {v, dest, minDist};
+        //there is no edge to an unvisited vertex: goes to the closest one by shortest path
+        if(e == nullptr){
+            if(buffers.search == nullptr) buffers.search.reset(new DijkstraSearch(g));
+            if(!marksValid){
+                buffers.marked.assign(n, 0);
+                for(int u = 0; u < n; u++) buffers.marked[u] = !visited.test(u);
+                marksValid = true;
+            }
+            double distance = 0;
+            int next = nearestMarked(*buffers.search, v, buffers.marked, distance);
+            if(next != -1){
+                cost += distance;
+                v = next;
+            }
+            else{
+                //different components: the straight line is the only estimate
+                WeightSum straight = 0;
+                v = getShortestEdgeUnvisited(g, v, visited, straight);
+                cost += straight;
+            }
+        }
+        //a path was found
+        else {
+            cost += e->weight;
+            v = e->to;
+        }
+
+        tour.push_back(v);
+        visited.set(v);
+        if(marksValid) buffers.marked[v] = 0;
+    }
 
-    return e;
+    //connects the final node of the tour to the start
+    double closing = g.weight(v, start);
+    if(closing == GraphIndex::infinity() && v != start){
+        if(buffers.search == nullptr) buffers.search.reset(new DijkstraSearch(g));
+        buffers.marked.assign(n, 0);
+        buffers.marked[start] = 1;
+        if(nearestMarked(*buffers.search, v, buffers.marked, closing) == -1){
+            const NodeInfo &a = g.info(v), &b = g.info(start);
+            closing = WeightTraits<Weight>::fromMetres(haversine(a.getLatitude(), a.getLongitude(), b.getLatitude(), b.getLongitude()));
+        }
+    }
+    if(v != start) cost += closing;
+    return cost;
 }
 
 /**
- * Calculates the TSP using other heuristics.
+ * Calculates the TSP using other heuristics (nearest neighbour from vertex 0, see nearestNeighbourWalk).
  * Complexity: O(V*E) where V is the number of vertexes and E is the number of edges.
+ * @return Cycle found (error 1 if there is no vertex 0)
  */
-void TSP::otherHeuristic() {
+TSPResult TSP::otherHeuristic() {
     auto clockStart= chrono::high_resolution_clock::now();
 
-    //initialize the variables
-    NodeInfo info = idToNode.find(0)->second; //get the starting node info
-    Vertex<NodeInfo> *v = graph.findVertex(info);
+    TSPResult result;
+    const GraphIndex &g = getIndex();
+    int start = g.indexOf(0); //get the starting vertex
+    if(start == -1){
+        result.error = 1;
+        return result;
+    }
+    WalkBuffers buffers(g);
+    vector<int> tour;
+    WeightSum cost = nearestNeighbourWalk(g, start, buffers, tour);
 
-    unordered_map<int, NodeInfo> unvisited = idToNode;
     vector<NodeInfo> res;
-    res.push_back(v->getInfo());
-    unvisited.erase(0);
-    double cost = 0;
+    for(int v : tour) res.push_back(g.info(v));
+    res.push_back(g.info(start));
+
+    auto clockEnd= chrono::high_resolution_clock::now();
 
+    result.found = true;
+    result.cost = WeightTraits<Weight>::toMetres(cost);
+    result.path = res;
+    result.time = clockEnd - clockStart;
+    return result;
+}
 
-    //reset the graph
-    for(auto s : graph.getVertexSet()) {
-        s->setDist(ULONG_LONG_MAX); // Set distance to infinity
-        s->setPath(nullptr); // Set path to null
-        s->setVisited(false); // Mark as not visited
+/**
+ * Nearest neighbour from every vertex, in parallel: each thread walks its share of the starts with its own
+ * buffers, and the cheapest cycle is rotated to start at the requested vertex (a cycle visits every vertex).
+ * With a time budget, the starts not yet walked when it ends are skipped.
+ * Complexity: O(V^2 * k / T) where k is the number of visited neighbours skipped per step and T the number of threads.
+ * @param id Id of the vertex where the cycle must start
+ * @param timeBudget Seconds the search may take (0 for no limit)
+ * @return Cheapest cycle found (error 1 if the vertex doesn't exist)
+ */
+TSPResult TSP::multiStartNearestNeighbour(int id, double timeBudget) {
+    auto clockStart = chrono::high_resolution_clock::now();
+    SearchRun run(timeBudget);
+    TSPResult result;
+
+    const GraphIndex &g = getIndex();
+    int depot = g.indexOf(id);
+    if(depot == -1){
+        result.error = 1;
+        return result;
+    }
+    int n = g.size();
+
+    //each thread keeps its best cycle; ties go to the smallest start, so the result doesn't depend on the scheduling
+    unsigned int workers = (unsigned int) min<size_t>(threads, (size_t) n);
+    vector<vector<int>> bestTours(workers);
+    vector<WeightSum> bestCosts(workers, WeightTraits<WeightSum>::infinity());
+    vector<int> bestStarts(workers, n);
+    atomic<int> next(0);
+    atomic<int> walked(0);
+    atomic<bool> expired(false);
+    {
+        ThreadPool pool(workers);
+        for(unsigned int t = 0; t < workers; t++){
+            pool.submit([&, t](){
+                WalkBuffers buffers(g);
+                vector<int> tour;
+                for(int s = next++; s < n; s = next++){
+                    if(run.clockExpired()){
+                        expired = true;
+                        break;
+                    }
+                    WeightSum cost = nearestNeighbourWalk(g, s, buffers, tour);
+                    walked++;
+                    if(cost < bestCosts[t] || (cost == bestCosts[t] && s < bestStarts[t])){
+                        bestCosts[t] = cost;
+                        bestStarts[t] = s;
+                        bestTours[t] = tour;
+                    }
+                }
+            });
+        }
+        pool.wait();
     }
 
-    v->setVisited(true);
+    unsigned int best = 0;
+    for(unsigned int t = 1; t < workers; t++){
+        if(bestCosts[t] < bestCosts[best] || (bestCosts[t] == bestCosts[best] && bestStarts[t] < bestStarts[best])) best = t;
+    }
+    TSP_STAT(run.stats.startsWalked = walked);
+    result.timedOut = expired;
+    result.stats = run.stats;
+    if(bestTours[best].empty()){
+        result.error = 2;
+        return result;
+    }
 
-    //check for the closest neighbor and inserts it into the path
-    while(res.size() < graph.getVertexSet().size()){
-        Edge<NodeInfo> *e = getShortestEdge(v);
+    //rotates the cycle so that it starts in the requested vertex
+    const vector<int> &tour = bestTours[best];
+    int first = (int) (find(tour.begin(), tour.end(), depot) - tour.begin());
+    for(int k = 0; k <= n; k++) result.path.push_back(g.info(tour[(first + k) % n]));
+    result.found = true;
+    result.cost = WeightTraits<Weight>::toMetres(bestCosts[best]);
+    if(g.idOf(bestStarts[best]) != id) result.cycleFrom = g.idOf(bestStarts[best]);
+    result.time = chrono::high_resolution_clock::now() - clockStart;
+    return result;
+}
 
-        //there is no possible path (calculate the dist for paths that are not connected and are not visited)
-        if(e == nullptr){
-           Edge<NodeInfo> e2 = getShortestEdgeUnvisited(v, graph, unvisited);
-           cost += e2.getWeight();
-           v = e2.getDest();
+//========================================================== IMPROVED HEURISTIC ==================================================================================
+/**
+ * Orders the vertexes along a Hilbert curve over their coordinates (see hilbertOrder), rotated to begin at the
+ * start. Close points are close on the curve, so the order is a tour without long detours, built with a sort.
+ * Complexity: O(V log V)
+ * @param g Index of the graph
+ * @param start Index of the first vertex
+ * @return The tour
+ */
+static vector<int> hilbertTour(const GraphIndex &g, int start) {
+    vector<NodeInfo> nodes;
+    nodes.reserve(g.size());
+    for(int v = 0; v < g.size(); v++) nodes.push_back(g.info(v));
+    vector<int> tour = hilbertOrder(nodes);
+    rotate(tour.begin(), find(tour.begin(), tour.end(), start), tour.end());
+    return tour;
+}
+
+/**
+ * \struct CandidateEdge
+ * Edge that may be taken by the greedy edge construction.
+ */
+struct CandidateEdge {
+    Weight weight;
+    int u, v; // u < v
+
+    bool operator<(const CandidateEdge &other) const {
+        if(weight != other.weight) return weight < other.weight;
+        return u != other.u ? u < other.u : v < other.v;
+    }
+    bool operator==(const CandidateEdge &other) const {
+        return u == other.u && v == other.v;
+    }
+};
+
+/**
+ * Gets the candidate edges of the greedy edge construction: the GREEDY_CANDIDATES lightest edges of each vertex
+ * (every edge, on graphs that aren't denser than that), each undirected edge once, by increasing weight. The
+ * edges are split in blocks sorted by the threads and then merged.
+ * Complexity: O(C log C) where C = V * GREEDY_CANDIDATES, divided by the threads up to the merges
+ * @param g Index of the graph
+ * @param threads Number of threads of the sort
+ * @return The candidates, as pairs of vertex indexes
+ */
+static vector<pair<int, int>> greedyCandidates(const GraphIndex &g, unsigned int threads) {
+    vector<CandidateEdge> edges;
+    for(int u = 0; u < g.size(); u++){
+        int taken = 0;
+        for(const Neighbour *e = g.begin(u); e != g.end(u) && taken < GREEDY_CANDIDATES; e++){
+            if(e->to == u) continue;
+            edges.push_back({e->weight, min(u, e->to), max(u, e->to)});
+            taken++;
         }
-        //a path was found
-        else {
-            cost += e->getWeight();
-            v = e->getDest();
+    }
+
+    size_t blocks = max<size_t>(1, min<size_t>(threads, edges.size() / 4096));
+    vector<size_t> bounds;
+    for(size_t b = 0; b <= blocks; b++) bounds.push_back(edges.size() * b / blocks);
+    if(blocks > 1){
+        ThreadPool pool((unsigned int) blocks);
+        for(size_t b = 0; b < blocks; b++){
+            pool.submit([&edges, &bounds, b](){ sort(edges.begin() + bounds[b], edges.begin() + bounds[b + 1]); });
         }
+        pool.wait();
+        //merges neighbouring blocks, doubling their size each round
+        for(size_t width = 1; width < blocks; width *= 2){
+            for(size_t b = 0; b + width < blocks; b += 2 * width){
+                size_t last = min(b + 2 * width, blocks);
+                inplace_merge(edges.begin() + bounds[b], edges.begin() + bounds[b + width], edges.begin() + bounds[last]);
+            }
+        }
+    }
+    else{
+        sort(edges.begin(), edges.end());
+    }
+    edges.erase(unique(edges.begin(), edges.end()), edges.end());
+
+    vector<pair<int, int>> candidates;
+    candidates.reserve(edges.size());
+    for(const CandidateEdge &e : edges) candidates.push_back({e.u, e.v});
+    return candidates;
+}
 
-        res.push_back(v->getInfo());
-        v->setVisited(true);
-        unvisited.erase(v->getInfo().getId());
+/**
+ * Gets the coordinates of the vertexes for the spatial searches (insertion heuristics, 2-opt neighbour lists).
+ * Complexity: O(V)
+ * @param g Index of the graph
+ * @return Coordinates by index (empty if the vertexes have none)
+ */
+static vector<NodeInfo> indexCoordinates(const GraphIndex &g) {
+    vector<NodeInfo> nodes;
+    nodes.reserve(g.size());
+    for(int v = 0; v < g.size(); v++) nodes.push_back(g.info(v));
+    if(!hasCoordinates(nodes)) nodes.clear();
+    return nodes;
+}
+
+/**
+ * Gets the neighbour lists of 2-opt on large tours: the TWO_OPT_CANDIDATES lightest edges of each vertex and,
+ * with coordinates, its neighbours in the Delaunay triangulation plus its QUADRANT_CANDIDATES closest vertexes in each
+ * quadrant around it (which covers the vertexes with few edges, without looking at every pair).
+ * Complexity: O(V * TWO_OPT_CANDIDATES) plus O(V log V) for the triangulation
+ * @param g Index of the graph
+ * @param nodes Coordinates of the vertexes, by index (empty if there are none)
+ * @return The candidates of each vertex
+ */
+static vector<vector<int>> neighbourCandidates(const GraphIndex &g, const vector<NodeInfo> &nodes) {
+    vector<vector<int>> candidates(g.size());
+    for(int v = 0; v < g.size(); v++){
+        for(const Neighbour *e = g.begin(v); e != g.end(v) && (int) candidates[v].size() < TWO_OPT_CANDIDATES; e++){
+            if(e->to != v && find(candidates[v].begin(), candidates[v].end(), e->to) == candidates[v].end()) candidates[v].push_back(e->to);
+        }
+    }
+    if(!nodes.empty()){
+        vector<vector<int>> near = delaunayNeighbours(nodes);
+        addQuadrantNeighbours(nodes, QUADRANT_CANDIDATES, near);
+        for(int v = 0; v < g.size(); v++){
+            for(int u : near[v]){
+                if(find(candidates[v].begin(), candidates[v].end(), u) == candidates[v].end()) candidates[v].push_back(u);
+            }
+        }
     }
+    return candidates;
+}
 
-    //connects the final node of the tour to the edge
-    NodeInfo infoFinal = res.back();
-    Vertex<NodeInfo> *finalVertex = graph.findVertex(infoFinal);
-    Vertex<NodeInfo> *firstVertex = graph.findVertex(info);
+/**
+ * Gets the neighbour lists of the local search on large tours, calculated the first time they are needed:
+ * on complete graphs, the TWO_OPT_CANDIDATES alpha-nearest vertexes of each vertex over the minimum 1-tree
+ * (see alphaCandidates), which keep more of the optimal edges than the lightest ones; otherwise, where every row
+ * of the shortest path distances would cost a search, the lightest edges and closest vertexes (see neighbourCandidates).
+ * Complexity: O(V^2) distance evaluations on complete graphs the first time, O(1) afterwards.
+ * @return The candidates of each vertex, by index
+ */
+const vector<vector<int>> &TSP::getCandidates() const {
+    return *candidates.get([this](){
+        const GraphIndex &g = getIndex();
+        if(getCompleteMatrix() != nullptr) return make_shared<const vector<vector<int>>>(alphaCandidates(MatrixDistance(*getCompleteMatrix()), TWO_OPT_CANDIDATES));
+        return make_shared<const vector<vector<int>>>(neighbourCandidates(g, indexCoordinates(g)));
+    });
+}
 
-    Edge<NodeInfo> *e = findEdge(finalVertex, firstVertex);
+/**
+ * Builds a tour (nearest neighbour, spanning tree walk, greedy edge, Hilbert curve or insertion) and, if asked,
+ * improves it with 2-opt, with a given distance.
+ * Complexity: O(V^2) distance evaluations per 2-opt pass
+ * @tparam Distance Distance policy (see DistancePolicy.h)
+ * @param d Distances
+ * @param start Index of the start vertex
+ * @param construction How the tour is built
+ * @param improve If the tour is improved with 2-opt
+ * @param run Statistics and time budget of the run
+ * @return Cycle found (error 2 if some step has no route)
+ */
+template <class Distance>
+TSPResult TSP::heuristicTour(const Distance &d, int start, TourConstruction construction, bool improve, SearchRun &run) const {
+    vector<int> tour;
+    switch(construction){
+        case TourConstruction::SPANNING_TREE:
+            tour = spanningTreeTour(d, start);
+            break;
+        case TourConstruction::SPACE_FILLING_CURVE:
+            tour = hilbertTour(getIndex(), start);
+            break;
+        case TourConstruction::GREEDY_EDGE:
+            tour = greedyEdgeTour(d, greedyCandidates(getIndex(), threads), start);
+            break;
+        case TourConstruction::CHEAPEST_INSERTION:
+            tour = cheapestInsertionTour(d, indexCoordinates(getIndex()), start);
+            break;
+        case TourConstruction::FARTHEST_INSERTION:
+            tour = farthestInsertionTour(d, indexCoordinates(getIndex()), start);
+            break;
+        case TourConstruction::CONVEX_HULL_INSERTION:
+            tour = convexHullInsertionTour(d, indexCoordinates(getIndex()), start);
+            break;
+        default:
+            tour = nearestNeighbourTour(d, start);
+    }
+    if(improve){
+        double bound = targetBound();
+        auto stop = [this, &run, bound](double cost){ return run.budgetExceeded() || gapReached(cost, bound); };
+        long long moves;
+        if((int) tour.size() > TWO_OPT_FULL_SIZE) moves = twoOptNeighbours(d, tour, getCandidates(), stop);
+        else moves = twoOpt(d, tour, stop);
+        TSP_STAT(run.stats.improvingMoves = moves);
+        (void) moves;
+    }
 
-    if(e == nullptr){
-        cost += haversine(infoFinal.getLatitude(), infoFinal.getLongitude(), info.getLatitude(), info.getLongitude());
+    TSPResult result;
+    if(tourCost(d, tour) == GraphIndex::infinity()){
+        result.error = 2;
+        return result;
     }
-    else{
-        cost += e->getWeight();
+    const GraphIndex &g = getIndex();
+    for(int v : tour) result.path.push_back(g.info(v));
+    result.path.push_back(g.info(start));
+    tour.push_back(start);
+    result.found = true;
+    result.cost = WeightTraits<Weight>::toMetres(walkCost(tour)); //the exact weights, not the distances compared
+    return result;
+}
+
+/**
+ * Builds a tour with a construction heuristic, and improves it with 2-opt if asked. The distance is chosen once,
+ * before the search: the edge matrix for complete graphs, else the contraction hierarchy if enabled, else the distance
+ * oracle (shortest paths, so steps without an edge are paid with their route, see expandRoute).
+ * Complexity: depends on the construction, plus O(V^2) distance evaluations per 2-opt pass
+ * @param id Id of the start vertex
+ * @param construction How the tour is built
+ * @param improve If the tour is improved with 2-opt
+ * @param timeBudget Seconds the search may take (0 for no limit)
+ * @return Cycle found (error 1 if the vertex doesn't exist, 2 if no cycle was found)
+ */
+TSPResult TSP::runHeuristic(int id, TourConstruction construction, bool improve, double timeBudget) {
+    auto clockStart = chrono::high_resolution_clock::now();
+    SearchRun run(timeBudget);
+
+    const GraphIndex &g = getIndex();
+    int start = g.indexOf(id);
+    TSPResult result;
+    if(start == -1){
+        result.error = 1;
+        return result;
     }
 
-    res.push_back(info);
+    if(g.size() < 2) result.error = 2;
+    else if(getCompleteMatrix() != nullptr) result = heuristicTour(MatrixDistance(*getCompleteMatrix()), start, construction, improve, run);
+    else if(getHierarchy() != nullptr) result = heuristicTour(HierarchyDistance(*getHierarchy()), start, construction, improve, run);
+    else result = heuristicTour(OracleDistance(getOracle(), g.size()), start, construction, improve, run);
 
-    auto clockEnd= chrono::high_resolution_clock::now();
-    displayPathFound(cost, res, clockEnd-clockStart);
+    result.timedOut = run.timedOut;
+    result.stats = run.stats;
+    result.time = chrono::high_resolution_clock::now() - clockStart;
+    return result;
 }
 
-// ============================================ TSP REAL WORLD ================================================================================
+/**
+ * Solves the TSP with a tour construction heuristic followed by 2-opt (see runHeuristic).
+ * Complexity: O(V^2) distance evaluations per 2-opt pass
+ * @param id Id of the start vertex
+ * @param construction How the tour is built
+ * @param timeBudget Seconds the search may take (0 for no limit)
+ * @return Cycle found (error 1 if the vertex doesn't exist, 2 if no cycle was found)
+ */
+TSPResult TSP::improvedHeuristic(int id, TourConstruction construction, double timeBudget) {
+    return runHeuristic(id, construction, true, timeBudget);
+}
 
 /**
- * DFS for seeking the best solution for the TSP problem adapted for thr real World graphs.
- * Complexity: O(N!) where n is number os vertexes.
- * @param v current vertex
- * @param currentWeight Current path weight
- * @param minWeight minimum weight found
- * @param currentSol Current path solution
- * @param bestSol Best solution found
- * @param count Counts the number of vertexes visited
- * @param tries Counts the number of tries for each vertex
- * @param currentAttempt Current trie number
- * @param targetId The id of the vertex where we want to finnish the path.
+ * Solves the TSP with a tour construction heuristic alone, e.g. the insertion heuristics (see runHeuristic).
+ * Complexity: depends on the construction
+ * @param id Id of the start vertex
+ * @param construction How the tour is built
+ * @param timeBudget Seconds the search may take (0 for no limit)
+ * @return Cycle found (error 1 if the vertex doesn't exist, 2 if no cycle was found)
+ */
+TSPResult TSP::constructionHeuristic(int id, TourConstruction construction, double timeBudget) {
+    return runHeuristic(id, construction, false, timeBudget);
+}
+
+/**
+ * Tour along a Hilbert curve over the coordinates of the vertexes, without improvement: a sort, so it gives a
+ * usable tour for inputs too large for the other heuristics (see improvedHeuristic to improve it with 2-opt).
+ * The steps without an edge are paid with their route, as in triangularAproxSolution.
+ * Complexity: O(V log V) for the tour, plus walkCost
+ * @param id Id of the start vertex
+ * @return Cycle found (error 1 if the vertex doesn't exist)
  */
-void TSP::backtrackingForRealWorld(Vertex<NodeInfo> *v, double currentWeight, double *minWeight,
-                                   std::vector<NodeInfo> currentSol, std::vector<NodeInfo> *bestSol, int count,
-                                   int tries,int &currentAttempt ,int targetId) {
+TSPResult TSP::spaceFillingCurveTour(int id) {
+    auto clockStart = chrono::high_resolution_clock::now();
+    TSPResult result;
+    const GraphIndex &g = getIndex();
+    int start = g.indexOf(id);
+    if(start == -1){
+        result.error = 1;
+        return result;
+    }
 
+    vector<int> tour = hilbertTour(g, start);
+    tour.push_back(start);
+    WeightSum cost = walkCost(tour);
+    for(size_t i = 0; i + 1 < tour.size(); i++) result.path.push_back(g.info(tour[i]));
+    result.path.push_back(g.info(start));
 
+    result.found = true;
+    result.cost = WeightTraits<Weight>::toMetres(cost);
+    result.time = chrono::high_resolution_clock::now() - clockStart;
+    return result;
+}
 
-    for(auto e: v->getAdj()){
-        Vertex<NodeInfo> *w = e->getDest();
+//========================================================== CLUSTER DECOMPOSITION ===============================================================================
+/**
+ * \struct ClusterBuffers
+ * Shortest path state of one thread of the decomposition: its own Dijkstra search and the position of each
+ * vertex in the set being measured.
+ */
+struct ClusterBuffers {
+    explicit ClusterBuffers(const GraphIndex &g) : search(g), slot(g.size(), -1) {}
 
+    DijkstraSearch search;
+    vector<int> slot;                   // -1 for the vertexes not in the set
+};
 
-        if(currentWeight + e->getWeight() >= *minWeight){
-            //this path isn't the solution
-            continue;
+/**
+ * Calculates the shortest path distances between every pair of a set of vertexes: read from the edge matrix on
+ * complete graphs, or else by a Dijkstra from each vertex that stops once the rest of the set is settled. The set is
+ * a cluster or a piece of the tour, so that is a small part of the graph, and much faster than a contraction
+ * hierarchy query per pair. Pairs without a route get their straight line distance, as in roadDistance.
+ * Complexity: O(k^2) lookups, or k searches, for k vertexes
+ * @param g Index of the graph
+ * @param matrix Edge matrix (nullptr if the graph is not complete, see getCompleteMatrix)
+ * @param vertexes The set
+ * @param buffers Buffers of the calling thread
+ * @return The distances, with the vertexes numbered by their position in the set
+ */
+static LocalDistance localDistances(const GraphIndex &g, const SolverDistanceMatrix *matrix, const vector<int> &vertexes, ClusterBuffers &buffers) {
+    int k = (int) vertexes.size();
+    LocalDistance d(k);
+    if(matrix != nullptr){
+        for(int i = 0; i < k; i++){
+            for(int j = i + 1; j < k; j++) d.set(i, j, (*matrix)(vertexes[i], vertexes[j]));
         }
+    }
+    else{
+        for(int i = 0; i < k; i++) buffers.slot[vertexes[i]] = i;
+        for(int i = 0; i + 1 < k; i++){
+            buffers.search.start(vertexes[i]);
+            int pending = k - i;
+            while(pending > 0){
+                int v = buffers.search.settleNext();
+                if(v == -1) break;
+                if(buffers.slot[v] >= i) pending--;
+            }
+            for(int j = i + 1; j < k; j++) d.set(i, j, buffers.search.distance(vertexes[j]));
+        }
+        for(int v : vertexes) buffers.slot[v] = -1;
+    }
 
-        if((size_t) count == graph.getVertexSet().size() && w->getInfo().getId() == targetId){
-            //found a solution
+    for(int i = 0; i < k; i++){
+        for(int j = i + 1; j < k; j++){
+            if(d(i, j) != GraphIndex::infinity()) continue;
+            const NodeInfo &a = g.info(vertexes[i]), &b = g.info(vertexes[j]);
+            d.set(i, j, WeightTraits<Weight>::fromMetres(haversine(a.getLatitude(), a.getLongitude(), b.getLatitude(), b.getLongitude())));
+        }
+    }
+    return d;
+}
 
+/**
+ * Solves the cycle of one cluster with a construction heuristic followed by 2-opt.
+ * Complexity: O(k^2) distance evaluations per 2-opt pass, for k vertexes
+ * @tparam Stop Callable given the cost of the current tour and returning true when 2-opt must stop
+ * @param d Distances between the vertexes of the cluster
+ * @param nodes Coordinates of the vertexes of the cluster (empty if there are none)
+ * @param construction How the cycle is built
+ * @param stop When to stop
+ * @return The cycle, by position in the cluster
+ */
+template <class Stop>
+static vector<int> clusterTour(const LocalDistance &d, const vector<NodeInfo> &nodes, TourConstruction construction, Stop stop) {
+    vector<int> tour;
+    switch(construction){
+        case TourConstruction::SPANNING_TREE:
+            tour = spanningTreeTour(d, 0);
+            break;
+        case TourConstruction::GREEDY_EDGE: {
+            //the clusters are small: every pair is a candidate
+            vector<pair<double, pair<int, int>>> pairs;
+            for(int i = 0; i < d.size(); i++) for(int j = i + 1; j < d.size(); j++) pairs.push_back({d(i, j), {i, j}});
+            sort(pairs.begin(), pairs.end());
+            vector<pair<int, int>> candidates;
+            for(const auto &candidate : pairs) candidates.push_back(candidate.second);
+            tour = greedyEdgeTour(d, candidates, 0);
+            break;
+        }
+        case TourConstruction::CHEAPEST_INSERTION:
+            tour = cheapestInsertionTour(d, nodes, 0);
+            break;
+        case TourConstruction::FARTHEST_INSERTION:
+            tour = farthestInsertionTour(d, nodes, 0);
+            break;
+        case TourConstruction::CONVEX_HULL_INSERTION:
+            tour = convexHullInsertionTour(d, nodes, 0);
+            break;
+        case TourConstruction::SPACE_FILLING_CURVE:
+            tour = nodes.empty() ? nearestNeighbourTour(d, 0) : hilbertOrder(nodes);
+            break;
+        default:
+            tour = nearestNeighbourTour(d, 0);
+    }
+    twoOpt(d, tour, stop);
+    return tour;
+}
 
-            if(currentWeight + e->getWeight() < *minWeight){
-                //found a better solution
+/**
+ * Solves the TSP on large graphs by decomposition: the vertexes are split into clusters of about CLUSTER_SIZE
+ * (k-means on the coordinates, or runs of the reverse Cuthill-McKee order without them, see Clustering.h), the
+ * cycle of each cluster is solved on its own over the shortest path distances of its vertexes, in parallel, and
+ * the clusters are visited in the order of a tour over their centroids. Each cycle is entered at its vertex
+ * closest to the exit of the previous cluster, and opened at one of the two edges of that vertex, whichever
+ * leaves the better way to the next cluster. Last, a window of up to BOUNDARY_WINDOW vertexes around each
+ * boundary between clusters is improved with 2-opt (the windows don't overlap, so they are also done in parallel).
+ * No pair of vertexes from far apart clusters is ever measured, so the work grows linearly with the size of the
+ * graph and is spread over the threads. With a time budget, the clusters not yet solved when it ends keep the
+ * order they were given.
+ * Complexity: O(V * CLUSTER_SIZE / T) distance evaluations per 2-opt pass, T the number of threads, plus the
+ * clustering and O(C^2) for the order of the C clusters
+ * @param id Id of the start vertex
+ * @param construction How the cycle of each cluster is built (followed by 2-opt)
+ * @param timeBudget Seconds the search may take (0 for no limit)
+ * @return Cycle found (error 1 if the vertex doesn't exist, 2 if the graph has fewer than two vertexes, or is
+ * disconnected and has no coordinates)
+ */
+TSPResult TSP::clusterDecomposition(int id, TourConstruction construction, double timeBudget) {
+    auto clockStart = chrono::high_resolution_clock::now();
+    SearchRun run(timeBudget);
+    TSPResult result;
+
+    const GraphIndex &g = getIndex();
+    int depot = g.indexOf(id);
+    if(depot == -1){
+        result.error = 1;
+        return result;
+    }
+    int n = g.size();
+    if(n < 2){
+        result.error = 2;
+        return result;
+    }
 
-                *minWeight = currentWeight;
-                *bestSol = currentSol;
-            }
+    //the threads only read the matrix, so it is built beforehand
+    const SolverDistanceMatrix *matrix = getCompleteMatrix();
+    atomic<bool> expired(false);
+    auto overBudget = [&run, &expired](){
+        if(run.clockExpired()) expired = true;
+        return expired.load();
+    };
+
+    //without coordinates, the vertexes with no route between them have no distance at all
+    vector<NodeInfo> nodes = indexCoordinates(g);
+    if(nodes.empty() && !analyseFeasibility().connected){
+        result.error = 2;
+        return result;
+    }
+    int k = (n + CLUSTER_SIZE - 1) / CLUSTER_SIZE;
+    vector<int> clusterOf;
+    if(!nodes.empty()) clusterOf = kMeansClusters(nodes, k, KMEANS_ITERATIONS, threads);
+    else{
+        vector<int> offsets {0}, targets;
+        for(int v = 0; v < n; v++){
+            for(const Neighbour *e = g.begin(v); e != g.end(v); e++) targets.push_back(e->to);
+            offsets.push_back((int) targets.size());
         }
+        clusterOf = graphClusters(offsets, targets, k);
+    }
+    k = *max_element(clusterOf.begin(), clusterOf.end()) + 1;
+    vector<vector<int>> members(k);
+    for(int v = 0; v < n; v++) members[clusterOf[v]].push_back(v);
+
+    //the cycle of each cluster, and the cost of each of its edges
+    vector<vector<int>> cycles(k);
+    vector<vector<double>> edgeCosts(k);
+    unsigned int workers = (unsigned int) min<size_t>(threads, (size_t) k);
+    ThreadPool pool(workers);
+    {
+        atomic<int> next(0);
+        for(unsigned int t = 0; t < workers; t++){
+            pool.submit([&](){
+                ClusterBuffers buffers(g);
+                for(int c = next++; c < k; c = next++){
+                    const vector<int> &cluster = members[c];
+                    LocalDistance d = localDistances(g, matrix, cluster, buffers);
+                    vector<int> tour;
+                    if(overBudget()){
+                        for(int i = 0; i < (int) cluster.size(); i++) tour.push_back(i);
+                    }
+                    else{
+                        vector<NodeInfo> local;
+                        if(!nodes.empty()) for(int v : cluster) local.push_back(nodes[v]);
+                        tour = clusterTour(d, local, construction, [&overBudget](double){ return overBudget(); });
+                    }
+                    for(size_t i = 0; i < tour.size(); i++){
+                        cycles[c].push_back(cluster[tour[i]]);
+                        edgeCosts[c].push_back(d(tour[i], tour[(i + 1) % tour.size()]));
+                    }
+                }
+            });
+        }
+        pool.wait();
+    }
 
+    //the order of the clusters: a tour over their centroids (the order of the clustering without coordinates)
+    vector<int> sequence(k);
+    for(int c = 0; c < k; c++) sequence[c] = c;
+    vector<NodeInfo> points = nodes; //the vertexes followed by the centroids
+    if(!nodes.empty()){
+        vector<NodeInfo> centroids;
+        for(int c = 0; c < k; c++){
+            double latitude = 0, longitude = 0;
+            for(int v : members[c]){
+                latitude += nodes[v].getLatitude() / members[c].size();
+                longitude += nodes[v].getLongitude() / members[c].size();
+            }
+            centroids.emplace_back(c, "", longitude, latitude);
+            points.push_back(centroids.back());
+        }
+        EuclideanDistance outer(centroids);
+        sequence = nearestNeighbourTour(outer, clusterOf[depot]);
+        if(k > TWO_OPT_FULL_SIZE) twoOptNeighbours(outer, sequence, delaunayNeighbours(centroids), [](double){ return false; });
+        else twoOpt(outer, sequence, [](double){ return false; });
+    }
 
-        //if the node isn't visited continues the search with this node
-        if(!w->isVisited() && w->getInfo().getId() != targetId){
-            w->setVisited(true);
-            currentSol.push_back(w->getInfo());
-            currentWeight += e->getWeight();
-            currentAttempt++;
-            backtrackingForRealWorld(w,currentWeight,minWeight,currentSol,bestSol,count+1,tries,currentAttempt,targetId);
-
-            //eliminates the node from the solution for searching other solutions
-            currentWeight -= e->getWeight();
-            currentSol.erase(currentSol.end()--);
+    //the cycles are opened and chained
+    EuclideanDistance plane(points);
+    ClusterBuffers buffers(g);
+    vector<int> tour, boundaries; //boundaries[r]: position in the tour of the first vertex of the r-th cluster
+    tour.reserve(n);
+    vector<char> marked(n, 0);
+    int last = -1; //exit of the previous cluster
+    for(int r = 0; r < k; r++){
+        const vector<int> &cycle = cycles[sequence[r]];
+        const vector<double> &costs = edgeCosts[sequence[r]];
+        int m = (int) cycle.size(), following = sequence[(r + 1) % k];
+
+        //the entry is the vertex closest to the exit of the previous cluster (for the first, to the last centroid)
+        int entry = 0;
+        if(!nodes.empty()){
+            int from = r == 0 ? n + sequence[k - 1] : last;
+            for(int i = 1; i < m; i++) if(plane(from, cycle[i]) < plane(from, cycle[entry])) entry = i;
+        }
+        else if(r > 0 && matrix != nullptr){
+            for(int i = 1; i < m; i++) if((*matrix)(last, cycle[i]) < (*matrix)(last, cycle[entry])) entry = i;
+        }
+        else if(r > 0){
+            for(int v : cycle) marked[v] = 1;
+            double distance;
+            int closest = nearestMarked(buffers.search, last, marked, distance);
+            for(int v : cycle) marked[v] = 0;
+            if(closest != -1) entry = (int) (find(cycle.begin(), cycle.end(), closest) - cycle.begin());
         }
 
-        if(currentAttempt >= tries){
+        //the cycle is opened at the edge of the entry that is dropped: the one that saves the most, minus the way
+        //from the other end of that edge to the next cluster (known only with coordinates)
+        int after = (entry + 1) % m, before = (entry + m - 1) % m;
+        double forward = -costs[before], backward = -costs[entry];
+        if(!nodes.empty() && k > 1){
+            forward += plane(cycle[before], n + following);
+            backward += plane(cycle[after], n + following);
+        }
+        boundaries.push_back((int) tour.size());
+        for(int i = 0; i < m; i++) tour.push_back(cycle[forward <= backward ? (entry + i) % m : (entry - i + m) % m]);
+        last = tour.back();
+    }
 
-            continue;
+    //2-opt on pieces of the tour (first, length), keeping their ends; the pieces of a pass don't overlap, so they
+    //are improved in parallel
+    auto improveWindows = [&](const vector<pair<int, int>> &windows){
+        atomic<int> next(0);
+        for(unsigned int t = 0; t < workers; t++){
+            pool.submit([&](){
+                ClusterBuffers windowBuffers(g);
+                for(int w = next++; w < (int) windows.size(); w = next++){
+                    if(overBudget()) break;
+                    vector<int> window;
+                    for(int i = 0; i < windows[w].second; i++) window.push_back(tour[(windows[w].first + i) % n]);
+                    if(window.size() < 4) continue;
+                    LocalDistance d = localDistances(g, matrix, window, windowBuffers);
+                    vector<int> path(window.size());
+                    for(size_t i = 0; i < path.size(); i++) path[i] = (int) i;
+                    twoOptPath(d, path);
+                    for(size_t i = 0; i < path.size(); i++) tour[(windows[w].first + i) % n] = window[path[i]];
+                }
+            });
         }
+        pool.wait();
+    };
+
+    //first around each boundary: the clusters give half of each to the windows on either side
+    vector<pair<int, int>> windows;
+    for(int r = 0; r < k && k > 1; r++){
+        int left = min(BOUNDARY_WINDOW / 2, (int) cycles[sequence[r]].size() / 2);
+        int right = min(BOUNDARY_WINDOW / 2, ((int) cycles[sequence[(r + 1) % k]].size() + 1) / 2);
+        windows.push_back({boundaries[(r + 1) % k] - left + n, left + right});
+    }
+    improveWindows(windows);
+    //then the whole tour, in two passes whose windows are shifted by half of their length
+    for(int offset : {0, BOUNDARY_WINDOW / 2}){
+        windows.clear();
+        for(int first = 0; first < n; first += BOUNDARY_WINDOW) windows.push_back({first + offset, min(BOUNDARY_WINDOW, n - first)});
+        improveWindows(windows);
+    }
 
+    //the cost, from the weights of the graph (see walkCost)
+    int first = (int) (find(tour.begin(), tour.end(), depot) - tour.begin());
+    vector<int> walk;
+    walk.reserve(n + 1);
+    for(int i = 0; i <= n; i++) walk.push_back(tour[(first + i) % n]);
+    for(int v : walk) result.path.push_back(g.info(v));
+    result.found = true;
+    result.cost = WeightTraits<Weight>::toMetres(walkCost(walk));
+    result.timedOut = expired;
+    result.stats = run.stats;
+    result.time = chrono::high_resolution_clock::now() - clockStart;
+    return result;
+}
 
+// ============================================ TSP REAL WORLD ================================================================================
 
+/**
+ * Searches the best cycle that extends a partial solution adapted for the real World graphs, with a limited
+ * number of tries (see BacktrackingEngine).
+ * Complexity: O(N!) where n is number os vertexes, limited by tries.
+ * @param prefix Current path solution, as vertex indexes (see getIndex), from the vertex where the cycle ends
+ * @param minWeight minimum weight found (of the whole cycle, updated if a better one is found)
+ * @param bestSol Best solution found (updated, without the return to the first vertex)
+ * @param tries Maximum number of nodes expanded
+ * @param currentAttempt Counts the nodes expanded
+ * @param run Statistics and time budget of the run
+ */
+void TSP::backtrackingForRealWorld(const vector<int> &prefix, WeightSum *minWeight, vector<NodeInfo> *bestSol,
+                                   int tries, int &currentAttempt, SearchRun &run) const {
+    if(prefix.empty()) return;
+    const GraphIndex &g = getIndex();
+    BacktrackingEngine engine(g);
+    bool found = engine.run(prefix, *minWeight, tries, [&run](){ return run.budgetExceeded(); }, run.stats);
+    currentAttempt += (int) engine.expansions();
+    if(found){
+        *minWeight = engine.bestCost();
+        bestSol->clear();
+        for(int u : engine.bestCycle()) bestSol->push_back(g.info(u));
     }
-
-    v->setVisited(false);
 }
 
 /**
  * Solves the TSP problem for incomplete graphs (first solution with backtracking).
  * Complexity: O(E*V!)
  * @param id Id of the root vertex
+ * @param timeBudget Seconds the search may take (0 for no limit)
+ * @return Cycle found (error 1 if the vertex doesn't exist, 2 if no cycle was found)
  */
-void TSP::tspRealWord(int id) {
+TSPResult TSP::tspRealWord(int id, double timeBudget) {
     auto clockStart= chrono::high_resolution_clock::now();
+    SearchRun run(timeBudget);
+    TSPResult result;
 
     //initialize variables
-    auto infoItr = idToNode.find(id);
-    if(infoItr == idToNode.end()){
-        displayNoSolution(1);
-        return;
+    const GraphIndex &g = getIndex();
+    int start = g.indexOf(id);
+    if(start == -1){
+        result.error = 1;
+        return result;
     }
-    NodeInfo info = infoItr->second;
-    Vertex<NodeInfo> *v = graph.findVertex(info);
+    NodeInfo info = g.info(start);
+    int v = start;
     vector<NodeInfo> res;
-    res.push_back(v->getInfo());
-    double minWeight = LONG_LONG_MAX;
+    res.push_back(info);
+    vector<int> prefix {start};
+    WeightSum minWeight = WeightTraits<WeightSum>::infinity();
     int currentAttempt = 0;
     vector<NodeInfo> bestSol;
-    double cost = 0;
-
-    //resets the graph auxiliary values
-    for(auto s : graph.getVertexSet()){
-        s->setVisited(false);
-        s->setDist(ULONG_LONG_MAX); // Set distance to infinity
-        s->setPath(nullptr);
+    WeightSum cost = 0;
 
-    }
-
-    v->setVisited(true);
+    VisitedSet visited(g.size());
+    visited.set(v);
 
     //main loop
-    while(res.size() < graph.getVertexSet().size()){
-        Edge<NodeInfo> *e = getShortestEdge(v);
+    while(res.size() < (size_t) g.size()){
+        const Neighbour *e = getShortestEdge(g, v, visited);
 
         if(e == nullptr){
             //tries to find cycle or breaks
-            v = graph.findVertex(res.back());
-            backtrackingForRealWorld(v,cost,&minWeight,res,&bestSol,res.size(),10,currentAttempt,id);
+            backtrackingForRealWorld(prefix,&minWeight,&bestSol,10,currentAttempt,run);
+            TSP_STAT(run.stats.tries = currentAttempt);
             break;
         }
         else{
-            cost += e->getWeight();
-            v = e->getDest();
-            v->setVisited(true);
+            cost += e->weight;
+            v = e->to;
+            visited.set(v);
         }
-        res.push_back(v->getInfo());
+        res.push_back(g.info(v));
+        prefix.push_back(v);
     }
 
-    //if we have found a solution in the backtracking we update the current solution
+    result.error = 2;
+    result.timedOut = run.timedOut;
+    result.stats = run.stats;
+
+    //if we have found a solution in the backtracking it is already a cycle (closing edge included)
     if(!bestSol.empty()){
         res=bestSol;
-        cost=minWeight;
+        res.push_back(info);
+        auto clockEnd= chrono::high_resolution_clock::now();
+        result.found = true;
+        result.error = 0;
+        result.cost = WeightTraits<Weight>::toMetres(minWeight);
+        result.path = res;
+        result.time = clockEnd - clockStart;
+        return result;
     }
 
     //checks if the current solution is valid
-    if(res.size() != graph.getVertexSet().size()){
-        displayNoSolution(2);
-        return;
+    if(res.size() != (size_t) g.size()){
+        return result;
     }
 
     //Checks if there is a path from the last vertex to the first one
-    NodeInfo infoFinal = res.back();
-    Vertex<NodeInfo> *finalVertex = graph.findVertex(infoFinal);
-    Vertex<NodeInfo> *firstVertex = graph.findVertex(info);
+    double closing = g.weight(v, start);
 
-    Edge<NodeInfo> *e = findEdge(firstVertex,finalVertex);
-
-    if(e == nullptr ){
-        displayNoSolution(2);
-    }
-    else{
+    if(closing != GraphIndex::infinity()){
         res.push_back(info);
-        cost += e->getWeight();
+        cost += closing;
         auto clockEnd= chrono::high_resolution_clock::now();
-        displayPathFound(cost, res, clockEnd-clockStart);
-    }
-
-
-
-}
-
-/**
- * Gets the shortest edge adapted for the real world graphs problem.
- * Complexity: O(E) where E is the number of outgoing edges of v.
- * @param v Vertex we are analysing
- * @return edge with the smallest cost
- */
-Edge<NodeInfo>* getShortestEdgeRealWorld(Vertex<NodeInfo> *v){
-    double minWeight = LONG_LONG_MAX;
-    Edge<NodeInfo> * minEdge = nullptr;
-
-    for(Edge<NodeInfo> *e: v->getAdj()){
-        if((e->getWeight() < minWeight) && (!e->getDest()->isVisited()) && (!e->isSelected())){
-            minEdge = e;
-            minWeight = e->getWeight();
-        }
+        result.found = true;
+        result.error = 0;
+        result.cost = WeightTraits<Weight>::toMetres(cost);
+        result.path = res;
+        result.time = clockEnd - clockStart;
     }
 
-
-    return minEdge;
+    return result;
 }
 
 /**
  * Solves the TSP problem for incomplete graphs (second solution).
  * Complexity: O(V*E)
  * @param id Id of the root vertex
+ * @param timeBudget Seconds the search may take (0 for no limit)
+ * @return Cycle found (error 1 if the vertex doesn't exist, 2 if no cycle was found)
  */
-void TSP::tspRealWord2(int id) {
+TSPResult TSP::tspRealWord2(int id, double timeBudget) {
 
-    if(graph.getVertexSet().size() < 30){
+    const GraphIndex &g = getIndex();
+    if(g.size() < 30){
         //smalls graphs can use the backtracking solution instead
-        backtrackingSolution(id);
-        return;
+        return backtrackingSolution(id);
     }
 
     auto clockStart= chrono::high_resolution_clock::now();
-
-    auto infoItr = idToNode.find(id);
+    SearchRun run(timeBudget);
+    TSPResult result;
 
     //initialize variables
-    if(infoItr == idToNode.end()){
-        displayNoSolution(1);
-        return;
-    }
-    NodeInfo info = infoItr->second;
-    Vertex<NodeInfo> *v = graph.findVertex(info);
-    vector<NodeInfo> res;
-    res.push_back(v->getInfo());
-    double cost = 0;
-
-    //resets the graph auxiliary values
-    for(auto s : graph.getVertexSet()){
-        s->setVisited(false);
-        s->setDist(ULONG_LONG_MAX); // Set distance to infinity
-        s->setPath(nullptr);
-        for(auto e: s->getAdj()){
-            e->setSelected(false);
-        }
-
+    int start = g.indexOf(id);
+    if(start == -1){
+        result.error = 1;
+        return result;
     }
+    int v = start;
+    vector<int> path;
+    path.push_back(v);
+    vector<Weight> steps; //weight of the edge into each vertex of the path (after the first)
+    WeightSum cost = 0;
 
-    v->setVisited(true);
+    //state of this run: the vertexes in the path and the edges already tried and abandoned
+    VisitedSet visited(g.size());
+    VisitedSet selected((int) g.numEdges());
+    visited.set(v);
 
     //initializes the auxiliary variables to limit the complexity of the algorithm
-    int maxTriesGoingBack = 5000;
-    Edge<NodeInfo> *prevEdge;
+    const int triesGoingBack = 5000;
+    int maxTriesGoingBack = triesGoingBack;
+    const Neighbour *prevEdge = nullptr;
 
     //main loop
-    while(res.size() < graph.getVertexSet().size()){
-        Edge<NodeInfo> *e = getShortestEdgeRealWorld(v);
+    while(path.size() < (size_t) g.size()){
+        if(run.budgetExceeded()) break;
+        const Neighbour *e = getShortestEdge(g, v, visited, &selected);
 
         if(e == nullptr){
             //tries to find cycle or breaks
@@ -673,58 +1624,376 @@ void TSP::tspRealWord2(int id) {
                 //no solution found
                 break;
             }
-            v->setVisited(false);
-            res.erase(res.end() - 1);
+            visited.reset(v);
+            path.pop_back();
 
-            if(res.empty()){
+            if(path.empty()){
                 break;
             }
 
-            v = graph.findVertex(res.back());
+            cost -= steps.back();
+            steps.pop_back();
+            v = path.back();
 
             if(prevEdge != nullptr){
-                prevEdge->setSelected(true);
+                selected.set(g.edgeId(prevEdge));
             }
 
         }
-        else if(!e->isSelected()){
+        else{
             //if we haven't tried this edge we continue
-            cost += e->getWeight();
-            v = e->getDest();
-            v->setVisited(true);
-            res.push_back(v->getInfo());
+            cost += e->weight;
+            steps.push_back(e->weight);
+            v = e->to;
+            visited.set(v);
+            path.push_back(v);
             prevEdge = e;
         }
-        else{
-            continue;
-        }
 
     }
 
+    TSP_STAT(run.stats.triesGoingBack = triesGoingBack - maxTriesGoingBack);
+    result.error = 2;
+    result.timedOut = run.timedOut;
+    result.stats = run.stats;
+
     //checks if the current solution is valid
-    if(res.size() != graph.getVertexSet().size()){
-        displayNoSolution(2);
-        return;
+    if(path.size() != (size_t) g.size()){
+        return result;
     }
 
     //Checks if there is a path from the last vertex to the first one
-    NodeInfo infoFinal = res.back();
-    Vertex<NodeInfo> *finalVertex = graph.findVertex(infoFinal);
-    Vertex<NodeInfo> *firstVertex = graph.findVertex(info);
+    double closing = g.weight(v, start);
 
-    Edge<NodeInfo> *e = findEdge(firstVertex,finalVertex);
+    if(closing != GraphIndex::infinity()){
+        for(int u : path) result.path.push_back(g.info(u));
+        result.path.push_back(g.info(start));
+        cost += closing;
+        auto clockEnd= chrono::high_resolution_clock::now();
+        result.found = true;
+        result.error = 0;
+        result.cost = WeightTraits<Weight>::toMetres(cost);
+        result.time = clockEnd - clockStart;
+    }
 
-    if(e == nullptr ){
-        displayNoSolution(2);
+    return result;
+}
+
+
+// ============================================================ TSP REAL WORLD (MANY STARTS) ===================================================================
+/**
+ * Checks the necessary conditions for a Hamiltonian cycle: the graph is connected and every vertex has at least
+ * two distinct neighbours. Vertexes with exactly two neighbours are counted, since both of their edges are forced.
+ * Complexity: O(V + E) where V is the number of vertexes and E is the number of edges.
+ * @return Feasibility of the current graph
+ */
+Feasibility TSP::analyseFeasibility() const {
+    const GraphIndex &g = getIndex();
+    Feasibility feasibility;
+    int n = g.size();
+    if(n == 0) return feasibility;
+
+    vector<char> seen(n, 0);
+    vector<int> queue;
+    queue.reserve(n);
+    queue.push_back(0);
+    seen[0] = 1;
+    for(size_t i = 0; i < queue.size(); i++){
+        for(const Neighbour *e = g.begin(queue[i]); e != g.end(queue[i]); e++){
+            if(!seen[e->to]){
+                seen[e->to] = 1;
+                queue.push_back(e->to);
+            }
+        }
     }
-    else{
-        res.push_back(info);
-        cost += e->getWeight();
-        auto clockEnd= chrono::high_resolution_clock::now();
-        displayPathFound(cost, res, clockEnd-clockStart);
+    feasibility.connected = (int) queue.size() == n;
+
+    feasibility.minDegree = n;
+    vector<int> lastSeenFrom(n, -1);
+    for(int v = 0; v < n; v++){
+        //parallel edges and self loops don't count as different neighbours
+        int distinct = 0;
+        for(const Neighbour *e = g.begin(v); e != g.end(v); e++){
+            if(e->to != v && lastSeenFrom[e->to] != v){
+                lastSeenFrom[e->to] = v;
+                distinct++;
+            }
+        }
+        feasibility.minDegree = min(feasibility.minDegree, distinct);
+        if(distinct == 2) feasibility.degreeTwoVertexes++;
+    }
+
+    return feasibility;
+}
+
+/**
+ * Calculates the weight of a minimum spanning tree (Prim), a lower bound of the cost of any Hamiltonian cycle.
+ * Complexity: O(E * log(E)) where E is the number of edges.
+ * @param g Index of a connected graph
+ * @return Weight of the tree
+ */
+static WeightSum mstWeight(const GraphIndex &g) {
+    int n = g.size();
+    vector<char> inTree(n, 0);
+    priority_queue<pair<Weight, int>, vector<pair<Weight, int>>, greater<pair<Weight, int>>> pq;
+    WeightSum total = 0;
+    pq.push({0, 0});
+    while(!pq.empty()){
+        Weight w = pq.top().first;
+        int v = pq.top().second;
+        pq.pop();
+        if(inTree[v]) continue;
+        inTree[v] = 1;
+        total += w;
+        for(const Neighbour *e = g.begin(v); e != g.end(v); e++){
+            if(!inTree[e->to]) pq.push({e->weight, e->to});
+        }
     }
+    return total;
+}
 
+/**
+ * Depth-first walk from one start over the index: each vertex goes on to its lightest unvisited neighbour, and at
+ * a dead end the walk goes back one vertex and tries the next lightest edge of the one before. Unlike tspRealWord2,
+ * the edges abandoned are only skipped while their vertex stays in the path, and the graph is never searched exactly.
+ * All the state is in the given buffers, so several starts can be searched at the same time.
+ * Complexity: O(V*E) in the worst case, limited by maxTriesGoingBack.
+ * @tparam Stop Callable returning true when the search must stop (checked once every 1024 steps)
+ * @param g Index of the graph
+ * @param start Index of the start vertex
+ * @param maxTriesGoingBack How many times the search may go back before giving up
+ * @param path Vertexes of the cycle found (without the start at the end)
+ * @param cursor Buffer for the next edge to try at each depth
+ * @param visited Buffer for the visited vertexes
+ * @param cost Cost of the cycle found
+ * @param stats Statistics of the search
+ * @param stop When to stop
+ * @return true if a cycle was found
+ */
+template <class Stop>
+static bool walkFromStart(const GraphIndex &g, int start, int maxTriesGoingBack, vector<int> &path, vector<int> &cursor,
+                          vector<char> &visited, WeightSum &cost, SearchStats &stats, Stop stop) {
+    (void) stats; //only written with TSP_SEARCH_STATS
+    int n = g.size();
+    visited.assign(n, 0);
+    cursor.assign(n, 0);
+    path.clear();
+    path.push_back(start);
+    visited[start] = 1;
+    int triesLeft = maxTriesGoingBack;
+    unsigned int steps = 0;
+
+    while(!path.empty()){
+        if((++steps & 1023) == 0 && stop()) break;
+        int depth = (int) path.size() - 1;
+        int v = path[depth];
+
+        if((int) path.size() == n){
+            if(g.hasEdge(v, start)){
+                cost = g.weight(v, start);
+                for(int i = 0; i + 1 < n; i++){
+                    cost += g.weight(path[i], path[i + 1]);
+                }
+                TSP_STAT(stats.triesGoingBack = maxTriesGoingBack - triesLeft);
+                return true;
+            }
+        }
+        else{
+            //next unvisited neighbour, by increasing weight
+            const Neighbour *e = g.begin(v) + cursor[depth];
+            while(e != g.end(v) && visited[e->to]) e++;
+            cursor[depth] = (int) (e - g.begin(v)) + 1;
+            if(e != g.end(v)){
+                path.push_back(e->to);
+                visited[e->to] = 1;
+                cursor[depth + 1] = 0;
+                TSP_STAT(stats.expand(depth + 1));
+                continue;
+            }
+        }
 
+        //dead end: goes back one vertex
+        if(--triesLeft < 0) break;
+        visited[v] = 0;
+        path.pop_back();
+    }
 
+    TSP_STAT(stats.triesGoingBack = maxTriesGoingBack);
+    return false;
 }
 
+/**
+ * Solves the TSP problem for incomplete graphs from many start vertexes at once (see walkFromStart).
+ * The preprocessing (index, feasibility and spanning tree bound) is done once and the starts are searched in
+ * parallel. A cycle visits every vertex, so the cheapest one found is rotated to serve every start, and the
+ * starts whose own search failed still get a solution. With a time budget, the walks stop when it ends and the
+ * starts not yet searched are skipped.
+ * Complexity: O(E log E + S*V*E / T) where S is the number of starts and T the number of threads.
+ * @param ids Ids of the start vertexes
+ * @param threads Number of threads (0 for one per hardware thread)
+ * @param timeBudget Seconds the search may take (0 for no limit)
+ * @return One result per start, all with the time of the whole batch (error 1 if the vertex doesn't exist, 2 if no cycle was found)
+ */
+vector<TSPResult> TSP::tspRealWordBatch(const vector<int> &ids, unsigned int threads, double timeBudget) {
+    auto clockStart = chrono::high_resolution_clock::now();
+    vector<TSPResult> results(ids.size());
+    const GraphIndex &g = getIndex();
+    int n = g.size();
+
+    Feasibility feasibility = analyseFeasibility();
+    double lowerBound = feasibility.connected ? WeightTraits<Weight>::toMetres(mstWeight(g)) : 0;
+
+    vector<int> starts(ids.size());
+    for(size_t i = 0; i < ids.size(); i++){
+        starts[i] = g.indexOf(ids[i]);
+        results[i].error = starts[i] == -1 ? 1 : 2;
+        results[i].lowerBound = lowerBound;
+    }
+    if(!feasibility.possible() || n < 3){
+        return results;
+    }
+
+    //every start is searched on its own buffers
+    const int triesGoingBack = 5000;
+    vector<vector<int>> cycles(ids.size());
+    vector<WeightSum> costs(ids.size(), WeightTraits<WeightSum>::infinity());
+    atomic<size_t> next(0);
+    SearchRun run(timeBudget);
+    atomic<bool> expired(false);
+    auto overBudget = [&](){
+        if(run.clockExpired()) expired = true;
+        return expired.load();
+    };
+    if(threads == 0) threads = ThreadPool::defaultThreads();
+    threads = (unsigned int) min<size_t>(threads, max<size_t>(ids.size(), 1));
+    ThreadPool pool(threads);
+    for(unsigned int t = 0; t < threads; t++){
+        pool.submit([&](){
+            vector<int> path, cursor;
+            vector<char> visited;
+            for(size_t i = next++; i < ids.size(); i = next++){
+                if(starts[i] == -1 || overBudget()) continue;
+                WeightSum cost = 0;
+                if(walkFromStart(g, starts[i], triesGoingBack, path, cursor, visited, cost, results[i].stats, overBudget)){
+                    cycles[i] = path;
+                    costs[i] = cost;
+                }
+            }
+        });
+    }
+    pool.wait();
+
+    auto clockEnd = chrono::high_resolution_clock::now();
+    size_t best = ids.size();
+    for(size_t i = 0; i < ids.size(); i++){
+        results[i].timedOut = expired;
+        results[i].time = clockEnd - clockStart;
+        if(!cycles[i].empty() && (best == ids.size() || costs[i] < costs[best])) best = i;
+    }
+    if(best == ids.size()){
+        return results;
+    }
+
+    //rotates the best cycle so that it starts in each of the starts
+    const vector<int> &cycle = cycles[best];
+    vector<int> position(n);
+    for(int i = 0; i < n; i++) position[cycle[i]] = i;
+    for(size_t i = 0; i < ids.size(); i++){
+        if(starts[i] == -1) continue;
+        TSPResult &result = results[i];
+        int first = position[starts[i]];
+        result.path.reserve(n + 1);
+        for(int k = 0; k <= n; k++){
+            result.path.push_back(g.info(cycle[(first + k) % n]));
+        }
+        result.found = true;
+        result.error = 0;
+        result.cost = WeightTraits<Weight>::toMetres(costs[best]);
+        if(i != best && starts[i] != starts[best]) result.cycleFrom = ids[best];
+    }
+
+    return results;
+}
+
+// ============================================================ LOWER BOUND (HELD-KARP) =======================================================================
+/**
+ * Calculates the Held-Karp bound over a distance policy, with the cost of a nearest neighbour tour over the same
+ * distances as the upper bound. It doesn't depend on the results already found, so the bound is the same whichever
+ * algorithm asks for it first.
+ * Complexity: O(V^2) distance evaluations per iteration
+ * @tparam Distance Distance policy (see DistancePolicy.h)
+ * @param d Distances
+ * @return The bound, in graph units (0 if the distances have no 1-tree)
+ */
+template <class Distance>
+double TSP::heldKarpOver(const Distance &d) const {
+    double upperBound = tourCost(d, nearestNeighbourTour(d, 0));
+    return heldKarpBound(d, upperBound, HELD_KARP_ITERATIONS, [](double){ return false; }).bound;
+}
+
+/**
+ * Gets a lower bound of the cost of any cycle, calculated the first time it is needed: the Held-Karp 1-tree bound
+ * over the edge matrix for complete graphs, or else over the shortest path distances for graphs up to
+ * HELD_KARP_MAX_CLOSURE vertexes (the heuristics pay the missing edges with those, see expandRoute). Larger graphs
+ * get the minimum spanning tree bound.
+ * Complexity: O(V^2) distance evaluations per iteration of the subgradient ascent the first time, O(1) afterwards.
+ * @return The bound, in graph units (0 if the graph is disconnected)
+ */
+double TSP::heldKarpLowerBound() const {
+    return *lowerBound.get([this](){
+        const GraphIndex &g = getIndex();
+        int n = g.size();
+
+        double bound = 0;
+        if(getCompleteMatrix() != nullptr){
+            bound = heldKarpOver(MatrixDistance(*getCompleteMatrix()));
+        }
+        else if(n <= HELD_KARP_MAX_CLOSURE && getHierarchy() != nullptr){
+            bound = heldKarpOver(HierarchyDistance(*getHierarchy()));
+        }
+        else if(n <= HELD_KARP_MAX_CLOSURE){
+            //every row is needed: they are calculated in parallel beforehand
+            vector<int> sources(n);
+            for(int v = 0; v < n; v++) sources[v] = v;
+            getOracle().prefetch(sources, threads);
+            bound = heldKarpOver(OracleDistance(getOracle(), n));
+        }
+        if(bound == 0 && n > 0 && analyseFeasibility().connected){
+            bound = mstWeight(g);
+        }
+        return make_shared<const double>(bound);
+    });
+}
+
+/**
+ * Gets the lower bound the time budgeted searches compare their cycles with, if they stop early (see setLowerBound).
+ * Complexity: see heldKarpLowerBound
+ * @return The bound, in graph units (0 if the searches don't stop early)
+ */
+double TSP::targetBound() const {
+    return targetGap > 0 ? heldKarpLowerBound() : 0;
+}
+
+/**
+ * Checks if a cycle is close enough to the lower bound for the time budgeted searches to stop.
+ * Complexity: O(1)
+ * @param cost Cost of the cycle, in graph units
+ * @param bound The lower bound (see targetBound)
+ * @return true if the gap to the bound is at most the target gap
+ */
+bool TSP::gapReached(double cost, double bound) const {
+    return targetGap > 0 && bound > 0 && cost <= bound * (1 + targetGap);
+}
+
+/**
+ * Adds the lower bound to a result (when enabled), so its optimality gap can be reported.
+ * Complexity: see heldKarpLowerBound the first time, O(1) afterwards.
+ * @param result Result of an algorithm
+ * @return The result with the lower bound
+ */
+TSPResult TSP::withLowerBound(TSPResult result) const {
+    if(!reportBound || !result.found) return result;
+    double bound = heldKarpLowerBound();
+    result.lowerBound = max(result.lowerBound, WeightTraits<Weight>::toMetres(bound));
+    return result;
+}
@@ -7,50 +7,214 @@
 
 
 #include "Graph.h"
+#include "ContractionHierarchy.h"
+#include "DistanceMatrix.h"
+#include "DistanceOracle.h"
+#include "GraphIndex.h"
+#include "SearchStats.h"
+#include "SolverState.h"
+#include <algorithm>
 #include <unordered_map>
 #include <chrono>
+#include <memory>
+#include <mutex>
+
+const int HELD_KARP_ITERATIONS = 300;      // maximum number of 1-trees of the lower bound
+const int HELD_KARP_MAX_CLOSURE = 1000;    // sparse graphs up to this size get the bound over the shortest path distances
+const int GREEDY_CANDIDATES = 10;          // lightest edges of each vertex considered by the greedy edge construction
+const int TWO_OPT_FULL_SIZE = 1000;        // larger tours get 2-opt over neighbour lists (see twoOptNeighbours)
+const int TWO_OPT_CANDIDATES = 8;          // lightest edges (or alpha-nearest vertexes) of each vertex in those lists, see getCandidates
+const int QUADRANT_CANDIDATES = 2;         // closest vertexes in each quadrant added to the Delaunay neighbours in those lists
+const int CLUSTER_SIZE = 500;              // vertexes per cluster of the decomposition (see clusterDecomposition)
+const int KMEANS_ITERATIONS = 10;          // maximum number of iterations of the k-means that forms the clusters
+const int BOUNDARY_WINDOW = 40;            // vertexes around each boundary between clusters improved after the stitching
+
+double haversine(double lat1, double lon1, double lat2, double lon2);
+Edge<NodeInfo> *findEdge(Vertex<NodeInfo> *first, Vertex<NodeInfo> *second);
+
+/**
+ * \struct TSPResult
+ * Outcome of one run of a TSP algorithm.
+ */
+struct TSPResult {
+    bool found = false;
+    bool timedOut = false;                  // the time budget ended before the search finished
+    int error = 0;                          // error number used by displayNoSolution when nothing was found
+    double cost = 0;
+    std::vector<NodeInfo> path;
+    std::vector<NodeInfo> route;            // path with the steps without an edge replaced by their shortest paths (see TSP::withRoute)
+    std::chrono::duration<double> time = std::chrono::duration<double>(0);
+    SearchStats stats;
+    double lowerBound = 0;                  // lower bound of the optimal cost (0 if not computed)
+    int cycleFrom = -1;                     // id of the start whose search found the cycle, when it was rotated from another start
+
+    double gap() const { return found && lowerBound > 0 ? std::max(0.0, (cost - lowerBound) / lowerBound) : -1; } // relative distance to the bound (-1 if unknown, 0 if the bound meets the cost up to rounding)
+};
+
+/**
+ * How the tour improved by 2-opt is built.
+ */
+enum class TourConstruction {
+    NEAREST_NEIGHBOUR,
+    SPANNING_TREE,          // preorder walk of a minimum spanning tree
+    GREEDY_EDGE,            // lightest edges first, joined into paths and then chained (see greedyEdgeTour)
+    CHEAPEST_INSERTION,     // insertion heuristics, see InsertionHeuristics.h
+    FARTHEST_INSERTION,
+    CONVEX_HULL_INSERTION,
+    SPACE_FILLING_CURVE     // order along a Hilbert curve over the coordinates (see spaceFillingCurveTour)
+};
+
+/**
+ * \struct Feasibility
+ * Necessary conditions for a graph to have a Hamiltonian cycle.
+ */
+struct Feasibility {
+    bool connected = false;
+    int minDegree = 0;          // smallest number of distinct neighbours
+    int degreeTwoVertexes = 0;  // vertexes whose two edges are forced to be in any cycle
+
+    bool possible() const { return connected && minDegree >= 2; }
+};
+
+/**
+ * \class LazyValue
+ * Object derived from the graph, built the first time it is needed. When several threads need it at the same
+ * time, one of them builds it and the others wait. reset (when the graph or a setting changes) must not be called
+ * while it is in use.
+ * @tparam T Type of the object
+ */
+template <class T>
+class LazyValue {
+public:
+    LazyValue() : once(new std::once_flag) {}
+
+    /**
+     * Gets the object, building it if this is the first call since the last reset.
+     * Complexity: that of build the first time, O(1) afterwards
+     * @param build Callable returning the object as a shared_ptr (which may be empty)
+     * @return The object, nullptr if build returned none
+     */
+    template <class Build>
+    T *get(Build build) const {
+        std::call_once(*once, [this, &build](){ value = build(); });
+        return value.get();
+    }
+
+    /**
+     * Drops the object, so the next get builds it again.
+     * Complexity: that of the destructor of the object
+     */
+    void reset() {
+        value.reset();
+        once.reset(new std::once_flag);
+    }
+
+private:
+    std::unique_ptr<std::once_flag> once;
+    mutable std::shared_ptr<T> value;
+};
+
 /**
  * @file TSP.h
  * @brief Definition of class TSP.
  *
  * \class TSP
  * Where are stored the graph and the map from the ids to the vertexes.
- * Is also where the TSP algorithms are performed.
+ * Is also where the TSP algorithms are performed. Several threads can run them on the same object at the same
+ * time: each run keeps its own state (see SearchRun) and what is derived from the graph is built once (see
+ * LazyValue). The setters must not be called while an algorithm runs.
  */
 class TSP {
 
     public:
     //Backtracking
-    void backtrackingSolutionDFS(Vertex<NodeInfo> *v, double currentWeight, double *minWeight, std::vector<NodeInfo> currentSol, std::vector<NodeInfo> *bestSol, int count, int finalID) const;
-    void backtrackingSolution(int n) const;
+    void backtrackingSolutionDFS(const std::vector<int> &prefix, WeightSum *minWeight, std::vector<NodeInfo> *bestSol, double timeBudget = 0) const;
+    TSPResult backtrackingSolution(int n, double timeBudget = 0) const;
 
     //Triangular Approximation Heuristic
-    void triangularAproxSolution();
+    TSPResult triangularAproxSolution();
 
     //Other heuristic
-    void otherHeuristic();
+    TSPResult otherHeuristic();
+    TSPResult multiStartNearestNeighbour(int id, double timeBudget = 0);
+
+    //Tour construction + 2-opt, over the fastest distance available
+    TSPResult improvedHeuristic(int id, TourConstruction construction, double timeBudget = 0);
+    TSPResult constructionHeuristic(int id, TourConstruction construction, double timeBudget = 0);
+    TSPResult spaceFillingCurveTour(int id);
+    TSPResult clusterDecomposition(int id, TourConstruction construction, double timeBudget = 0);
 
     // tsp for real world graphs
-    void backtrackingForRealWorld(Vertex<NodeInfo> *v, double currentWeight, double *minWeight, std::vector<NodeInfo> currentSol, std::vector<NodeInfo> *bestSol, int count, int tries,int &currentAttempt ,int targetId);
-    void tspRealWord(int id);
-    void tspRealWord2(int id);
+    void backtrackingForRealWorld(const std::vector<int> &prefix, WeightSum *minWeight, std::vector<NodeInfo> *bestSol, int tries, int &currentAttempt, SearchRun &run) const;
+    TSPResult tspRealWord(int id, double timeBudget = 0);
+    TSPResult tspRealWord2(int id, double timeBudget = 0);
+    std::vector<TSPResult> tspRealWordBatch(const std::vector<int> &ids, unsigned int threads, double timeBudget = 0);
+    Feasibility analyseFeasibility() const;
+
+    //Lower bound (Held-Karp) and optimality gap
+    double heldKarpLowerBound() const;
+    TSPResult withLowerBound(TSPResult result) const;
 
     //Auxiliary
+    void displayResult(const TSPResult &result) const;
     void displayPathFound(double minWeight, const std::vector<NodeInfo>& solution, std::chrono::duration<double> time) const;
-    void displayNoSolution(int error);
+    void displayNoSolution(int error) const;
+    std::vector<NodeInfo> expandRoute(const std::vector<NodeInfo> &tour) const;
+    TSPResult withRoute(TSPResult result) const;
 
     //setters
-    void setGraph(const Graph<NodeInfo>& graph);
-    void setIdToNode(const std::unordered_map<int, NodeInfo>& idToNode);
+    void setGraph(Graph<NodeInfo> &&graph);
+    void setIdToNode(std::unordered_map<int, NodeInfo> &&idToNode);
+    void setThreads(unsigned int threads);
+    void setDistanceCache(size_t maxBytes, bool singlePrecision);
+    void setHierarchy(bool enabled, const std::string &file);
+    void setOrdering(VertexOrdering ordering);
+    void setLowerBound(bool enabled, double targetGap);
+    void computeAllPairs();
 
     //getters
-    std::unordered_map<int, NodeInfo> getIdToNode() const;
-    Graph<NodeInfo> getGraph() const;
+    const std::unordered_map<int, NodeInfo> &getIdToNode() const;
+    const Graph<NodeInfo> &getGraph() const;
+    const GraphIndex &getIndex() const;
+    DistanceOracle &getOracle() const;
+    const ContractionHierarchy *getHierarchy() const;
+    const SolverDistanceMatrix *getEdgeMatrix() const;
+    const SolverDistanceMatrix *getCompleteMatrix() const;
+    const std::vector<std::vector<int>> &getCandidates() const;
+    double roadDistance(int u, int v) const;
 
 
     private:
         std::unordered_map<int, NodeInfo> idToNode;
         Graph<NodeInfo> graph;
+        LazyValue<const GraphIndex> index; // dropped when the graph changes
+        VertexOrdering ordering = VertexOrdering::ID; // how the index numbers the vertexes
+        LazyValue<DistanceOracle> oracle; // shortest path distances, same lifetime as the index
+        size_t oracleBytes = 64 << 20;
+        bool oracleSinglePrecision = false;
+        bool useHierarchy = false;
+        std::string hierarchyFile; // where the hierarchy is loaded from / saved to (empty to always build it)
+        LazyValue<const ContractionHierarchy> hierarchy;
+        LazyValue<const SolverDistanceMatrix> edgeMatrix; // only for dense graphs, same lifetime as the index
+        mutable bool edgeMatrixComplete = false; // every pair of vertexes has an edge in edgeMatrix
+        mutable std::shared_ptr<ContractionHierarchy::Query> hierarchyQuery; // of roadDistance, which takes turns on it
+        mutable std::mutex hierarchyQueryMutex;
+        LazyValue<const std::vector<std::vector<int>>> candidates; // neighbour lists of the local search, same lifetime as the index
+
+        unsigned int threads = 1; // threads the preprocessing stages may use
+
+        bool reportBound = false; // the results get the lower bound (and so their gap)
+        double targetGap = 0; // the time budgeted searches stop this close to the bound (0 to never stop early)
+        LazyValue<const double> lowerBound; // in graph units, same lifetime as the graph
+
+        template <class Distance>
+        TSPResult heuristicTour(const Distance &d, int start, TourConstruction construction, bool improve, SearchRun &run) const;
+        TSPResult runHeuristic(int id, TourConstruction construction, bool improve, double timeBudget);
+        template <class Distance>
+        double heldKarpOver(const Distance &d) const;
+        double targetBound() const;
+        bool gapReached(double cost, double bound) const;
+        WeightSum walkCost(const std::vector<int> &walk) const;
 };
 
 
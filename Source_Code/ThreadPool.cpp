@@ -0,0 +1,104 @@
+//
+// Created by lucas on 19/10/2026.
+//
+
+#include "ThreadPool.h"
+
+using namespace std;
+
+/**
+ * @file ThreadPool.cpp
+ * @brief Implementation of class ThreadPool.
+ */
+
+/**
+ * Starts the worker threads.
+ * Complexity: O(t) where t is the number of threads
+ * @param numThreads Number of workers (at least one is always created)
+ */
+ThreadPool::ThreadPool(unsigned int numThreads) {
+    if(numThreads == 0) numThreads = 1;
+    for(unsigned int i = 0; i < numThreads; i++){
+        workers.emplace_back(&ThreadPool::workerLoop, this);
+    }
+}
+
+/**
+ * Finishes the pending jobs and joins the workers.
+ * Complexity: O(t) where t is the number of threads (plus the pending jobs)
+ */
+ThreadPool::~ThreadPool() {
+    {
+        lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    jobAvailable.notify_all();
+    for(thread &worker : workers) worker.join();
+}
+
+/**
+ * Adds a job to the queue.
+ * Complexity: O(1)
+ * @param job Function to run in one of the workers
+ */
+void ThreadPool::submit(function<void()> job) {
+    {
+        lock_guard<std::mutex> lock(mutex);
+        jobs.push(std::move(job));
+    }
+    jobAvailable.notify_one();
+}
+
+/**
+ * Blocks until every submitted job has finished.
+ * Complexity: depends on the jobs
+ */
+void ThreadPool::wait() {
+    unique_lock<std::mutex> lock(mutex);
+    allDone.wait(lock, [this]{ return jobs.empty() && running == 0; });
+}
+
+/**
+ * Gets the number of workers.
+ * Complexity: O(1)
+ * @return Number of workers
+ */
+unsigned int ThreadPool::size() const {
+    return (unsigned int) workers.size();
+}
+
+/**
+ * Number of threads to use when the user doesn't choose one.
+ * Complexity: O(1)
+ * @return Number of hardware threads (1 if unknown)
+ */
+unsigned int ThreadPool::defaultThreads() {
+    unsigned int n = thread::hardware_concurrency();
+    return n == 0 ? 1 : n;
+}
+
+/**
+ * Loop run by each worker: takes jobs from the queue until the pool is destroyed.
+ * Complexity: depends on the jobs
+ */
+void ThreadPool::workerLoop() {
+    while(true){
+        function<void()> job;
+        {
+            unique_lock<std::mutex> lock(mutex);
+            jobAvailable.wait(lock, [this]{ return stopping || !jobs.empty(); });
+            if(jobs.empty()) return; // stopping and nothing left to do
+            job = std::move(jobs.front());
+            jobs.pop();
+            running++;
+        }
+
+        job();
+
+        {
+            lock_guard<std::mutex> lock(mutex);
+            running--;
+            if(jobs.empty() && running == 0) allDone.notify_all();
+        }
+    }
+}
@@ -0,0 +1,48 @@
+//
+// Created by lucas on 19/10/2026.
+//
+
+#ifndef PROJECT2_THREADPOOL_H
+#define PROJECT2_THREADPOOL_H
+
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+/**
+ * @file ThreadPool.h
+ * @brief Definition of class ThreadPool.
+ *
+ * \class ThreadPool
+ * Fixed set of worker threads that run the jobs submitted to it in FIFO order.
+ */
+class ThreadPool {
+public:
+    explicit ThreadPool(unsigned int numThreads);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool &) = delete;
+    ThreadPool &operator=(const ThreadPool &) = delete;
+
+    void submit(std::function<void()> job);
+    void wait();
+    unsigned int size() const;
+
+    static unsigned int defaultThreads();
+
+private:
+    void workerLoop();
+
+    std::vector<std::thread> workers;
+    std::queue<std::function<void()>> jobs;
+    std::mutex mutex;
+    std::condition_variable jobAvailable;
+    std::condition_variable allDone;
+    unsigned int running = 0;
+    bool stopping = false;
+};
+
+#endif //PROJECT2_THREADPOOL_H
@@ -0,0 +1,379 @@
+//
+// Created by lucas on 19/10/2026.
+//
+
+#ifndef PROJECT2_TOURHEURISTICS_H
+#define PROJECT2_TOURHEURISTICS_H
+
+#include <algorithm>
+#include <limits>
+#include <utility>
+#include <vector>
+#include "TwoLevelTour.h"
+#include "UnionFind.h"
+
+/**
+ * @file TourHeuristics.h
+ * @brief Tour construction (nearest neighbour, spanning tree walk, greedy edge) and improvement (2-opt) heuristics,
+ * templated on a distance policy (see DistancePolicy.h).
+ *
+ * A tour is a vector with every vertex index once; the edge back to the first vertex is implicit.
+ */
+
+/**
+ * Builds a tour by always going to the closest unvisited vertex.
+ * Complexity: O(V^2) distance evaluations
+ * @tparam Distance Distance policy
+ * @param d Distances
+ * @param start Index of the first vertex
+ * @return The tour
+ */
+template <class Distance>
+std::vector<int> nearestNeighbourTour(const Distance &d, int start) {
+    int n = d.size();
+    std::vector<int> tour {start};
+    std::vector<int> unvisited;         // swap-removed, so each step only scans the vertexes left
+    for (int v = 0; v < n; v++) if (v != start) unvisited.push_back(v);
+
+    int current = start;
+    while (!unvisited.empty()) {
+        size_t best = 0;
+        double bestDistance = d(current, unvisited[0]);
+        for (size_t k = 1; k < unvisited.size(); k++) {
+            double distance = d(current, unvisited[k]);
+            if (distance < bestDistance || (distance == bestDistance && unvisited[k] < unvisited[best])) {
+                best = k;
+                bestDistance = distance;
+            }
+        }
+        current = unvisited[best];
+        tour.push_back(current);
+        unvisited[best] = unvisited.back();
+        unvisited.pop_back();
+    }
+    return tour;
+}
+
+/**
+ * Prim over a complete cost function: the minimum spanning tree of the vertexes (one can be left out).
+ * Complexity: O(V^2) cost evaluations
+ * @tparam Cost Callable returning the cost of the edge (u, v)
+ * @param n Number of vertexes
+ * @param cost Edge costs
+ * @param root Index of the root of the tree
+ * @param parentOf Where the parent of each vertex is stored (-1 for the root and the vertex left out)
+ * @param skip Index of a vertex left out of the tree (-1 for none)
+ * @return Order in which the vertexes were added to the tree
+ */
+template <class Cost>
+std::vector<int> minimumSpanningTree(int n, const Cost &cost, int root, std::vector<int> &parentOf, int skip = -1) {
+    std::vector<double> key(n, std::numeric_limits<double>::infinity());
+    std::vector<char> inTree(n, 0);
+    std::vector<int> order;
+    order.reserve(n);
+    parentOf.assign(n, -1);
+    if (skip != -1) inTree[skip] = 1;
+
+    key[root] = 0;
+    for (int added = skip == -1 ? 0 : 1; added < n; added++) {
+        int u = -1;
+        for (int v = 0; v < n; v++) {
+            if (!inTree[v] && (u == -1 || key[v] < key[u])) u = v;
+        }
+        inTree[u] = 1;
+        order.push_back(u);
+        for (int v = 0; v < n; v++) {
+            if (inTree[v]) continue;
+            double distance = cost(u, v);
+            if (distance < key[v]) {
+                key[v] = distance;
+                parentOf[v] = u;
+            }
+        }
+    }
+    return order;
+}
+
+/**
+ * Builds a tour by walking a minimum spanning tree (Prim over the complete distance) in pre-order: the
+ * triangular approximation, at most twice the optimal cost when the distance is metric.
+ * Complexity: O(V^2) distance evaluations
+ * @tparam Distance Distance policy
+ * @param d Distances
+ * @param root Index of the first vertex
+ * @return The tour
+ */
+template <class Distance>
+std::vector<int> spanningTreeTour(const Distance &d, int root) {
+    int n = d.size();
+    std::vector<int> parentOf;
+    std::vector<std::vector<int>> children(n);
+    for (int v : minimumSpanningTree(n, d, root, parentOf)) {
+        if (parentOf[v] != -1) children[parentOf[v]].push_back(v);
+    }
+
+    std::vector<int> tour;
+    std::vector<int> stack {root};
+    while (!stack.empty()) {
+        int v = stack.back();
+        stack.pop_back();
+        tour.push_back(v);
+        for (auto it = children[v].rbegin(); it != children[v].rend(); it++) stack.push_back(*it);
+    }
+    return tour;
+}
+
+/**
+ * Builds a tour by greedy matching: the candidate edges are taken by increasing weight, and each is kept if both
+ * its vertexes have fewer than two tour edges and it doesn't close a cycle (checked with a union-find). What is
+ * kept are paths (fragments), which are then chained by nearest neighbour between their ends. Unlike nearest
+ * neighbour, no vertex is left for last, so there are no long closing edges.
+ * Complexity: O(C α(V)) for the C candidates, plus O(F^2) distance evaluations for the F fragments
+ * @tparam Distance Distance policy
+ * @param d Distances (used to chain the fragments)
+ * @param candidates Edges that may be in the tour, by increasing weight
+ * @param start Index of the first vertex
+ * @return The tour
+ */
+template <class Distance>
+std::vector<int> greedyEdgeTour(const Distance &d, const std::vector<std::pair<int, int>> &candidates, int start) {
+    int n = d.size();
+    std::vector<int> ends(2 * (size_t) n, -1);   // tour neighbours of v are ends[2v] and ends[2v + 1]
+    std::vector<int> degree(n, 0);
+    UnionFind fragments(n);
+    for (const std::pair<int, int> &e : candidates) {
+        if (fragments.sets() == 1) break;
+        int u = e.first, v = e.second;
+        if (u == v || degree[u] == 2 || degree[v] == 2 || !fragments.unite(u, v)) continue;
+        ends[2 * u + degree[u]++] = v;
+        ends[2 * v + degree[v]++] = u;
+    }
+
+    //the fragments as vertex sequences, walked from one of their ends
+    std::vector<std::vector<int>> paths;
+    std::vector<char> placed(n, 0);
+    for (int v = 0; v < n; v++) {
+        if (placed[v] || degree[v] == 2) continue;
+        std::vector<int> path;
+        int previous = -1, current = v;
+        while (current != -1) {
+            path.push_back(current);
+            placed[current] = 1;
+            int next = ends[2 * current] != previous ? ends[2 * current] : ends[2 * current + 1];
+            previous = current;
+            current = next;
+        }
+        paths.push_back(path);
+    }
+
+    //chains the fragments: from the end of the tour so far to the closest end of another fragment
+    std::vector<int> tour = paths[0];
+    std::vector<char> used(paths.size(), 0);
+    used[0] = 1;
+    for (size_t k = 1; k < paths.size(); k++) {
+        int tail = tour.back();
+        size_t best = 0;
+        bool reversed = false;
+        double bestDistance = std::numeric_limits<double>::infinity();
+        for (size_t f = 0; f < paths.size(); f++) {
+            if (used[f]) continue;
+            double front = d(tail, paths[f].front()), back = d(tail, paths[f].back());
+            if (best == 0 || std::min(front, back) < bestDistance) {
+                best = f;
+                reversed = back < front;
+                bestDistance = std::min(front, back);
+            }
+        }
+        used[best] = 1;
+        if (reversed) tour.insert(tour.end(), paths[best].rbegin(), paths[best].rend());
+        else tour.insert(tour.end(), paths[best].begin(), paths[best].end());
+    }
+
+    std::rotate(tour.begin(), std::find(tour.begin(), tour.end(), start), tour.end());
+    return tour;
+}
+
+/**
+ * Calculates the cost of a tour, including the edge back to the first vertex.
+ * Complexity: O(V) distance evaluations
+ * @tparam Distance Distance policy
+ * @param d Distances
+ * @param tour The tour
+ * @return Cost
+ */
+template <class Distance>
+double tourCost(const Distance &d, const std::vector<int> &tour) {
+    double cost = 0;
+    for (size_t i = 0; i < tour.size(); i++) cost += d(tour[i], tour[(i + 1) % tour.size()]);
+    return cost;
+}
+
+/**
+ * Improves a tour with 2-opt moves: replaces the edges (a, b) and (c, e) by (a, c) and (b, e), reversing the
+ * path between them, while that makes the tour cheaper. For each a, the best move is applied.
+ * The first vertex of the tour stays in place.
+ * Complexity: O(V^2) distance evaluations per pass
+ * @tparam Distance Distance policy
+ * @tparam Stop Callable given the cost of the current tour and returning true when the search must stop
+ * (checked once per vertex)
+ * @param d Distances
+ * @param tour The tour (changed in place)
+ * @param stop When to stop
+ * @return Number of moves applied
+ */
+template <class Distance, class Stop>
+long long twoOpt(const Distance &d, std::vector<int> &tour, Stop stop) {
+    int n = (int) tour.size();
+    long long moves = 0;
+    double cost = tourCost(d, tour);
+    bool improved = n >= 4;
+    while (improved) {
+        improved = false;
+        for (int i = 0; i < n - 2; i++) {
+            if (stop(cost)) return moves;
+            int a = tour[i], b = tour[i + 1];
+            double ab = d(a, b);
+            double bestGain = 1e-9;
+            int bestJ = -1;
+            for (int j = i + 2; j < n; j++) {
+                if (i == 0 && j == n - 1) continue; //the two edges share a vertex
+                int c = tour[j], e = tour[(j + 1) % n];
+                double gain = ab + d(c, e) - d(a, c) - d(b, e);
+                if (gain > bestGain) {
+                    bestGain = gain;
+                    bestJ = j;
+                }
+            }
+            if (bestJ != -1) {
+                std::reverse(tour.begin() + i + 1, tour.begin() + bestJ + 1);
+                cost -= bestGain;
+                moves++;
+                improved = true;
+            }
+        }
+    }
+    return moves;
+}
+
+/**
+ * Improves a path whose two ends stay in place (e.g. a piece of a longer tour) with 2-opt moves, like twoOpt
+ * but without the edge that would close the path into a cycle.
+ * Complexity: O(V^2) distance evaluations per pass
+ * @tparam Distance Distance policy
+ * @param d Distances
+ * @param path The path (changed in place)
+ * @return Number of moves applied
+ */
+template <class Distance>
+long long twoOptPath(const Distance &d, std::vector<int> &path) {
+    int n = (int) path.size();
+    long long moves = 0;
+    bool improved = n >= 4;
+    while (improved) {
+        improved = false;
+        for (int i = 0; i + 3 < n; i++) {
+            int a = path[i], b = path[i + 1];
+            double ab = d(a, b);
+            double bestGain = 1e-9;
+            int bestJ = -1;
+            for (int j = i + 2; j + 1 < n; j++) {
+                int c = path[j], e = path[j + 1];
+                double gain = ab + d(c, e) - d(a, c) - d(b, e);
+                if (gain > bestGain) {
+                    bestGain = gain;
+                    bestJ = j;
+                }
+            }
+            if (bestJ != -1) {
+                std::reverse(path.begin() + i + 1, path.begin() + bestJ + 1);
+                moves++;
+                improved = true;
+            }
+        }
+    }
+    return moves;
+}
+
+/**
+ * 2-opt over neighbour lists, for large tours: a move is only looked for between a vertex and its candidates
+ * (its closest vertexes), and only from the vertexes whose tour edges changed recently (the others are skipped,
+ * "don't look bits"). The moves are applied on a TwoLevelTour, so each costs O(sqrt(V)) instead of O(V).
+ * For a vertex a, its candidate c and their successors b and e, the move replaces (a, b) and (c, e) by (a, c) and
+ * (b, e); the same with the predecessors. The candidates of a are tried by increasing distance, stopping once
+ * d(a, c) is not below d(a, b) (no move can gain then).
+ * The first vertex of the tour stays in place.
+ * Complexity: O(V * k) distance evaluations per round over the active vertexes, O(sqrt(V)) per move
+ * @tparam Distance Distance policy
+ * @tparam Stop Callable given the cost of the current tour and returning true when the search must stop
+ * (checked once per vertex)
+ * @param d Distances
+ * @param tour The tour (changed in place)
+ * @param candidates candidates[v] are the vertexes whose edges to v may enter the tour
+ * @param stop When to stop
+ * @return Number of moves applied
+ */
+template <class Distance, class Stop>
+long long twoOptNeighbours(const Distance &d, std::vector<int> &tour, const std::vector<std::vector<int>> &candidates, Stop stop) {
+    int n = (int) tour.size();
+    if (n < 4) return 0;
+    int start = tour[0];
+
+    //candidates by increasing distance
+    std::vector<std::vector<std::pair<double, int>>> near(n);
+    for (int v = 0; v < n; v++) {
+        for (int c : candidates[v]) {
+            if (c != v) near[v].push_back({d(v, c), c});
+        }
+        std::sort(near[v].begin(), near[v].end());
+    }
+
+    TwoLevelTour list(tour);
+    double cost = tourCost(d, tour);
+    long long moves = 0;
+    std::vector<int> active(tour.rbegin(), tour.rend());
+    std::vector<char> queued(n, 1);
+    auto activate = [&active, &queued](int v){
+        if (!queued[v]) {
+            queued[v] = 1;
+            active.push_back(v);
+        }
+    };
+
+    while (!active.empty()) {
+        if (stop(cost)) break;
+        int a = active.back();
+        active.pop_back();
+        queued[a] = 0;
+
+        bool moved = false;
+        for (int forward = 1; forward >= 0 && !moved; forward--) {
+            int b = forward ? list.next(a) : list.prev(a);
+            double ab = d(a, b);
+            for (const std::pair<double, int> &candidate : near[a]) {
+                if (candidate.first >= ab) break;
+                int c = candidate.second;
+                int e = forward ? list.next(c) : list.prev(c);
+                if (c == b || e == a) continue;
+                double gain = ab + d(c, e) - candidate.first - d(b, e);
+                if (gain <= 1e-9) continue;
+
+                //forward: a b ... c e becomes a c ... b e; backward: b a ... e c becomes b e ... a c
+                if (forward) list.reverse(b, c);
+                else list.reverse(a, e);
+                cost -= gain;
+                moves++;
+                moved = true;
+                activate(a);
+                activate(b);
+                activate(c);
+                activate(e);
+                break;
+            }
+        }
+    }
+
+    tour = list.order(start);
+    return moves;
+}
+
+#endif //PROJECT2_TOURHEURISTICS_H
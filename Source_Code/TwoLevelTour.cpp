@@ -0,0 +1,274 @@
+//
+// Created by lucas on 19/10/2026.
+//
+
+#include "TwoLevelTour.h"
+#include <algorithm>
+#include <cmath>
+
+using namespace std;
+
+/**
+ * @file TwoLevelTour.cpp
+ * @brief Implementation of class TwoLevelTour.
+ */
+
+/**
+ * Creates the structure for a tour.
+ * Complexity: O(V)
+ * @param tour Every vertex index once, in tour order
+ */
+TwoLevelTour::TwoLevelTour(const vector<int> &tour) : n((int) tour.size()), segmentOf(tour.size()), slotOf(tour.size()) {
+    segmentSize = max(8, (int) sqrt((double) n));
+    rebuild(tour);
+}
+
+/**
+ * Splits a tour in segments of segmentSize vertexes (used once, by the constructor).
+ * Complexity: O(V)
+ * @param tour Every vertex index once, in tour order
+ */
+void TwoLevelTour::rebuild(const vector<int> &tour) {
+    segments.clear();
+    for(int i = 0; i < n; i += segmentSize){
+        Segment segment;
+        segment.vertexes.assign(tour.begin() + i, tour.begin() + min(n, i + segmentSize));
+        segments.push_back(segment);
+    }
+    sequence.resize(segments.size());
+    for(size_t s = 0; s < segments.size(); s++){
+        sequence[s] = (int) s;
+        for(size_t k = 0; k < segments[s].vertexes.size(); k++){
+            segmentOf[segments[s].vertexes[k]] = (int) s;
+            slotOf[segments[s].vertexes[k]] = (int) k;
+        }
+    }
+    renumber();
+}
+
+/**
+ * Updates the rank and the first position of every segment after the sequence changed.
+ * Complexity: O(S) where S is the number of segments
+ */
+void TwoLevelTour::renumber() {
+    rankOf.resize(segments.size());
+    startOf.resize(segments.size());
+    int start = 0;
+    for(size_t r = 0; r < sequence.size(); r++){
+        rankOf[sequence[r]] = (int) r;
+        startOf[sequence[r]] = start;
+        start += (int) segments[sequence[r]].vertexes.size();
+    }
+}
+
+/**
+ * Gets the first vertex of a segment, in tour order.
+ * Complexity: O(1)
+ * @param s Segment
+ * @return First vertex
+ */
+int TwoLevelTour::first(int s) const {
+    return segments[s].reversed ? segments[s].vertexes.back() : segments[s].vertexes.front();
+}
+
+/**
+ * Gets the last vertex of a segment, in tour order.
+ * Complexity: O(1)
+ * @param s Segment
+ * @return Last vertex
+ */
+int TwoLevelTour::last(int s) const {
+    return segments[s].reversed ? segments[s].vertexes.front() : segments[s].vertexes.back();
+}
+
+/**
+ * Gets the number of vertexes of the tour.
+ * Complexity: O(1)
+ * @return Size of the tour
+ */
+int TwoLevelTour::size() const {
+    return n;
+}
+
+/**
+ * Gets the vertex after another.
+ * Complexity: O(1)
+ * @param v Vertex
+ * @return Next vertex
+ */
+int TwoLevelTour::next(int v) const {
+    const Segment &segment = segments[segmentOf[v]];
+    int k = slotOf[v] + (segment.reversed ? -1 : 1);
+    if(k >= 0 && k < (int) segment.vertexes.size()) return segment.vertexes[k];
+    return first(sequence[(rankOf[segmentOf[v]] + 1) % sequence.size()]);
+}
+
+/**
+ * Gets the vertex before another.
+ * Complexity: O(1)
+ * @param v Vertex
+ * @return Previous vertex
+ */
+int TwoLevelTour::prev(int v) const {
+    const Segment &segment = segments[segmentOf[v]];
+    int k = slotOf[v] + (segment.reversed ? 1 : -1);
+    if(k >= 0 && k < (int) segment.vertexes.size()) return segment.vertexes[k];
+    return last(sequence[(rankOf[segmentOf[v]] + sequence.size() - 1) % sequence.size()]);
+}
+
+/**
+ * Gets the position of a vertex in the tour (the positions change with the reversals).
+ * Complexity: O(1)
+ * @param v Vertex
+ * @return Position in [0, V)
+ */
+int TwoLevelTour::position(int v) const {
+    int s = segmentOf[v];
+    int offset = segments[s].reversed ? (int) segments[s].vertexes.size() - 1 - slotOf[v] : slotOf[v];
+    return startOf[s] + offset;
+}
+
+/**
+ * Checks if b is on the path that goes forward from a to c (both included).
+ * Complexity: O(1)
+ * @param a First vertex of the path
+ * @param b Vertex
+ * @param c Last vertex of the path
+ * @return true if b is on the path
+ */
+bool TwoLevelTour::between(int a, int b, int c) const {
+    int pa = position(a), pb = position(b), pc = position(c);
+    if(pa <= pc) return pa <= pb && pb <= pc;
+    return pb >= pa || pb <= pc;
+}
+
+/**
+ * Makes a vertex the first of its segment, moving the vertexes before it in the segment to a new segment.
+ * Complexity: O(sqrt(V))
+ * @param v Vertex
+ */
+void TwoLevelTour::split(int v) {
+    int s = segmentOf[v];
+    if(first(s) == v) return;
+
+    //the vertexes before v (in tour order) go to a new segment (an emptied one if there is any), placed before s
+    int h;
+    if(!unused.empty()){
+        h = unused.back();
+        unused.pop_back();
+    }
+    else{
+        h = (int) segments.size();
+        segments.emplace_back();
+    }
+    Segment &head = segments[h];
+    vector<int> &vertexes = segments[s].vertexes;
+    head.reversed = segments[s].reversed;
+    if(!segments[s].reversed){
+        head.vertexes.assign(vertexes.begin(), vertexes.begin() + slotOf[v]);
+        vertexes.erase(vertexes.begin(), vertexes.begin() + slotOf[v]);
+    }
+    else{
+        head.vertexes.assign(vertexes.begin() + slotOf[v] + 1, vertexes.end());
+        vertexes.erase(vertexes.begin() + slotOf[v] + 1, vertexes.end());
+    }
+    for(size_t k = 0; k < segments[h].vertexes.size(); k++){
+        segmentOf[segments[h].vertexes[k]] = h;
+        slotOf[segments[h].vertexes[k]] = (int) k;
+    }
+    for(size_t k = 0; k < segments[s].vertexes.size(); k++) slotOf[segments[s].vertexes[k]] = (int) k;
+
+    sequence.insert(sequence.begin() + rankOf[s], h);
+    renumber();
+}
+
+/**
+ * Reverses the path that goes forward from a to b. In a cycle that is the same as reversing the rest of the tour,
+ * so the path that doesn't go over the end of the sequence is the one reversed.
+ * Complexity: O(sqrt(V)) amortized
+ * @param a First vertex of the path
+ * @param b Last vertex of the path
+ */
+void TwoLevelTour::reverse(int a, int b) {
+    if(position(a) > position(b)){
+        int from = next(b), to = prev(a);
+        if(from == a) return; //the whole tour
+        a = from;
+        b = to;
+        if(position(a) > position(b)) return; //empty complement
+    }
+
+    split(a);
+    int after = next(b);
+    if(after != first(sequence[0])) split(after);
+
+    int ra = rankOf[segmentOf[a]], rb = rankOf[segmentOf[b]];
+    std::reverse(sequence.begin() + ra, sequence.begin() + rb + 1);
+    for(int r = ra; r <= rb; r++) segments[sequence[r]].reversed = !segments[sequence[r]].reversed;
+    renumber();
+
+    //the splits leave small segments behind: merged once there are three times as many as planned
+    if(sequence.size() > 3 * ((size_t) n / segmentSize + 1)) merge();
+}
+
+/**
+ * Merges runs of consecutive segments that fit in segmentSize vertexes together. Afterwards any two neighbouring
+ * segments have more than segmentSize vertexes, so there are at most 2 * V / segmentSize + 1 of them.
+ * Complexity: O(S + m) where S is the number of segments and m the number of vertexes moved
+ */
+void TwoLevelTour::merge() {
+    vector<int> merged;
+    size_t r = 0;
+    while(r < sequence.size()){
+        //the run starting at r
+        size_t end = r + 1, total = segments[sequence[r]].vertexes.size();
+        while(end < sequence.size() && total + segments[sequence[end]].vertexes.size() <= (size_t) segmentSize){
+            total += segments[sequence[end]].vertexes.size();
+            end++;
+        }
+
+        int target = sequence[r];
+        if(end - r > 1){
+            //the first segment of the run takes the others, in tour order
+            Segment &segment = segments[target];
+            if(segment.reversed){
+                std::reverse(segment.vertexes.begin(), segment.vertexes.end());
+                segment.reversed = false;
+                for(size_t k = 0; k < segment.vertexes.size(); k++) slotOf[segment.vertexes[k]] = (int) k;
+            }
+            for(size_t q = r + 1; q < end; q++){
+                Segment &other = segments[sequence[q]];
+                if(other.reversed) std::reverse(other.vertexes.begin(), other.vertexes.end());
+                for(int v : other.vertexes){
+                    segmentOf[v] = target;
+                    slotOf[v] = (int) segment.vertexes.size();
+                    segment.vertexes.push_back(v);
+                }
+                other.vertexes.clear();
+                other.reversed = false;
+                unused.push_back(sequence[q]);
+            }
+        }
+        merged.push_back(target);
+        r = end;
+    }
+    sequence = merged;
+    renumber();
+}
+
+/**
+ * Gets the tour as a sequence.
+ * Complexity: O(V)
+ * @param start First vertex
+ * @return Every vertex, in tour order from start
+ */
+vector<int> TwoLevelTour::order(int start) const {
+    vector<int> res;
+    res.reserve(n);
+    int v = start;
+    for(int k = 0; k < n; k++){
+        res.push_back(v);
+        v = next(v);
+    }
+    return res;
+}
@@ -0,0 +1,59 @@
+//
+// Created by lucas on 19/10/2026.
+//
+
+#ifndef PROJECT2_TWOLEVELTOUR_H
+#define PROJECT2_TWOLEVELTOUR_H
+
+#include <vector>
+
+/**
+ * @file TwoLevelTour.h
+ * @brief Definition of class TwoLevelTour.
+ *
+ * \class TwoLevelTour
+ * Tour over the vertex indexes with O(1) next / prev / between queries and O(sqrt(V)) reversals, for local
+ * search moves (2-opt, Or-opt, Lin-Kernighan) on large tours, where reversing a vector costs O(V) per move.
+ * The tour is split in about sqrt(V) segments. Each segment keeps its vertexes in an array and a reversed bit,
+ * and the segments are kept in tour order in a short array: reversing a path splits the segments at its ends
+ * (O(sqrt(V)) to copy the part that moves) and then reverses the order of the segments in between and flips their
+ * bits (O(sqrt(V)) segments). When the splits have left too many segments, the small neighbouring ones are merged,
+ * at most O(V) once every O(sqrt(V)) reversals.
+ */
+class TwoLevelTour {
+public:
+    explicit TwoLevelTour(const std::vector<int> &tour);
+
+    int size() const;
+    int next(int v) const;
+    int prev(int v) const;
+    int position(int v) const;
+    bool between(int a, int b, int c) const;
+    void reverse(int a, int b);
+    std::vector<int> order(int start) const;
+
+private:
+    struct Segment {
+        std::vector<int> vertexes;
+        bool reversed = false;
+    };
+
+    void rebuild(const std::vector<int> &tour);
+    void split(int v);
+    void merge();
+    void renumber();
+    int first(int s) const;
+    int last(int s) const;
+
+    int n;
+    int segmentSize;                    // size of the segments of the initial tour, and the most a merge gathers
+    std::vector<Segment> segments;
+    std::vector<int> sequence;          // segments in tour order
+    std::vector<int> unused;            // segments emptied by merge, reused by split
+    std::vector<int> rankOf;            // position of each segment in sequence
+    std::vector<int> startOf;           // position in the tour of the first vertex of each segment
+    std::vector<int> segmentOf;         // segment of each vertex
+    std::vector<int> slotOf;            // position of each vertex in the array of its segment
+};
+
+#endif //PROJECT2_TWOLEVELTOUR_H
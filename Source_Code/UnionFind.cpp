@@ -0,0 +1,76 @@
+//
+// Created by lucas on 19/10/2026.
+//
+
+#include "UnionFind.h"
+
+using namespace std;
+
+/**
+ * @file UnionFind.cpp
+ * @brief Implementation of class UnionFind.
+ */
+
+/**
+ * Creates n sets with one index each.
+ * Complexity: O(n)
+ * @param n Number of indexes
+ */
+UnionFind::UnionFind(int n) : link(n), setSize(n, 1), count(n) {
+    for(int v = 0; v < n; v++) link[v] = v;
+}
+
+/**
+ * Gets the representative of the set of an index, pointing every index on the way straight to it.
+ * Complexity: O(α(n)) amortized
+ * @param v Index
+ * @return Representative of the set of v
+ */
+int UnionFind::find(int v) {
+    int root = v;
+    while(link[root] != root) root = link[root];
+    while(link[v] != root){
+        int next = link[v];
+        link[v] = root;
+        v = next;
+    }
+    return root;
+}
+
+/**
+ * Joins the sets of two indexes (the smaller set goes under the larger one).
+ * Complexity: O(α(n)) amortized
+ * @param a First index
+ * @param b Second index
+ * @return false if they were already in the same set
+ */
+bool UnionFind::unite(int a, int b) {
+    a = find(a);
+    b = find(b);
+    if(a == b) return false;
+    if(setSize[a] < setSize[b]) swap(a, b);
+    link[b] = a;
+    setSize[a] += setSize[b];
+    count--;
+    return true;
+}
+
+/**
+ * Checks if two indexes are in the same set.
+ * Complexity: O(α(n)) amortized
+ * @param a First index
+ * @param b Second index
+ * @return true if they are in the same set
+ */
+bool UnionFind::connected(int a, int b) {
+    return find(a) == find(b);
+}
+
+/**
+ * Gets the number of sets.
+ * Complexity: O(1)
+ * @return Number of disjoint sets
+ */
+int UnionFind::sets() const {
+    return count;
+}
@@ -0,0 +1,33 @@
+//
+// Created by lucas on 19/10/2026.
+//
+
+#ifndef PROJECT2_UNIONFIND_H
+#define PROJECT2_UNIONFIND_H
+
+#include <vector>
+
+/**
+ * @file UnionFind.h
+ * @brief Definition of class UnionFind.
+ *
+ * \class UnionFind
+ * Disjoint sets over the indexes [0, n), with union by size and path compression, so a sequence of m
+ * operations takes O(m α(n)) (α being the inverse of Ackermann's function, below 5 for any real n).
+ */
+class UnionFind {
+public:
+    explicit UnionFind(int n);
+
+    int find(int v);
+    bool unite(int a, int b);
+    bool connected(int a, int b);
+    int sets() const;
+
+private:
+    std::vector<int> link;      // link[v] is the next vertex towards the representative (itself for a representative)
+    std::vector<int> setSize;   // size of the set of each representative
+    int count;
+};
+
+#endif //PROJECT2_UNIONFIND_H
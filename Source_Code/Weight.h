@@ -0,0 +1,73 @@
+//
+// Created by lucas on 19/10/2026.
+//
+
+#ifndef PROJECT2_WEIGHT_H
+#define PROJECT2_WEIGHT_H
+
+#include <cmath>
+#include <cstdint>
+#include <limits>
+
+/**
+ * @file Weight.h
+ * @brief Definition of the weight types of the graphs and of the Weight type chosen at compile time.
+ *
+ * WeightTraits<W> gives, for each weight type W, its infinity, the type used to add weights up (Sum) and the
+ * conversion from / to metres, the unit of the datasets. The integer types are fixed-point: int32_t counts
+ * centimetres (up to 21474 km per edge) and int64_t millimetres; their sums are int64_t, so they are exact.
+ *
+ * Weight is the weight type of Graph, Edge and Vertex (by default) and of the solvers, chosen with the CMake
+ * option TSP_WEIGHT_TYPE (double, float, int32 or int64). The results (TSPResult) are always in metres.
+ */
+
+template <class W>
+struct WeightTraits;
+
+template <>
+struct WeightTraits<double> {
+    typedef double Sum;
+    static double infinity() { return std::numeric_limits<double>::infinity(); }
+    static double fromMetres(double metres) { return metres; }
+    static double toMetres(double w) { return w; }
+};
+
+template <>
+struct WeightTraits<float> {
+    typedef double Sum;
+    static float infinity() { return std::numeric_limits<float>::infinity(); }
+    static float fromMetres(double metres) { return (float) metres; }
+    static double toMetres(double w) { return w; }
+};
+
+template <>
+struct WeightTraits<int32_t> {
+    typedef int64_t Sum;
+    static const int SCALE = 100;
+    static int32_t infinity() { return std::numeric_limits<int32_t>::max(); }
+    static int32_t fromMetres(double metres) { return (int32_t) std::llround(metres * SCALE); }
+    static double toMetres(double w) { return w / SCALE; }
+};
+
+template <>
+struct WeightTraits<int64_t> {
+    typedef int64_t Sum;
+    static const int SCALE = 1000;
+    static int64_t infinity() { return std::numeric_limits<int64_t>::max(); }
+    static int64_t fromMetres(double metres) { return std::llround(metres * SCALE); }
+    static double toMetres(double w) { return w / SCALE; }
+};
+
+#if defined(TSP_WEIGHT_INT32)
+typedef int32_t Weight;
+#elif defined(TSP_WEIGHT_INT64)
+typedef int64_t Weight;
+#elif defined(TSP_WEIGHT_FLOAT)
+typedef float Weight;
+#else
+typedef double Weight;
+#endif
+
+typedef WeightTraits<Weight>::Sum WeightSum;
+
+#endif //PROJECT2_WEIGHT_H
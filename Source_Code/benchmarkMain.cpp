@@ -0,0 +1,579 @@
+//
+// Created by lucas on 19/10/2026.
+//
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <random>
+#include <thread>
+#include <unordered_map>
+#include "Benchmark.h"
+#include "ContractionHierarchy.h"
+#include "DistanceOracle.h"
+#include "DistancePolicy.h"
+#include "Graph.h"
+#include "MutablePriorityQueue.h"
+#include "SearchStats.h"
+#include "ShortestPaths.h"
+#include "TSP.h"
+#include "TourHeuristics.h"
+#include "TwoLevelTour.h"
+
+using namespace std;
+
+/**
+ * @file benchmarkMain.cpp
+ * @brief Micro-benchmarks for the graph, priority queue and distance primitives and for the solvers.
+ *
+ * Usage: Benchmark [--max-size N] [--filter text]
+ * Sizes go from 10^2 up to --max-size (default 10^5, at most 10^6) in powers of ten.
+ */
+
+static volatile double sink; // keeps the compiler from discarding the measured work
+
+/**
+ * Builds the info of the synthetic vertexes: random coordinates inside mainland Portugal.
+ * Complexity: O(n)
+ * @param n Number of vertexes
+ * @param rng Random generator
+ * @return Info of each vertex, indexed by id
+ */
+static vector<NodeInfo> syntheticNodes(size_t n, mt19937 &rng) {
+    uniform_real_distribution<double> lat(37.0, 42.0);
+    uniform_real_distribution<double> lon(-9.5, -6.2);
+    vector<NodeInfo> nodes;
+    nodes.reserve(n);
+    for(size_t i = 0; i < n; i++){
+        nodes.emplace_back((int) i, "", lon(rng), lat(rng));
+    }
+    return nodes;
+}
+
+/**
+ * Synthetic edge list: a ring (so the graph is always Hamiltonian) plus one random chord per vertex.
+ * Complexity: O(n)
+ * @param nodes Vertexes of the graph
+ * @param rng Random generator
+ * @return Pairs of vertex ids with the haversine distance between them
+ */
+static vector<pair<pair<int, int>, double>> syntheticEdges(const vector<NodeInfo> &nodes, mt19937 &rng) {
+    size_t n = nodes.size();
+    uniform_int_distribution<size_t> pick(0, n - 1);
+    vector<pair<pair<int, int>, double>> edges;
+    edges.reserve(2 * n);
+    for(size_t i = 0; i < n; i++){
+        size_t next = (i + 1) % n;
+        size_t chord = pick(rng);
+        if(chord == i || chord == next) chord = (i + n / 2) % n;
+        for(size_t j : {next, chord}){
+            const NodeInfo &a = nodes[i], &b = nodes[j];
+            edges.push_back({{(int) i, (int) j}, haversine(a.getLatitude(), a.getLongitude(), b.getLatitude(), b.getLongitude())});
+        }
+    }
+    return edges;
+}
+
+// ========================================================== GRAPH =================================================================================
+
+static void benchmarkGraph(BenchmarkRun &run) {
+    size_t n = run.size();
+    mt19937 rng(42);
+    vector<NodeInfo> nodes = syntheticNodes(n, rng);
+    auto edges = syntheticEdges(nodes, rng);
+    Graph<NodeInfo> g;
+
+    run.measure("addVertex", n, [&]{
+        for(const NodeInfo &info : nodes) g.addVertex(info);
+    });
+
+    run.measure("addBidirectionalEdge", edges.size(), [&]{
+        for(const auto &e : edges) g.addBidirectionalEdge(nodes[e.first.first], nodes[e.first.second], e.second);
+    });
+
+    vector<size_t> queries(min<size_t>(n, 100000));
+    uniform_int_distribution<size_t> pick(0, n - 1);
+    for(size_t &q : queries) q = pick(rng);
+
+    vector<Vertex<NodeInfo> *> found(queries.size());
+    run.measure("findVertex", queries.size(), [&]{
+        for(size_t i = 0; i < queries.size(); i++) found[i] = g.findVertex(nodes[queries[i]]);
+    });
+
+    run.measure("findEdge", queries.size(), [&]{
+        double total = 0;
+        for(size_t i = 0; i < queries.size(); i++){
+            Vertex<NodeInfo> *v = found[i];
+            Vertex<NodeInfo> *w = g.findVertex(nodes[(queries[i] + 1) % n]);
+            Edge<NodeInfo> *e = findEdge(v, w);
+            if(e != nullptr) total += e->getWeight();
+        }
+        sink = total;
+    });
+
+    auto vertexSet = g.getVertexSet();
+    unsigned long long adjVisited = 0;
+    for(Vertex<NodeInfo> *v : vertexSet) adjVisited += v->getAdj().size();
+    run.measure("getAdj iteration (per edge)", adjVisited, [&]{
+        double total = 0;
+        for(Vertex<NodeInfo> *v : vertexSet){
+            for(Edge<NodeInfo> *e : v->getAdj()) total += e->getWeight();
+        }
+        sink = total;
+    });
+
+    size_t calls = max<size_t>(1, 100000 / n);
+    run.measure("getVertexSet (per call)", calls, [&]{
+        size_t total = 0;
+        for(size_t i = 0; i < calls; i++) total += g.getVertexSet().size();
+        sink = (double) total;
+    });
+}
+
+// =================================================== MUTABLE PRIORITY QUEUE =========================================================================
+
+/**
+ * \struct QueueItem
+ * Element with the fields MutablePriorityQueue needs (the search state is no longer kept in the graph vertexes).
+ */
+struct QueueItem {
+    double dist = 0;
+    int queueIndex = 0;
+
+    bool operator<(const QueueItem &other) const { return dist < other.dist; }
+};
+
+static void benchmarkMutablePriorityQueue(BenchmarkRun &run) {
+    size_t n = run.size();
+    mt19937 rng(7);
+    uniform_real_distribution<double> key(0, 1e6);
+
+    vector<QueueItem> items(n);
+    for(QueueItem &item : items) item.dist = key(rng);
+
+    MutablePriorityQueue<QueueItem> q;
+    run.measure("insert", n, [&]{
+        for(QueueItem &item : items) q.insert(&item);
+    });
+
+    run.measure("decreaseKey", n, [&]{
+        for(QueueItem &item : items){
+            item.dist /= 2;
+            q.decreaseKey(&item);
+        }
+    });
+
+    run.measure("extractMin", n, [&]{
+        double total = 0;
+        while(!q.empty()) total += q.extractMin()->dist;
+        sink = total;
+    });
+}
+
+// ========================================================== DISTANCES =================================================================================
+
+static void benchmarkHaversine(BenchmarkRun &run) {
+    size_t n = run.size();
+    mt19937 rng(3);
+    vector<NodeInfo> nodes = syntheticNodes(n, rng);
+
+    run.measure("haversine", n, [&]{
+        double total = 0;
+        for(size_t i = 0; i < n; i++){
+            const NodeInfo &a = nodes[i], &b = nodes[(i + 1) % n];
+            total += haversine(a.getLatitude(), a.getLongitude(), b.getLatitude(), b.getLongitude());
+        }
+        sink = total;
+    });
+}
+
+/**
+ * Full Dijkstra searches over the index of a road-like grid whose ids are shuffled, with each vertex ordering.
+ * Complexity: O(n log n)
+ * @param run Run of the benchmark
+ */
+static void benchmarkOrdering(BenchmarkRun &run) {
+    size_t n = run.size();
+    int side = (int) sqrt((double) n);
+    n = (size_t) side * side;
+    mt19937 rng(31);
+    vector<int> ids(n);
+    for(size_t i = 0; i < n; i++) ids[i] = (int) i;
+    shuffle(ids.begin(), ids.end(), rng);
+    uniform_real_distribution<double> weight(50, 500);
+
+    Graph<NodeInfo> g;
+    vector<NodeInfo> nodes;
+    for(size_t i = 0; i < n; i++) nodes.emplace_back(ids[i], "", -9.0 + 0.001 * (i % side), 38.0 + 0.001 * (i / side));
+    for(const NodeInfo &info : nodes) g.addVertex(info);
+    for(size_t i = 0; i < n; i++){
+        if(i % side + 1 < (size_t) side) g.addBidirectionalEdge(nodes[i], nodes[i + 1], weight(rng));
+        if(i + side < n) g.addBidirectionalEdge(nodes[i], nodes[i + side], weight(rng));
+    }
+
+    const int searches = 4;
+    vector<pair<string, VertexOrdering>> orderings {{"id", VertexOrdering::ID}, {"hilbert", VertexOrdering::HILBERT},
+                                                    {"rcm", VertexOrdering::RCM}};
+    for(const auto &ordering : orderings){
+        GraphIndex index(g, ordering.second);
+        DijkstraSearch search(index);
+        run.measure("dijkstra, " + ordering.first + " order (per vertex)", searches * n, [&]{
+            for(int s = 0; s < searches; s++){
+                search.start(index.indexOf(ids[s * n / searches]));
+                while(search.settleNext() != -1);
+            }
+        });
+    }
+}
+
+// ========================================================== SOLVERS =================================================================================
+
+/**
+ * Search statistics of a run, in the format used by the benchmark table.
+ * @param stats Statistics of the run
+ * @return Text with the counters
+ */
+static string statsCounters(const SearchStats &stats) {
+    string text = "expanded=" + to_string(stats.nodesExpanded) + " prunes=" + to_string(stats.boundPrunes)
+                  + " incumbents=" + to_string(stats.incumbentUpdates) + " maxDepth=" + to_string(stats.depthHistogram.size());
+    if(stats.tries != 0) text += " tries=" + to_string(stats.tries);
+    if(stats.startsWalked != 0) text += " startsWalked=" + to_string(stats.startsWalked);
+    if(stats.triesGoingBack != 0) text += " triesGoingBack=" + to_string(stats.triesGoingBack);
+    return text;
+}
+
+static void benchmarkBacktracking(BenchmarkRun &run) {
+    size_t n = run.size();
+    mt19937 rng(11);
+    vector<NodeInfo> nodes = syntheticNodes(n, rng);
+    Graph<NodeInfo> g;
+    unordered_map<int, NodeInfo> idToNode;
+    for(const NodeInfo &info : nodes){
+        g.addVertex(info);
+        idToNode.emplace(info.getId(), info);
+    }
+    for(size_t i = 0; i < n; i++){
+        for(size_t j = i + 1; j < n; j++){
+            const NodeInfo &a = nodes[i], &b = nodes[j];
+            g.addBidirectionalEdge(a, b, haversine(a.getLatitude(), a.getLongitude(), b.getLatitude(), b.getLongitude()));
+        }
+    }
+
+    TSP tsp;
+    tsp.setGraph(std::move(g));
+    tsp.setIdToNode(std::move(idToNode));
+
+    TSPResult result;
+    run.measure("backtrackingSolution (per run)", 1, [&]{
+        result = tsp.backtrackingSolution(0);
+    });
+    run.annotate(statsCounters(result.stats));
+}
+
+static void benchmarkRealWorld(BenchmarkRun &run) {
+    size_t n = run.size();
+    mt19937 rng(13);
+    vector<NodeInfo> nodes = syntheticNodes(n, rng);
+    Graph<NodeInfo> g;
+    unordered_map<int, NodeInfo> idToNode;
+    for(const NodeInfo &info : nodes){
+        g.addVertex(info);
+        idToNode.emplace(info.getId(), info);
+    }
+    for(const auto &e : syntheticEdges(nodes, rng)){
+        g.addBidirectionalEdge(nodes[e.first.first], nodes[e.first.second], e.second);
+    }
+
+    TSP tsp;
+    tsp.setGraph(std::move(g));
+    tsp.setIdToNode(std::move(idToNode));
+
+    TSPResult result;
+    run.measure("tspRealWord (per run)", 1, [&]{
+        result = tsp.tspRealWord(0);
+    });
+    run.annotate(statsCounters(result.stats) + (result.found ? " found" : " not-found"));
+
+    run.measure("tspRealWord2 (per run)", 1, [&]{
+        result = tsp.tspRealWord2(0);
+    });
+    run.annotate(statsCounters(result.stats) + (result.found ? " found" : " not-found"));
+}
+
+/**
+ * Nearest neighbour from every vertex of a complete graph, on one thread and on all of them.
+ * Complexity: O(n^2 * k) where k is the number of visited neighbours skipped per step
+ * @param run Run of the benchmark
+ */
+static void benchmarkMultiStart(BenchmarkRun &run) {
+    size_t n = run.size();
+    mt19937 rng(37);
+    vector<NodeInfo> nodes = syntheticNodes(n, rng);
+    Graph<NodeInfo> g;
+    unordered_map<int, NodeInfo> idToNode;
+    for(const NodeInfo &info : nodes){
+        g.addVertex(info);
+        idToNode.emplace(info.getId(), info);
+    }
+    for(size_t i = 0; i < n; i++){
+        for(size_t j = i + 1; j < n; j++){
+            const NodeInfo &a = nodes[i], &b = nodes[j];
+            g.addBidirectionalEdge(a, b, haversine(a.getLatitude(), a.getLongitude(), b.getLatitude(), b.getLongitude()));
+        }
+    }
+
+    TSP tsp;
+    tsp.setGraph(std::move(g));
+    tsp.setIdToNode(std::move(idToNode));
+    tsp.otherHeuristic(); //builds the index
+
+    TSPResult result;
+    vector<unsigned int> threadCounts {1};
+    if(thread::hardware_concurrency() > 1) threadCounts.push_back(thread::hardware_concurrency());
+    for(unsigned int threads : threadCounts){
+        tsp.setThreads(threads);
+        run.measure("multiStartNearestNeighbour, " + to_string(threads) + " threads (per run)", 1, [&]{
+            result = tsp.multiStartNearestNeighbour(0);
+        });
+        run.annotate(statsCounters(result.stats) + " cost=" + to_string((long long) result.cost));
+    }
+}
+
+/**
+ * Tour representations under 2-opt moves: reversals of random paths on a vector (shorter side) and on a TwoLevelTour.
+ * Complexity: O(q * n) for the vector, O(q * sqrt(n)) for the TwoLevelTour
+ * @param run Run of the benchmark
+ */
+static void benchmarkTourReversal(BenchmarkRun &run) {
+    int n = (int) run.size();
+    mt19937 rng(41);
+    vector<int> tour(n);
+    for(int i = 0; i < n; i++) tour[i] = i;
+    shuffle(tour.begin(), tour.end(), rng);
+    vector<pair<int, int>> paths(10000);
+    uniform_int_distribution<int> pick(0, n - 1);
+    for(pair<int, int> &path : paths) path = {pick(rng), pick(rng)};
+
+    vector<int> array(tour), position(n);
+    for(int i = 0; i < n; i++) position[array[i]] = i;
+    run.measure("vector reverse (per move)", paths.size(), [&]{
+        for(const pair<int, int> &path : paths){
+            int i = min(position[path.first], position[path.second]), j = max(position[path.first], position[path.second]);
+            if(j - i > n / 2){
+                //the rest of the cycle is shorter
+                int from = j + 1, to = i - 1 + n;
+                for(; from < to; from++, to--) swap(array[from % n], array[to % n]);
+                for(int k = j + 1; k < i + n; k++) position[array[k % n]] = k % n;
+            }
+            else{
+                std::reverse(array.begin() + i, array.begin() + j + 1);
+                for(int k = i; k <= j; k++) position[array[k]] = k;
+            }
+        }
+    });
+
+    TwoLevelTour list(tour);
+    run.measure("TwoLevelTour reverse (per move)", paths.size(), [&]{
+        for(const pair<int, int> &path : paths) list.reverse(path.first, path.second);
+    });
+
+    long long checksum = 0;
+    run.measure("TwoLevelTour next/between (per query)", paths.size(), [&]{
+        for(const pair<int, int> &path : paths) checksum += list.next(path.first) + list.between(path.first, path.second, list.prev(path.first));
+    });
+    run.annotate("checksum=" + to_string(checksum));
+}
+
+/**
+ * Shortest path distance oracle: queries whose sources mostly repeat (hits) and whose sources don't (misses).
+ * Complexity: O(n * E log E)
+ * @param run Run of the benchmark
+ */
+static void benchmarkOracle(BenchmarkRun &run) {
+    size_t n = run.size();
+    mt19937 rng(17);
+    vector<NodeInfo> nodes = syntheticNodes(n, rng);
+    Graph<NodeInfo> g;
+    for(const NodeInfo &info : nodes) g.addVertex(info);
+    for(const auto &e : syntheticEdges(nodes, rng)){
+        g.addBidirectionalEdge(nodes[e.first.first], nodes[e.first.second], e.second);
+    }
+
+    GraphIndex index(g);
+    const int hotSources = 8;
+    DistanceOracle oracle(index, hotSources * n * sizeof(double), false);
+    uniform_int_distribution<int> vertex(0, (int) n - 1);
+    vector<int> hot;
+    for(int i = 0; i < hotSources; i++) hot.push_back(i);
+    oracle.prefetch(hot, 1);
+
+    run.measure("oracle hit", n, [&]{
+        double total = 0;
+        for(size_t i = 0; i < n; i++) total += oracle.distance((int) i % hotSources, vertex(rng));
+        sink = total;
+    });
+
+    const size_t misses = 16;
+    run.measure("oracle miss (Dijkstra row)", misses, [&]{
+        double total = 0;
+        for(size_t i = 0; i < misses; i++) total += oracle.distance(vertex(rng), vertex(rng));
+        sink = total;
+    });
+}
+
+/**
+ * Contraction hierarchy: preprocessing, point to point queries and a many-to-many table.
+ * Uses a grid with random weights, closer to a road network than the ring with random chords.
+ * Complexity: see ContractionHierarchy
+ * @param run Run of the benchmark
+ */
+static void benchmarkHierarchy(BenchmarkRun &run) {
+    int side = (int) sqrt((double) run.size());
+    size_t n = (size_t) side * side;
+    mt19937 rng(19);
+    uniform_real_distribution<double> weight(100, 1000);
+    Graph<NodeInfo> g;
+    for(int i = 0; i < (int) n; i++) g.addVertex(NodeInfo(i));
+    for(int i = 0; i < (int) n; i++){
+        if(i % side + 1 < side) g.addBidirectionalEdge(NodeInfo(i), NodeInfo(i + 1), weight(rng));
+        if(i + side < (int) n) g.addBidirectionalEdge(NodeInfo(i), NodeInfo(i + side), weight(rng));
+    }
+    GraphIndex index(g);
+    uniform_int_distribution<int> vertex(0, (int) n - 1);
+
+    unique_ptr<ContractionHierarchy> ch;
+    run.measure("preprocessing (per build)", 1, [&]{
+        ch.reset(new ContractionHierarchy(index));
+    });
+    run.annotate("upward edges " + to_string(ch->numEdges()));
+
+    ContractionHierarchy::Query query(*ch);
+    const size_t queries = 1000;
+    run.measure("bidirectional query", queries, [&]{
+        double total = 0;
+        for(size_t i = 0; i < queries; i++) total += query.distance(vertex(rng), vertex(rng));
+        sink = total;
+    });
+
+    vector<int> ends;
+    for(int i = 0; i < 100; i++) ends.push_back(vertex(rng));
+    run.measure("table 100x100 (per entry)", ends.size() * ends.size(), [&]{
+        sink = ch->table(ends, ends, 1)[1];
+    });
+}
+
+/**
+ * All-pairs shortest paths with the blocked Floyd-Warshall, with one thread and with one per hardware thread.
+ * Complexity: O(n^3)
+ * @param run Run of the benchmark
+ */
+static void benchmarkFloydWarshall(BenchmarkRun &run) {
+    size_t n = run.size();
+    mt19937 rng(23);
+    vector<NodeInfo> nodes = syntheticNodes(n, rng);
+    Graph<NodeInfo> g;
+    for(const NodeInfo &info : nodes) g.addVertex(info);
+    for(const auto &e : syntheticEdges(nodes, rng)){
+        g.addBidirectionalEdge(nodes[e.first.first], nodes[e.first.second], e.second);
+    }
+
+    double cells = (double) n * n * n;
+    run.measure("floyd-warshall 1 thread (per n^3/1000)", (size_t) (cells / 1000), [&]{
+        g.floydWarshall(1);
+    });
+    unsigned int threads = ThreadPool::defaultThreads();
+    run.measure("floyd-warshall all threads (per n^3/1000)", (size_t) (cells / 1000), [&]{
+        g.floydWarshall(threads);
+    });
+    run.annotate("threads " + to_string(threads));
+}
+
+/**
+ * Nearest neighbour tour (n^2 distance evaluations) with each distance policy, on a complete graph.
+ * Complexity: O(n^2)
+ * @param run Run of the benchmark
+ */
+static void benchmarkDistancePolicies(BenchmarkRun &run) {
+    size_t n = run.size();
+    mt19937 rng(29);
+    vector<NodeInfo> nodes = syntheticNodes(n, rng);
+    Graph<NodeInfo> g;
+    for(const NodeInfo &info : nodes) g.addVertex(info);
+    for(size_t i = 0; i < n; i++){
+        for(size_t j = i + 1; j < n; j++){
+            const NodeInfo &a = nodes[i], &b = nodes[j];
+            g.addBidirectionalEdge(a, b, haversine(a.getLatitude(), a.getLongitude(), b.getLatitude(), b.getLongitude()));
+        }
+    }
+    GraphIndex index(g);
+    SolverDistanceMatrix matrix = buildEdgeMatrix<SolverDistanceMatrix>(index);
+
+    size_t evaluations = n * (n - 1) / 2;
+    run.measure("nearest neighbour, edge lookup (per evaluation)", evaluations, [&]{
+        sink = nearestNeighbourTour(EdgeDistance(index), 0).back();
+    });
+    run.measure("nearest neighbour, matrix (per evaluation)", evaluations, [&]{
+        sink = nearestNeighbourTour(MatrixDistance(matrix), 0).back();
+    });
+    GeodesicDistance geodesic(index);
+    run.measure("nearest neighbour, geodesic (per evaluation)", evaluations, [&]{
+        sink = nearestNeighbourTour(geodesic, 0).back();
+    });
+    EuclideanDistance euclidean(index);
+    run.measure("nearest neighbour, euclidean (per evaluation)", evaluations, [&]{
+        sink = nearestNeighbourTour(euclidean, 0).back();
+    });
+
+    vector<int> tour = nearestNeighbourTour(MatrixDistance(matrix), 0);
+    long long moves = 0;
+    run.measure("2-opt, matrix (per run)", 1, [&]{
+        vector<int> improved = tour;
+        moves = twoOpt(MatrixDistance(matrix), improved, [](double){ return false; });
+    });
+    run.annotate("moves=" + to_string(moves));
+}
+
+/**
+ * Registers every benchmark case. New backends add their cases here, under their own group name.
+ * @param harness Harness where the cases are registered
+ */
+static void registerBenchmarks(BenchmarkHarness &harness) {
+    harness.registerCase("Graph", "adjacency-list", 1000000, benchmarkGraph);
+    harness.registerCase("MutablePriorityQueue", "QueueItem", 1000000, benchmarkMutablePriorityQueue);
+    harness.registerCase("Distance", "geodesic", 1000000, benchmarkHaversine);
+    harness.registerCase("TSP", "complete", {8, 10, 12}, benchmarkBacktracking);
+    harness.registerCase("TSP", "ring+chords", 1000, benchmarkRealWorld);
+    harness.registerCase("TSP", "multi-start nearest neighbour", {300, 900}, benchmarkMultiStart);
+    harness.registerCase("Distance", "shortest-path oracle", 100000, benchmarkOracle);
+    harness.registerCase("Distance", "contraction hierarchy", 100000, benchmarkHierarchy);
+    harness.registerCase("Distance", "all-pairs", {256, 512, 1024}, benchmarkFloydWarshall);
+    harness.registerCase("Distance", "policies", {500, 1000}, benchmarkDistancePolicies);
+    harness.registerCase("Distance", "vertex orderings", 1000000, benchmarkOrdering);
+    harness.registerCase("Tour", "random reversals", 1000000, benchmarkTourReversal);
+}
+
+int main(int argc, char *argv[]) {
+    size_t maxSize = 100000;
+    string filter;
+
+    for(int i = 1; i < argc; i++){
+        if(strcmp(argv[i], "--max-size") == 0 && i + 1 < argc){
+            maxSize = min<size_t>(stoul(argv[++i]), 1000000);
+        }
+        else if(strcmp(argv[i], "--filter") == 0 && i + 1 < argc){
+            filter = argv[++i];
+        }
+        else{
+            cerr << "Usage: " << argv[0] << " [--max-size N] [--filter text]\n";
+            return EXIT_FAILURE;
+        }
+    }
+
+    vector<size_t> sizes;
+    for(size_t n = 100; n <= maxSize; n *= 10) sizes.push_back(n);
+
+    BenchmarkHarness harness;
+    registerBenchmarks(harness);
+    harness.run(sizes, filter, cout);
+    return EXIT_SUCCESS;
+}
@@ -2,10 +2,12 @@
 // Created by lucas on 03/05/2024.
 //
 #include <iostream>
-#include "graph.h"
+#include "Graph.h"
 #include "parse.h"
 #include "TSP.h"
 #include "Menu.h"
+#include "Batch.h"
+#include "Service.h"
 
 /**
  * @file main.cpp
@@ -18,9 +20,32 @@
  * \subsection Instructions How to use
  * You will be asked to choose an option. All the options will appear on the screen with a number near them.
  * Then, just type the number corresponding to the option you want to execute.
+ *
+ * \subsection Batch Batch mode
+ * When started with options (e.g. main --dataset medium:* --algorithms triangular,other --threads 4 --format csv)
+ * the menu is skipped: every dataset is loaded once and the chosen algorithms are run on it. See Batch.h.
+ *
+ * \subsection Service Service mode
+ * main --serve keeps the datasets in memory and answers JSON-lines requests from stdin or a Unix domain socket. See Service.h.
  */
 
-int main(){
+int main(int argc, char *argv[]){
+    if(isServiceInvocation(argc, argv)){
+        ServiceOptions options;
+        if(parseServiceOptions(argc, argv, options) != 0){
+            return EXIT_FAILURE;
+        }
+        return runService(options);
+    }
+
+    if(isBatchInvocation(argc, argv)){
+        BatchOptions options;
+        if(parseBatchOptions(argc, argv, options) != 0){
+            return EXIT_FAILURE;
+        }
+        return runBatch(options);
+    }
+
     Menu menu;
     return menu.mainMenu();
 }
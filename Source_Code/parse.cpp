@@ -7,6 +7,8 @@
 #include "parse.h"
 #include <fstream>
 #include <sstream>
+#include <climits>
+#include <cstdlib>
 using namespace std;
 /**
  * @file parse.cpp
@@ -149,9 +151,68 @@ void readNodes(DataSetSelection dataSetSelection, std::unordered_map<int, NodeIn
             filepath += "/nodes.csv";
     }
 
+    readNodesFile(filepath, numbOfNodes, idToInfo, graph);
+}
+
+/**
+ * Reads the edges from the selected dataset
+ * Complexity: O(n) where n is the number of lines in the file
+ * @param dataSetSelection DataSet selected
+ * @param idToInfo Map to store the info of each vertex
+ * @param graph The graph to insert the vertexes
+ * @param n Option selected by the user
+ */
+void readEdges(DataSetSelection dataSetSelection,std::unordered_map<int, NodeInfo> &idToInfo, Graph<NodeInfo> &graph, int n){
+    string filepath;
+    switch (dataSetSelection) {
+        case DataSetSelection::SMALL :
+            return;
+        case DataSetSelection::MEDIUM :
+            selectDataSet(DataSetSelection::MEDIUM, &filepath);
+            selectMediumGraph(n, &filepath);
+            break;
+        case DataSetSelection::BIG:
+            selectDataSet(DataSetSelection::BIG, &filepath);
+            selectBigGraph(n, &filepath);
+            filepath += "/edges.csv";
+    }
+
+    readEdgesFile(filepath, dataSetSelection != DataSetSelection::MEDIUM, idToInfo, graph);
+}
+
+/**
+ * Reads the edges and nodes from the small dataset.
+ * Complexity: O(n) where n is the number of lines in the file
+ * @param idToInfo Map to store the info of each vertex
+ * @param graph The graph to insert the vertexes
+ * @param n Option selected by the user
+ */
+void readNodesAndEdgesSmallGraphs(std::unordered_map<int, NodeInfo> &idToInfo, Graph<NodeInfo> &graph, int n){
+    string filepath;
+
+    //Select small graph
+    selectDataSet(DataSetSelection::SMALL, &filepath);
+    selectSmallGraph(n,&filepath);
+
+    readSmallGraphFile(filepath, idToInfo, graph);
+}
+
+// ============================================================ FILE READERS ========================================================================
+
+/**
+ * Reads the nodes (id,longitude,latitude) from a nodes file.
+ * Complexity: O(n) where n is the number of lines in the file
+ * @param filepath Path to the nodes file
+ * @param numbOfNodes Maximum number of nodes to read
+ * @param idToInfo Map to store the info of each vertex
+ * @param graph The graph to insert the vertexes
+ * @return false if the file could not be opened
+ */
+bool readNodesFile(const std::string &filepath, int numbOfNodes, std::unordered_map<int, NodeInfo> &idToInfo, Graph<NodeInfo> &graph){
     ifstream file(filepath);
     if(!file.is_open()){
         cerr << "Error: Unable to open the file." << '\n';
+        return false;
     }
 
     string line;
@@ -185,40 +246,28 @@ void readNodes(DataSetSelection dataSetSelection, std::unordered_map<int, NodeIn
         graph.addVertex(info);
     }
 
-
+    return true;
 }
 
 /**
- * Reads the edges from the selected dataset
+ * Reads the edges (origin,destination,distance) from an edges file.
  * Complexity: O(n) where n is the number of lines in the file
- * @param dataSetSelection DataSet selected
- * @param idToInfo Map to store the info of each vertex
- * @param graph The graph to insert the vertexes
- * @param n Option selected by the user
+ * @param filepath Path to the edges file
+ * @param hasHeader If the first line of the file is a header
+ * @param idToInfo Map with the info of each vertex
+ * @param graph The graph to insert the edges
+ * @return false if the file could not be opened
  */
-void readEdges(DataSetSelection dataSetSelection,std::unordered_map<int, NodeInfo> &idToInfo, Graph<NodeInfo> &graph, int n){
-    string filepath;
-    switch (dataSetSelection) {
-        case DataSetSelection::SMALL :
-            return;
-        case DataSetSelection::MEDIUM :
-            selectDataSet(DataSetSelection::MEDIUM, &filepath);
-            selectMediumGraph(n, &filepath);
-            break;
-        case DataSetSelection::BIG:
-            selectDataSet(DataSetSelection::BIG, &filepath);
-            selectBigGraph(n, &filepath);
-            filepath += "/edges.csv";
-    }
-
+bool readEdgesFile(const std::string &filepath, bool hasHeader, std::unordered_map<int, NodeInfo> &idToInfo, Graph<NodeInfo> &graph){
     ifstream file(filepath);
     if(!file.is_open()){
         cerr << "Error: Unable to open the file." << '\n';
+        return false;
     }
 
     string line;
 
-    if (dataSetSelection != DataSetSelection::MEDIUM) getline(file,line); //header line
+    if (hasHeader) getline(file,line); //header line
 
     int origID, destID;
     double distance;
@@ -240,28 +289,25 @@ void readEdges(DataSetSelection dataSetSelection,std::unordered_map<int, NodeInf
         distance = stod(line.substr(0,it));
 
         //add Edge to the graph
-        graph.addBidirectionalEdge(idToInfo[origID],idToInfo[destID],distance);
+        graph.addBidirectionalEdge(idToInfo[origID],idToInfo[destID],WeightTraits<Weight>::fromMetres(distance));
     }
 
+    return true;
 }
 
 /**
- * Reads the edges and nodes from the small dataset.
+ * Reads a small graph file, where each line has an edge and, optionally, the labels of its vertexes.
  * Complexity: O(n) where n is the number of lines in the file
+ * @param filepath Path to the file
  * @param idToInfo Map to store the info of each vertex
- * @param graph The graph to insert the vertexes
- * @param n Option selected by the user
+ * @param graph The graph to insert the vertexes and edges
+ * @return false if the file could not be opened
  */
-void readNodesAndEdgesSmallGraphs(std::unordered_map<int, NodeInfo> &idToInfo, Graph<NodeInfo> &graph, int n){
-    string filepath;
-
-    //Select small graph
-    selectDataSet(DataSetSelection::SMALL, &filepath);
-    selectSmallGraph(n,&filepath);
-
+bool readSmallGraphFile(const std::string &filepath, std::unordered_map<int, NodeInfo> &idToInfo, Graph<NodeInfo> &graph){
     ifstream file(filepath);
     if(!file.is_open()){
         cerr << "Error: Unable to open the file." << '\n';
+        return false;
     }
 
     string line;
@@ -318,8 +364,87 @@ void readNodesAndEdgesSmallGraphs(std::unordered_map<int, NodeInfo> &idToInfo, G
         graph.addVertex(destInfo);
 
         //add Edge to the graph
-        graph.addBidirectionalEdge(origInfo,destInfo,distance);
+        graph.addBidirectionalEdge(origInfo,destInfo,WeightTraits<Weight>::fromMetres(distance));
     }
+
+    return true;
 }
 
+/**
+ * Loads a dataset given by name or by path:
+ * "small:N", "medium:N" and "big:N" select the same graphs as the menu (N is the menu option);
+ * a directory is read as a Real-World graph (nodes.csv and edges.csv);
+ * a file named edges_N.csv is read as a fully connected graph with the first N nodes of the nodes.csv next to it;
+ * any other file is read as a small graph.
+ * Complexity: O(n) where n is the number of lines in the files
+ * @param dataset Name or path of the dataset
+ * @param idToInfo Map to store the info of each vertex
+ * @param graph The graph to insert the vertexes and edges
+ * @param edgesFile Where the path of the edges file read is stored (optional), e.g. to keep derived data next to it
+ * @return false if the dataset doesn't exist or could not be read
+ */
+bool loadDataset(const std::string &dataset, std::unordered_map<int, NodeInfo> &idToInfo, Graph<NodeInfo> &graph, std::string *edgesFile){
+    string ignored;
+    if(edgesFile == nullptr) edgesFile = &ignored;
+
+    size_t colon = dataset.find(':');
+    string kind = colon == string::npos ? "" : dataset.substr(0, colon);
+    if(kind == "small" || kind == "medium" || kind == "big"){
+        int n;
+        try {
+            n = stoi(dataset.substr(colon + 1));
+        } catch (const exception &) {
+            return false;
+        }
+
+        if(kind == "small" && n >= 1 && n <= 3){
+            string filepath;
+            selectDataSet(DataSetSelection::SMALL, &filepath);
+            selectSmallGraph(n, &filepath);
+            *edgesFile = filepath;
+            return readSmallGraphFile(filepath, idToInfo, graph);
+        }
+        if((kind == "medium" && n >= 1 && n <= 12) || (kind == "big" && n >= 1 && n <= 3)){
+            DataSetSelection selection = kind == "medium" ? DataSetSelection::MEDIUM : DataSetSelection::BIG;
+            string nodesPath, edgesPath;
+            int numbOfNodes = 10000;
+            selectDataSet(selection, &edgesPath);
+            if(selection == DataSetSelection::MEDIUM){
+                nodesPath = edgesPath + "/nodes.csv";
+                numbOfNodes = selectMediumGraph(n, &edgesPath);
+            }
+            else{
+                selectBigGraph(n, &edgesPath);
+                nodesPath = edgesPath + "/nodes.csv";
+                edgesPath += "/edges.csv";
+            }
+            *edgesFile = edgesPath;
+            return readNodesFile(nodesPath, numbOfNodes, idToInfo, graph)
+                && readEdgesFile(edgesPath, selection != DataSetSelection::MEDIUM, idToInfo, graph);
+        }
+        return false;
+    }
+
+    //Real-World graph directory
+    if(ifstream(dataset + "/nodes.csv").good()){
+        *edgesFile = dataset + "/edges.csv";
+        return readNodesFile(dataset + "/nodes.csv", INT_MAX, idToInfo, graph)
+            && readEdgesFile(dataset + "/edges.csv", true, idToInfo, graph);
+    }
+
+    //fully connected graph: edges_N.csv with the nodes in the same directory
+    size_t slash = dataset.find_last_of("/\\");
+    string directory = slash == string::npos ? "." : dataset.substr(0, slash);
+    string filename = slash == string::npos ? dataset : dataset.substr(slash + 1);
+    if(filename.compare(0, 6, "edges_") == 0){
+        int numbOfNodes = atoi(filename.c_str() + 6);
+        if(numbOfNodes > 0){
+            *edgesFile = dataset;
+            return readNodesFile(directory + "/nodes.csv", numbOfNodes, idToInfo, graph)
+                && readEdgesFile(dataset, false, idToInfo, graph);
+        }
+    }
 
+    *edgesFile = dataset;
+    return readSmallGraphFile(dataset, idToInfo, graph);
+}
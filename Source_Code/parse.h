@@ -23,4 +23,9 @@ void selectBigGraph(int n, std::string *filepath);
 void readNodesAndEdgesSmallGraphs(std::unordered_map<int, NodeInfo> &idToInfo, Graph<NodeInfo> &graph, int n);
 void readNodes(DataSetSelection dataSetSelection, std::unordered_map<int, NodeInfo> &idToInfo, Graph<NodeInfo> &graph, int n);
 void readEdges(DataSetSelection dataSetSelection,std::unordered_map<int, NodeInfo> &idToInfo, Graph<NodeInfo> &graph, int n);
+
+bool readNodesFile(const std::string &filepath, int numbOfNodes, std::unordered_map<int, NodeInfo> &idToInfo, Graph<NodeInfo> &graph);
+bool readEdgesFile(const std::string &filepath, bool hasHeader, std::unordered_map<int, NodeInfo> &idToInfo, Graph<NodeInfo> &graph);
+bool readSmallGraphFile(const std::string &filepath, std::unordered_map<int, NodeInfo> &idToInfo, Graph<NodeInfo> &graph);
+bool loadDataset(const std::string &dataset, std::unordered_map<int, NodeInfo> &idToInfo, Graph<NodeInfo> &graph, std::string *edgesFile = nullptr);
 #endif //PROJECT2_PARSE_H
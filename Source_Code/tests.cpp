@@ -5,6 +5,24 @@
 #include <gtest/gtest.h>
 #include "TSP.h"
 #include "parse.h"
+#include "ShortestPaths.h"
+#include "DistanceOracle.h"
+#include "DistanceMatrix.h"
+#include "DistancePolicy.h"
+#include "TourHeuristics.h"
+#include "HeldKarp.h"
+#include "InsertionHeuristics.h"
+#include "Delaunay.h"
+#include "ContractionHierarchy.h"
+#include "SolverState.h"
+#include "Batch.h"
+#include "Service.h"
+#include <thread>
+#include <fstream>
+#include <sstream>
+#include <random>
+#include <set>
+#include <type_traits>
 
 TEST(Backtracking, Backtracking_small_graph_3){
     Graph<NodeInfo> g;
@@ -13,24 +31,141 @@ TEST(Backtracking, Backtracking_small_graph_3){
     readNodes(DataSetSelection::SMALL, map, g,n);
     readEdges(DataSetSelection::SMALL,map,g,n);
 
-    NodeInfo info = map.find(0)->second;
-    Vertex<NodeInfo> *start = g.findVertex(info);
-    double currentWeight = 0;
-    double minWeight = LONG_LONG_MAX;
-    std::vector<NodeInfo> currentSol {start->getInfo()};
+    WeightSum minWeight = WeightTraits<WeightSum>::infinity();
     std::vector<NodeInfo> bestSol;
-    int count = 1;
 
     TSP tsp;
-    tsp.setGraph(g);
-    tsp.setIdToNode(map);
+    tsp.setGraph(std::move(g));
+    tsp.setIdToNode(std::move(map));
 
-    tsp.backtrackingSolutionDFS(start, currentWeight, &minWeight, currentSol, &bestSol, count);
+    tsp.backtrackingSolutionDFS({tsp.getIndex().indexOf(0)}, &minWeight, &bestSol);
 
-    EXPECT_EQ(minWeight, 2600);
+    EXPECT_EQ(WeightTraits<Weight>::toMetres(minWeight), 2600);
 
 }
 
+TEST(Backtracking, engine_matches_brute_force_from_any_start){
+    //random graph with 8 vertexes and ~70% of the edges
+    int n = 8;
+    std::mt19937 rng(9);
+    std::uniform_int_distribution<int> weight(1, 100);
+    Graph<NodeInfo> g;
+    std::unordered_map<int, NodeInfo> map;
+    for(int i = 0; i < n; i++){
+        g.addVertex(NodeInfo(i));
+        map.emplace(i, NodeInfo(i));
+    }
+    std::vector<std::vector<double>> w(n, std::vector<double>(n, -1));
+    for(int i = 0; i < n; i++){
+        for(int j = i + 1; j < n; j++){
+            if(rng() % 10 < 7){
+                w[i][j] = w[j][i] = weight(rng);
+                g.addBidirectionalEdge(NodeInfo(i), NodeInfo(j), WeightTraits<Weight>::fromMetres(w[i][j]));
+            }
+        }
+    }
+
+    std::vector<int> order {1, 2, 3, 4, 5, 6, 7};
+    double best = -1;
+    do{
+        double cost = 0;
+        int previous = 0;
+        for(int v : order){
+            if(w[previous][v] < 0 || cost < 0) cost = -1;
+            else cost += w[previous][v];
+            previous = v;
+        }
+        if(cost >= 0 && w[previous][0] >= 0 && (best < 0 || cost + w[previous][0] < best)) best = cost + w[previous][0];
+    } while(std::next_permutation(order.begin(), order.end()));
+    ASSERT_GT(best, 0);
+
+    TSP tsp;
+    tsp.setGraph(std::move(g));
+    tsp.setIdToNode(std::move(map));
+    for(int start : {0, 3}){
+        TSPResult result = tsp.backtrackingSolution(start);
+        ASSERT_TRUE(result.found);
+        EXPECT_EQ(result.cost, best);
+        ASSERT_EQ(result.path.size(), (size_t) n + 1);
+        EXPECT_EQ(result.path.front().getId(), start);
+        EXPECT_EQ(result.path.back().getId(), start);
+    }
+}
+
+TEST(SolverState, concurrent_solves_share_one_graph){
+    StampedArray<int> parentOf(4, -1);
+    parentOf.set(2, 0);
+    parentOf.clear();
+    EXPECT_EQ(parentOf.get(2), -1);
+    VisitedSet visited(130);
+    visited.set(129);
+    visited.set(129);
+    EXPECT_TRUE(visited.test(129));
+    EXPECT_EQ(visited.size(), 1);
+
+    //random geometric graph: every solver only reads it and keeps its own state, so several threads can solve on
+    //it at once, also while the index, the oracle and the neighbour lists are built the first time
+    auto build = [](TSP &tsp){
+        std::mt19937 rng(5);
+        std::uniform_real_distribution<double> coordinate(0, 0.1);
+        Graph<NodeInfo> g;
+        std::unordered_map<int, NodeInfo> map;
+        std::vector<NodeInfo> nodes;
+        for(int i = 0; i < 200; i++){
+            nodes.emplace_back(i, "", -8.6 + coordinate(rng), 41.1 + coordinate(rng));
+            g.addVertex(nodes.back());
+            map.emplace(i, nodes.back());
+        }
+        for(int i = 0; i < 200; i++){
+            for(int j = i + 1; j < 200; j++){
+                const NodeInfo &a = nodes[i], &b = nodes[j];
+                double d = haversine(a.getLatitude(), a.getLongitude(), b.getLatitude(), b.getLongitude());
+                if(d < 4000) g.addBidirectionalEdge(a, b, WeightTraits<Weight>::fromMetres(d));
+            }
+        }
+        tsp.setGraph(std::move(g));
+        tsp.setIdToNode(std::move(map));
+        tsp.setLowerBound(true, 0);
+    };
+    auto solve = [](TSP &tsp, int algorithm){
+        switch(algorithm){
+            case 0: return tsp.triangularAproxSolution();
+            case 1: return tsp.otherHeuristic();
+            case 2: return tsp.withLowerBound(tsp.improvedHeuristic(0, TourConstruction::NEAREST_NEIGHBOUR));
+            case 3: return tsp.tspRealWord2(0);
+            default: return tsp.clusterDecomposition(0, TourConstruction::NEAREST_NEIGHBOUR);
+        }
+    };
+    const int algorithms = 5, threads = 4;
+
+    TSP reference;
+    build(reference);
+    std::vector<TSPResult> expected;
+    for(int a = 0; a < algorithms; a++) expected.push_back(solve(reference, a));
+
+    TSP tsp;
+    build(tsp);
+    std::vector<std::vector<TSPResult>> results(threads, std::vector<TSPResult>(algorithms));
+    std::vector<std::thread> workers;
+    for(int t = 0; t < threads; t++){
+        workers.emplace_back([t, &tsp, &results, &solve](){
+            for(int round = 0; round < 3; round++){
+                //each thread in its own order, so the first uses of the derived objects overlap
+                for(int a = 0; a < algorithms; a++) results[t][(a + t) % algorithms] = solve(tsp, (a + t) % algorithms);
+            }
+        });
+    }
+    for(std::thread &worker : workers) worker.join();
+    for(int t = 0; t < threads; t++){
+        for(int a = 0; a < algorithms; a++){
+            EXPECT_EQ(results[t][a].found, expected[a].found);
+            EXPECT_EQ(results[t][a].cost, expected[a].cost);
+            EXPECT_EQ(results[t][a].lowerBound, expected[a].lowerBound);
+            EXPECT_EQ(results[t][a].stats.improvingMoves, expected[a].stats.improvingMoves);
+        }
+    }
+}
+
 TEST(parse, parse_graph_3_big){
     Graph<NodeInfo> g;
     int n = 3;
@@ -49,3 +184,925 @@ TEST(parse, parse_graph_3_big){
 
 
 }
+
+TEST(ShortestPaths, cheapest_route_of_a_path){
+    //0 - 1 - 2 - 3 with an expensive shortcut 0 - 3
+    Graph<NodeInfo> g;
+    for(int i = 0; i < 4; i++) g.addVertex(NodeInfo(i));
+    g.addBidirectionalEdge(NodeInfo(0), NodeInfo(1), 1);
+    g.addBidirectionalEdge(NodeInfo(1), NodeInfo(2), 2);
+    g.addBidirectionalEdge(NodeInfo(2), NodeInfo(3), 3);
+    g.addBidirectionalEdge(NodeInfo(0), NodeInfo(3), 10);
+
+    GraphIndex index(g);
+    DijkstraSearch search(index);
+    search.start(0);
+    while(search.settleNext() != -1);
+
+    EXPECT_EQ(search.distance(2), 3);
+    EXPECT_EQ(search.distance(3), 6);
+    EXPECT_EQ(shortestPath(index, 0, 3), std::vector<int>({0, 1, 2, 3}));
+    EXPECT_EQ(shortestPath(index, 3, 0), std::vector<int>({3, 2, 1, 0}));
+}
+
+TEST(ShortestPaths, route_expands_the_steps_without_an_edge){
+    //square 0 - 1 - 2 - 3 - 0 with a diagonal 0 - 2, but none between 1 and 3
+    Graph<NodeInfo> g;
+    for(int i = 0; i < 4; i++) g.addVertex(NodeInfo(i));
+    g.addBidirectionalEdge(NodeInfo(0), NodeInfo(1), 1);
+    g.addBidirectionalEdge(NodeInfo(1), NodeInfo(2), 2);
+    g.addBidirectionalEdge(NodeInfo(2), NodeInfo(3), 1);
+    g.addBidirectionalEdge(NodeInfo(3), NodeInfo(0), 1);
+    g.addBidirectionalEdge(NodeInfo(0), NodeInfo(2), 5);
+    TSP tsp;
+    tsp.setGraph(std::move(g));
+
+    TSPResult result;
+    result.found = true;
+    result.path = {NodeInfo(0), NodeInfo(1), NodeInfo(3), NodeInfo(2), NodeInfo(0)};
+    std::vector<int> route;
+    for(const NodeInfo &info : tsp.withRoute(result).route) route.push_back(info.getId());
+    EXPECT_EQ(route, std::vector<int>({0, 1, 0, 3, 2, 0}));
+    result.path = {NodeInfo(0), NodeInfo(1), NodeInfo(2), NodeInfo(3), NodeInfo(0)};
+    EXPECT_TRUE(tsp.withRoute(result).route.empty());
+}
+
+TEST(ShortestPaths, oracle_keeps_the_most_recent_rows){
+    Graph<NodeInfo> g;
+    int n = 6;
+    for(int i = 0; i < n; i++) g.addVertex(NodeInfo(i));
+    for(int i = 0; i < n; i++) g.addBidirectionalEdge(NodeInfo(i), NodeInfo((i + 1) % n), 1);
+
+    GraphIndex index(g);
+    DistanceOracle oracle(index, 2 * n * sizeof(double), false); //room for two rows
+
+    EXPECT_EQ(oracle.distance(0, 3), 3);
+    EXPECT_EQ(oracle.distance(1, 5), 2);
+    EXPECT_EQ(oracle.distance(3, 0), 3); //row of 0 answers it
+    EXPECT_EQ(oracle.misses(), 2);
+    EXPECT_EQ(oracle.distance(2, 4), 2); //drops the row of 1, the least recently used
+    EXPECT_EQ(oracle.cachedRows(), 2);
+    EXPECT_EQ(oracle.distance(1, 4), 3);
+    EXPECT_EQ(oracle.misses(), 4);
+}
+
+TEST(Weight, traits_round_trip_metres){
+    EXPECT_EQ(WeightTraits<double>::toMetres(WeightTraits<double>::fromMetres(1234.5678)), 1234.5678);
+    EXPECT_EQ(WeightTraits<float>::toMetres(WeightTraits<float>::fromMetres(1234.5)), 1234.5);
+    EXPECT_NEAR(WeightTraits<float>::toMetres(WeightTraits<float>::fromMetres(1234.5678)), 1234.5678, 1e-3);
+
+    //fixed-point: rounded to the nearest centimetre / millimetre
+    EXPECT_EQ(WeightTraits<int32_t>::fromMetres(1234.5678), 123457);
+    EXPECT_EQ(WeightTraits<int32_t>::toMetres(123457), 1234.57);
+    EXPECT_EQ(WeightTraits<int32_t>::fromMetres(0.004), 0);
+    EXPECT_LT(WeightTraits<int32_t>::fromMetres(21474000), WeightTraits<int32_t>::infinity());
+    EXPECT_EQ(WeightTraits<int64_t>::fromMetres(1234.5678), 1234568);
+    EXPECT_EQ(WeightTraits<int64_t>::toMetres(1234568), 1234.568);
+    EXPECT_EQ(WeightTraits<int64_t>::fromMetres(4e10), 40000000000000LL);
+
+    //the integer sums are 64 bits, so long tours of long edges don't overflow
+    EXPECT_TRUE((std::is_same<WeightTraits<int32_t>::Sum, int64_t>::value));
+    WeightTraits<int32_t>::Sum longTour = 0;
+    for(int i = 0; i < 1000; i++) longTour += WeightTraits<int32_t>::fromMetres(20000000);
+    EXPECT_EQ(WeightTraits<int32_t>::toMetres((double) longTour), 2e10);
+
+    //the weight type of this build
+    WeightSum tour = 0;
+    for(int i = 0; i < 1000; i++) tour += WeightTraits<Weight>::fromMetres(0.1);
+    EXPECT_NEAR(WeightTraits<Weight>::toMetres((double) tour), 100, 1e-4);
+    EXPECT_GT(WeightTraits<Weight>::infinity(), WeightTraits<Weight>::fromMetres(4e7));
+}
+
+TEST(DistanceMatrix, packed_and_compact_layouts_agree){
+    //complete graph on 40 vertexes with metre-scale weights
+    Graph<NodeInfo> g;
+    int n = 40;
+    std::mt19937 random(7);
+    std::uniform_real_distribution<double> weight(1, 50000);
+    for(int i = 0; i < n; i++) g.addVertex(NodeInfo(i));
+    for(int i = 0; i < n; i++){
+        for(int j = i + 1; j < n; j++) g.addBidirectionalEdge(NodeInfo(i), NodeInfo(j), weight(random));
+    }
+
+    GraphIndex index(g);
+    auto square = buildEdgeMatrix<DistanceMatrix<SquareLayout, DoubleValue>>(index);
+    auto packed = buildEdgeMatrix<DistanceMatrix<PackedLayout, FloatValue>>(index);
+    auto scaled = buildEdgeMatrix<DistanceMatrix<PackedLayout, ScaledUInt32Value>>(index);
+    for(int i = 0; i < n; i++){
+        for(int j = 0; j < n; j++){
+            EXPECT_EQ(square(i, j), index.weight(i, j) == GraphIndex::infinity() ? 0 : index.weight(i, j));
+            EXPECT_NEAR(packed(i, j), square(i, j), 0.01);
+            EXPECT_NEAR(scaled(i, j), square(i, j), 0.01);
+        }
+    }
+    EXPECT_LE(packed.bytes() * 4, square.bytes() + n * sizeof(float) * 2);
+    EXPECT_TRUE(square.exact());
+    EXPECT_FALSE(packed.exact());
+    EXPECT_FALSE(scaled.exact());
+
+    DistanceMatrix<PackedLayout, ScaledUInt32Value> sparse(3, 10);
+    sparse.set(0, 2, 4);
+    EXPECT_NEAR(sparse(2, 0), 4, 1e-6);
+    EXPECT_EQ(sparse(0, 1), GraphIndex::infinity());
+}
+
+TEST(TourHeuristics, two_opt_uncrosses_a_square){
+    //corners of a square, given in crossing order: 0 - 2 - 1 - 3
+    Graph<NodeInfo> g;
+    std::vector<NodeInfo> corners {NodeInfo(0, "a", -8.61, 41.15), NodeInfo(1, "b", -8.60, 41.15),
+                                   NodeInfo(2, "c", -8.60, 41.16), NodeInfo(3, "d", -8.61, 41.16)};
+    for(const NodeInfo &c : corners) g.addVertex(c);
+    for(int i = 0; i < 4; i++){
+        for(int j = i + 1; j < 4; j++){
+            const NodeInfo &a = corners[i], &b = corners[j];
+            g.addBidirectionalEdge(a, b, WeightTraits<Weight>::fromMetres(haversine(a.getLatitude(), a.getLongitude(), b.getLatitude(), b.getLongitude())));
+        }
+    }
+    GraphIndex index(g);
+    GeodesicDistance geodesic(index);
+    EdgeDistance edges(index);
+    for(int u = 0; u < 4; u++){
+        for(int v = 0; v < 4; v++) EXPECT_NEAR(geodesic(u, v), edges(u, v), 1e-3 * std::max(1.0, edges(u, v)));
+    }
+
+    std::vector<int> tour {0, 2, 1, 3};
+    double crossed = tourCost(edges, tour);
+    EXPECT_EQ(twoOpt(edges, tour, [](double){ return false; }), 1);
+    EXPECT_EQ(tour[0], 0);
+    EXPECT_LT(tourCost(edges, tour), crossed);
+    EXPECT_DOUBLE_EQ(tourCost(edges, tour), tourCost(edges, spanningTreeTour(edges, 0)));
+    EXPECT_DOUBLE_EQ(tourCost(edges, tour), tourCost(edges, nearestNeighbourTour(edges, 0)));
+
+    std::vector<std::pair<int, int>> candidates {{0, 1}, {0, 2}, {0, 3}, {1, 2}, {1, 3}, {2, 3}};
+    std::sort(candidates.begin(), candidates.end(), [&edges](const std::pair<int, int> &a, const std::pair<int, int> &b){
+        return edges(a.first, a.second) < edges(b.first, b.second);
+    });
+    std::vector<int> greedy = greedyEdgeTour(edges, candidates, 2);
+    EXPECT_EQ(greedy[0], 2);
+    EXPECT_DOUBLE_EQ(tourCost(edges, greedy), tourCost(edges, tour));
+}
+
+TEST(TourHeuristics, union_find_joins_sets){
+    UnionFind sets(6);
+    EXPECT_TRUE(sets.unite(0, 1));
+    EXPECT_TRUE(sets.unite(2, 3));
+    EXPECT_TRUE(sets.unite(1, 3));
+    EXPECT_FALSE(sets.unite(0, 2));
+    EXPECT_TRUE(sets.connected(0, 3));
+    EXPECT_FALSE(sets.connected(0, 4));
+    EXPECT_EQ(sets.sets(), 3);
+}
+
+TEST(HeldKarp, bound_is_below_the_optimum){
+    //random points: the optimum is found by backtracking over the complete graph
+    int n = 9;
+    std::mt19937 rng(21);
+    std::uniform_real_distribution<double> coordinate(0, 0.05);
+    Graph<NodeInfo> g;
+    std::unordered_map<int, NodeInfo> map;
+    std::vector<NodeInfo> nodes;
+    for(int i = 0; i < n; i++){
+        nodes.emplace_back(i, "", -8.6 + coordinate(rng), 41.1 + coordinate(rng));
+        g.addVertex(nodes.back());
+        map.emplace(i, nodes.back());
+    }
+    for(int i = 0; i < n; i++){
+        for(int j = i + 1; j < n; j++){
+            const NodeInfo &a = nodes[i], &b = nodes[j];
+            g.addBidirectionalEdge(a, b, WeightTraits<Weight>::fromMetres(haversine(a.getLatitude(), a.getLongitude(), b.getLatitude(), b.getLongitude())));
+        }
+    }
+    GraphIndex index(g);
+    EdgeDistance edges(index);
+    std::vector<int> parentOf;
+    minimumSpanningTree(n, edges, 0, parentOf);
+    double tree = 0;
+    for(int v = 0; v < n; v++) if(parentOf[v] != -1) tree += edges(v, parentOf[v]);
+
+    TSP tsp;
+    tsp.setGraph(std::move(g));
+    tsp.setIdToNode(std::move(map));
+    tsp.setLowerBound(true, 0);
+    TSPResult optimal = tsp.withLowerBound(tsp.backtrackingSolution(0));
+    double tour = tourCost(edges, nearestNeighbourTour(edges, 0));
+    HeldKarpBound bound = heldKarpBound(edges, tour, 300, [](double){ return false; });
+
+    EXPECT_GE(bound.bound, tree - 1e-6);
+    EXPECT_LE(WeightTraits<Weight>::toMetres(bound.bound), optimal.cost * (1 + 1e-6));
+    EXPECT_GE(WeightTraits<Weight>::toMetres(bound.bound), 0.9 * optimal.cost);
+    //the bound starts from the nearest neighbour tour, whatever result asked for it first
+    EXPECT_DOUBLE_EQ(optimal.lowerBound, WeightTraits<Weight>::toMetres(bound.bound));
+    EXPECT_DOUBLE_EQ(tsp.withLowerBound(tsp.otherHeuristic()).lowerBound, optimal.lowerBound);
+    EXPECT_GE(optimal.gap(), 0);
+}
+
+TEST(HeldKarp, alpha_nearness_keeps_the_optimal_edges){
+    int n = 10;
+    std::mt19937 rng(5);
+    std::uniform_real_distribution<double> coordinate(0, 0.05);
+    Graph<NodeInfo> g;
+    std::unordered_map<int, NodeInfo> map;
+    std::vector<NodeInfo> nodes;
+    for(int i = 0; i < n; i++){
+        nodes.emplace_back(i, "", -8.6 + coordinate(rng), 41.1 + coordinate(rng));
+        g.addVertex(nodes.back());
+        map.emplace(i, nodes.back());
+    }
+    for(int i = 0; i < n; i++){
+        for(int j = i + 1; j < n; j++){
+            const NodeInfo &a = nodes[i], &b = nodes[j];
+            g.addBidirectionalEdge(a, b, WeightTraits<Weight>::fromMetres(haversine(a.getLatitude(), a.getLongitude(), b.getLatitude(), b.getLongitude())));
+        }
+    }
+    TSP tsp;
+    tsp.setGraph(std::move(g));
+    tsp.setIdToNode(std::move(map));
+    const GraphIndex &index = tsp.getIndex();
+    EdgeDistance edges(index);
+    auto has = [](const std::vector<int> &list, int v){ return std::find(list.begin(), list.end(), v) != list.end(); };
+
+    //the edges of the spanning tree (of every vertex but 0) have alpha 0, so they come first
+    std::vector<int> parentOf;
+    minimumSpanningTree(n, edges, 1, parentOf, 0);
+    std::vector<int> degree(n, 0);
+    for(int v = 0; v < n; v++) if(parentOf[v] != -1){ degree[v]++; degree[parentOf[v]]++; }
+    std::vector<std::vector<int>> alpha = alphaCandidates(edges, n - 1);
+    for(int v = 1; v < n; v++){
+        if(parentOf[v] == -1) continue;
+        EXPECT_LT(std::find(alpha[v].begin(), alpha[v].end(), parentOf[v]) - alpha[v].begin(), degree[v] + 1);
+    }
+
+    //with the penalties of the Held-Karp bound, every edge of the optimal tour is among the 5 alpha-nearest
+    double tour = tourCost(edges, nearestNeighbourTour(edges, 0));
+    HeldKarpBound bound = heldKarpBound(edges, tour, 300, [](double){ return false; });
+    std::vector<std::vector<int>> near = alphaCandidates(edges, 5, bound.penalties);
+    TSPResult optimal = tsp.backtrackingSolution(0);
+    ASSERT_TRUE(optimal.found);
+    for(size_t i = 0; i + 1 < optimal.path.size(); i++){
+        int u = index.indexOf(optimal.path[i].getId()), v = index.indexOf(optimal.path[i + 1].getId());
+        EXPECT_TRUE(has(near[u], v) || has(near[v], u));
+    }
+}
+
+TEST(TourHeuristics, multi_start_nearest_neighbour_keeps_the_best_start){
+    int n = 40;
+    std::mt19937 rng(5);
+    std::uniform_real_distribution<double> coordinate(0, 0.05);
+    Graph<NodeInfo> g;
+    std::unordered_map<int, NodeInfo> map;
+    std::vector<NodeInfo> nodes;
+    for(int i = 0; i < n; i++){
+        nodes.emplace_back(i, "", -8.6 + coordinate(rng), 41.1 + coordinate(rng));
+        g.addVertex(nodes.back());
+        map.emplace(i, nodes.back());
+    }
+    for(int i = 0; i < n; i++){
+        for(int j = i + 1; j < n; j++){
+            const NodeInfo &a = nodes[i], &b = nodes[j];
+            g.addBidirectionalEdge(a, b, WeightTraits<Weight>::fromMetres(haversine(a.getLatitude(), a.getLongitude(), b.getLatitude(), b.getLongitude())));
+        }
+    }
+
+    TSP tsp;
+    tsp.setGraph(std::move(g));
+    tsp.setIdToNode(std::move(map));
+    TSPResult single = tsp.otherHeuristic();
+    tsp.setThreads(3);
+    TSPResult parallel = tsp.multiStartNearestNeighbour(7);
+    tsp.setThreads(1);
+    TSPResult sequential = tsp.multiStartNearestNeighbour(7);
+
+    ASSERT_TRUE(parallel.found);
+    EXPECT_LE(parallel.cost, single.cost + 1e-6);
+#ifdef TSP_SEARCH_STATS
+    EXPECT_EQ(parallel.stats.startsWalked, (unsigned long long) n);
+    EXPECT_EQ(parallel.stats.tries, 0ULL);
+#endif
+    ASSERT_EQ(parallel.path.size(), (size_t) n + 1);
+    EXPECT_EQ(parallel.path.front().getId(), 7);
+    EXPECT_EQ(parallel.path.back().getId(), 7);
+    EXPECT_DOUBLE_EQ(parallel.cost, sequential.cost);
+    EXPECT_EQ(parallel.cycleFrom, sequential.cycleFrom);
+    EXPECT_EQ(tsp.multiStartNearestNeighbour(-1).error, 1);
+}
+
+TEST(TourHeuristics, walks_from_vertex_0_need_a_vertex_0){
+    Graph<NodeInfo> g;
+    std::unordered_map<int, NodeInfo> map;
+    for(int i = 1; i <= 3; i++){
+        g.addVertex(NodeInfo(i));
+        map.emplace(i, NodeInfo(i));
+    }
+    g.addBidirectionalEdge(NodeInfo(1), NodeInfo(2), WeightTraits<Weight>::fromMetres(10));
+    g.addBidirectionalEdge(NodeInfo(2), NodeInfo(3), WeightTraits<Weight>::fromMetres(20));
+    g.addBidirectionalEdge(NodeInfo(1), NodeInfo(3), WeightTraits<Weight>::fromMetres(30));
+
+    TSP tsp;
+    tsp.setGraph(std::move(g));
+    tsp.setIdToNode(std::move(map));
+    TSPResult triangular = tsp.triangularAproxSolution(), other = tsp.otherHeuristic();
+    EXPECT_FALSE(triangular.found);
+    EXPECT_EQ(triangular.error, 1);
+    EXPECT_FALSE(other.found);
+    EXPECT_EQ(other.error, 1);
+}
+
+TEST(TourHeuristics, space_filling_curve_tour_visits_every_vertex){
+    int n = 60;
+    std::mt19937 rng(9);
+    std::uniform_real_distribution<double> coordinate(0, 0.05);
+    Graph<NodeInfo> g;
+    std::unordered_map<int, NodeInfo> map;
+    std::vector<NodeInfo> nodes;
+    for(int i = 0; i < n; i++){
+        nodes.emplace_back(i, "", -8.6 + coordinate(rng), 41.1 + coordinate(rng));
+        g.addVertex(nodes.back());
+        map.emplace(i, nodes.back());
+    }
+    for(int i = 0; i < n; i++){
+        for(int j = i + 1; j < n; j++){
+            const NodeInfo &a = nodes[i], &b = nodes[j];
+            g.addBidirectionalEdge(a, b, WeightTraits<Weight>::fromMetres(haversine(a.getLatitude(), a.getLongitude(), b.getLatitude(), b.getLongitude())));
+        }
+    }
+
+    TSP tsp;
+    tsp.setGraph(std::move(g));
+    tsp.setIdToNode(std::move(map));
+    TSPResult curve = tsp.spaceFillingCurveTour(11);
+    TSPResult improved = tsp.improvedHeuristic(11, TourConstruction::SPACE_FILLING_CURVE);
+
+    ASSERT_TRUE(curve.found);
+    ASSERT_EQ(curve.path.size(), (size_t) n + 1);
+    EXPECT_EQ(curve.path.front().getId(), 11);
+    EXPECT_EQ(curve.path.back().getId(), 11);
+    std::set<int> ids;
+    for(const NodeInfo &node : curve.path) ids.insert(node.getId());
+    EXPECT_EQ(ids.size(), (size_t) n);
+    ASSERT_TRUE(improved.found);
+    EXPECT_LE(improved.cost, curve.cost + 1e-6);
+    EXPECT_EQ(tsp.spaceFillingCurveTour(-1).error, 1);
+}
+
+TEST(TourHeuristics, insertion_tours_visit_every_vertex){
+    int n = 80;
+    std::mt19937 rng(15);
+    std::uniform_real_distribution<double> coordinate(0, 0.05);
+    Graph<NodeInfo> g;
+    std::vector<NodeInfo> nodes;
+    for(int i = 0; i < n; i++){
+        nodes.emplace_back(i, "", -8.6 + coordinate(rng), 41.1 + coordinate(rng));
+        g.addVertex(nodes.back());
+    }
+    for(int i = 0; i < n; i++){
+        for(int j = i + 1; j < n; j++){
+            const NodeInfo &a = nodes[i], &b = nodes[j];
+            g.addBidirectionalEdge(a, b, WeightTraits<Weight>::fromMetres(haversine(a.getLatitude(), a.getLongitude(), b.getLatitude(), b.getLongitude())));
+        }
+    }
+    GraphIndex index(g);
+    EdgeDistance edges(index);
+    std::vector<NodeInfo> coordinates;
+    for(int v = 0; v < n; v++) coordinates.push_back(index.info(v));
+
+    //the grid finds the same closest points as a scan
+    SpatialGrid grid(coordinates);
+    for(int v = 0; v < n; v += 2) grid.insert(v);
+    std::vector<int> near;
+    grid.nearest(1, 5, near);
+    std::vector<std::pair<double, int>> scan;
+    for(int v = 0; v < n; v += 2) scan.push_back({edges(1, v), v});
+    std::sort(scan.begin(), scan.end());
+    ASSERT_EQ(near.size(), (size_t) 5);
+    for(int k = 0; k < 5; k++) EXPECT_EQ(near[k], scan[k].second);
+
+    //2-opt over neighbour lists ends close to the full 2-opt
+    std::vector<std::vector<int>> candidates(n);
+    for(int v = 0; v < n; v++) grid.nearest(v, 8, candidates[v]);
+    for(int v = 0; v < n; v++) grid.insert(v);
+    for(int v = 0; v < n; v++) grid.nearest(v, 8, candidates[v]);
+    std::vector<int> full = nearestNeighbourTour(edges, 3), listed = full;
+    twoOpt(edges, full, [](double){ return false; });
+    EXPECT_GT(twoOptNeighbours(edges, listed, candidates, [](double){ return false; }), 0);
+    EXPECT_EQ(listed[0], 3);
+    EXPECT_EQ(std::set<int>(listed.begin(), listed.end()).size(), (size_t) n);
+    EXPECT_LT(tourCost(edges, listed), 1.1 * tourCost(edges, full));
+
+    double nearest = tourCost(edges, nearestNeighbourTour(edges, 3));
+    std::vector<std::vector<int>> tours {cheapestInsertionTour(edges, coordinates, 3), farthestInsertionTour(edges, coordinates, 3),
+                                         convexHullInsertionTour(edges, coordinates, 3), cheapestInsertionTour(edges, {}, 3)};
+    for(const std::vector<int> &tour : tours){
+        ASSERT_EQ(tour.size(), (size_t) n);
+        EXPECT_EQ(tour[0], 3);
+        EXPECT_EQ(std::set<int>(tour.begin(), tour.end()).size(), (size_t) n);
+        EXPECT_LT(tourCost(edges, tour), 1.25 * nearest);
+    }
+}
+
+TEST(TourHeuristics, dense_graphs_missing_edges_pay_their_routes){
+    //square 0 - 1 - 2 - 3 - 0 (10 each) and a vertex 4 hanging from 0 (30): half of the pairs have an edge, so the
+    //graph gets an edge matrix, but every closed walk through all the vertexes costs at least 100
+    Graph<NodeInfo> g;
+    std::vector<NodeInfo> nodes;
+    for(int i = 0; i < 5; i++){
+        nodes.emplace_back(i, "", -8.6 + 0.01 * (i % 3), 41.1 + 0.01 * (i / 3));
+        g.addVertex(nodes.back());
+    }
+    for(int i = 0; i < 4; i++) g.addBidirectionalEdge(nodes[i], nodes[(i + 1) % 4], WeightTraits<Weight>::fromMetres(10));
+    g.addBidirectionalEdge(nodes[0], nodes[4], WeightTraits<Weight>::fromMetres(30));
+    TSP tsp;
+    tsp.setGraph(std::move(g));
+    ASSERT_NE(tsp.getEdgeMatrix(), nullptr);
+    EXPECT_EQ(tsp.getCompleteMatrix(), nullptr);
+
+    const GraphIndex &index = tsp.getIndex();
+    for(TourConstruction construction : {TourConstruction::NEAREST_NEIGHBOUR, TourConstruction::SPANNING_TREE, TourConstruction::GREEDY_EDGE,
+                                         TourConstruction::CHEAPEST_INSERTION, TourConstruction::FARTHEST_INSERTION,
+                                         TourConstruction::CONVEX_HULL_INSERTION, TourConstruction::SPACE_FILLING_CURVE}){
+        for(bool improve : {false, true}){
+            TSPResult result = tsp.withRoute(improve ? tsp.improvedHeuristic(0, construction) : tsp.constructionHeuristic(0, construction));
+            ASSERT_TRUE(result.found);
+            EXPECT_GE(result.cost, 100);
+
+            //the cost is the one of the route driven, edge by edge
+            const std::vector<NodeInfo> &route = result.route.empty() ? result.path : result.route;
+            double driven = 0;
+            for(size_t i = 0; i + 1 < route.size(); i++){
+                double w = index.weight(index.indexOf(route[i].getId()), index.indexOf(route[i + 1].getId()));
+                ASSERT_NE(w, GraphIndex::infinity());
+                driven += WeightTraits<Weight>::toMetres(w);
+            }
+            EXPECT_EQ(result.cost, driven);
+        }
+    }
+}
+
+TEST(TourHeuristics, delaunay_matches_the_empty_circles){
+    int n = 40;
+    std::mt19937 rng(8);
+    std::uniform_real_distribution<double> coordinate(0, 0.05);
+    std::vector<NodeInfo> nodes;
+    for(int i = 0; i < n; i++) nodes.emplace_back(i, "", -8.6 + coordinate(rng), 41.1 + coordinate(rng));
+    std::vector<double> x, y;
+    projectCoordinates(nodes, x, y);
+
+    //brute force: the triangles whose circumcircle holds no other point
+    std::set<std::pair<int, int>> expected;
+    for(int a = 0; a < n; a++){
+        for(int b = a + 1; b < n; b++){
+            for(int c = b + 1; c < n; c++){
+                double orientation = (x[b] - x[a]) * (y[c] - y[a]) - (y[b] - y[a]) * (x[c] - x[a]);
+                int u = orientation > 0 ? b : c, w = orientation > 0 ? c : b;
+                bool empty = true;
+                for(int p = 0; p < n && empty; p++){
+                    double ax = x[a] - x[p], ay = y[a] - y[p], bx = x[u] - x[p], by = y[u] - y[p], cx = x[w] - x[p], cy = y[w] - y[p];
+                    double det = (ax * ax + ay * ay) * (bx * cy - cx * by) - (bx * bx + by * by) * (ax * cy - cx * ay) + (cx * cx + cy * cy) * (ax * by - bx * ay);
+                    if(p != a && p != b && p != c && det > 0) empty = false;
+                }
+                if(empty) expected.insert({{a, b}, {a, c}, {b, c}});
+            }
+        }
+    }
+    std::vector<std::vector<int>> neighbours = delaunayNeighbours(nodes);
+    std::set<std::pair<int, int>> found;
+    for(int v = 0; v < n; v++) for(int u : neighbours[v]) found.insert({std::min(u, v), std::max(u, v)});
+    EXPECT_EQ(found, expected);
+    EXPECT_LT(found.size(), (size_t) 3 * n);
+
+    //a repeated point gets the neighbours of the first
+    nodes.emplace_back(n, "", nodes[5].getLongitude(), nodes[5].getLatitude());
+    neighbours = delaunayNeighbours(nodes);
+    EXPECT_TRUE(std::binary_search(neighbours[n].begin(), neighbours[n].end(), 5));
+    EXPECT_TRUE(std::binary_search(neighbours[5].begin(), neighbours[5].end(), n));
+    EXPECT_EQ(neighbours[n].size(), neighbours[5].size());
+
+    addQuadrantNeighbours(nodes, 1, neighbours);
+    for(int v = 0; v <= n; v++) EXPECT_TRUE(std::is_sorted(neighbours[v].begin(), neighbours[v].end()));
+}
+
+TEST(TourHeuristics, cluster_decomposition_visits_every_vertex){
+    int n = 3 * CLUSTER_SIZE / 2;
+    std::mt19937 rng(21);
+    std::uniform_real_distribution<double> coordinate(0, 0.2);
+    Graph<NodeInfo> g;
+    std::unordered_map<int, NodeInfo> map;
+    std::vector<NodeInfo> nodes;
+    for(int i = 0; i < n; i++){
+        nodes.emplace_back(i, "", -8.6 + coordinate(rng), 41.1 + coordinate(rng));
+        g.addVertex(nodes.back());
+        map.emplace(i, nodes.back());
+    }
+    //a sparse, connected graph: the Delaunay edges
+    std::vector<std::vector<int>> neighbours = delaunayNeighbours(nodes);
+    for(int v = 0; v < n; v++){
+        for(int u : neighbours[v]){
+            if(u < v) continue;
+            const NodeInfo &a = nodes[v], &b = nodes[u];
+            g.addBidirectionalEdge(a, b, WeightTraits<Weight>::fromMetres(haversine(a.getLatitude(), a.getLongitude(), b.getLatitude(), b.getLongitude())));
+        }
+    }
+
+    TSP tsp;
+    tsp.setGraph(std::move(g));
+    tsp.setIdToNode(std::move(map));
+    TSPResult sequential = tsp.clusterDecomposition(3, TourConstruction::NEAREST_NEIGHBOUR);
+    tsp.setThreads(3);
+    TSPResult parallel = tsp.clusterDecomposition(3, TourConstruction::NEAREST_NEIGHBOUR);
+    TSPResult whole = tsp.improvedHeuristic(3, TourConstruction::NEAREST_NEIGHBOUR);
+
+    ASSERT_TRUE(parallel.found);
+    ASSERT_EQ(parallel.path.size(), (size_t) n + 1);
+    EXPECT_EQ(parallel.path.front().getId(), 3);
+    EXPECT_EQ(parallel.path.back().getId(), 3);
+    std::set<int> ids;
+    for(const NodeInfo &node : parallel.path) ids.insert(node.getId());
+    EXPECT_EQ(ids.size(), (size_t) n);
+    EXPECT_DOUBLE_EQ(parallel.cost, sequential.cost);
+    ASSERT_TRUE(whole.found);
+    EXPECT_LE(parallel.cost, 1.2 * whole.cost);
+    EXPECT_EQ(tsp.clusterDecomposition(-1, TourConstruction::NEAREST_NEIGHBOUR).error, 1);
+}
+
+TEST(TourHeuristics, cluster_decomposition_pays_the_missing_edges){
+    //square 0 - 1 - 2 - 3 - 0 (10 each) and a vertex 4 hanging from 0 (45), without coordinates: dense enough for
+    //an edge matrix, but the cheapest closed walk through all of them costs 130
+    Graph<NodeInfo> g;
+    for(int i = 0; i < 5; i++) g.addVertex(NodeInfo(i));
+    for(int i = 0; i < 4; i++) g.addBidirectionalEdge(NodeInfo(i), NodeInfo((i + 1) % 4), WeightTraits<Weight>::fromMetres(10));
+    g.addBidirectionalEdge(NodeInfo(0), NodeInfo(4), WeightTraits<Weight>::fromMetres(45));
+    TSP tsp;
+    tsp.setGraph(std::move(g));
+    TSPResult result = tsp.withRoute(tsp.clusterDecomposition(0, TourConstruction::NEAREST_NEIGHBOUR));
+    ASSERT_TRUE(result.found);
+    EXPECT_GE(result.cost, 130);
+    const GraphIndex &index = tsp.getIndex();
+    double driven = 0;
+    for(size_t i = 0; i + 1 < result.route.size(); i++){
+        driven += WeightTraits<Weight>::toMetres(index.weight(index.indexOf(result.route[i].getId()), index.indexOf(result.route[i + 1].getId())));
+    }
+    EXPECT_EQ(result.cost, driven);
+
+    //two triangles with no route between them
+    Graph<NodeInfo> triangles;
+    for(int i = 0; i < 6; i++) triangles.addVertex(NodeInfo(i));
+    for(int i = 0; i < 6; i++) triangles.addBidirectionalEdge(NodeInfo(i), NodeInfo(i / 3 * 3 + (i + 1) % 3), WeightTraits<Weight>::fromMetres(5));
+    tsp.setGraph(std::move(triangles));
+    result = tsp.clusterDecomposition(0, TourConstruction::NEAREST_NEIGHBOUR);
+    EXPECT_FALSE(result.found);
+    EXPECT_EQ(result.error, 2);
+}
+
+TEST(TourHeuristics, two_level_tour_matches_a_vector){
+    int n = 150;
+    std::mt19937 rng(27);
+    std::vector<int> reference(n);
+    for(int i = 0; i < n; i++) reference[i] = i;
+    std::shuffle(reference.begin(), reference.end(), rng);
+    TwoLevelTour tour(reference);
+
+    std::uniform_int_distribution<int> vertex(0, n - 1);
+    for(int step = 0; step < 2000; step++){
+        //reverses the path from a forward to b in both (over the end of the vector if needed)
+        int a = vertex(rng), b = vertex(rng);
+        if(tour.next(a) != reference[(std::find(reference.begin(), reference.end(), a) - reference.begin() + 1) % n]){
+            std::reverse(reference.begin(), reference.end()); //same cycle, in the direction of the tour
+        }
+        tour.reverse(a, b);
+        int i = (int) (std::find(reference.begin(), reference.end(), a) - reference.begin());
+        int j = (int) (std::find(reference.begin(), reference.end(), b) - reference.begin());
+        int length = (j - i + n) % n + 1;
+        for(int k = 0; k < length / 2; k++) std::swap(reference[(i + k) % n], reference[(j - k + n) % n]);
+
+        int v = vertex(rng);
+        int p = (int) (std::find(reference.begin(), reference.end(), v) - reference.begin());
+        //reversing a path or the rest of the cycle gives the same cycle, possibly in the other direction
+        std::set<int> expected {reference[(p + 1) % n], reference[(p + n - 1) % n]};
+        ASSERT_EQ(std::set<int>({tour.next(v), tour.prev(v)}), expected);
+        ASSERT_EQ(tour.prev(tour.next(v)), v);
+        ASSERT_EQ(tour.between(v, tour.next(tour.next(v)), tour.prev(v)), true);
+    }
+    std::vector<int> order = tour.order(reference[0]);
+    std::vector<int> reversedOrder(order);
+    std::reverse(reversedOrder.begin() + 1, reversedOrder.end());
+    EXPECT_TRUE(order == reference || reversedOrder == reference);
+}
+
+TEST(ShortestPaths, orderings_keep_the_distances){
+    //grid with shuffled ids and coordinates in the grid layout
+    int side = 12, n = side * side;
+    std::vector<int> ids(n);
+    for(int i = 0; i < n; i++) ids[i] = i;
+    std::mt19937 rng(5);
+    std::shuffle(ids.begin(), ids.end(), rng);
+    Graph<NodeInfo> g;
+    std::vector<NodeInfo> nodes;
+    for(int i = 0; i < n; i++) nodes.push_back(NodeInfo(ids[i], "", -8.6 + 0.001 * (i % side), 41.1 + 0.001 * (i / side)));
+    for(const NodeInfo &node : nodes) g.addVertex(node);
+    for(int i = 0; i < n; i++){
+        if(i % side + 1 < side) g.addBidirectionalEdge(nodes[i], nodes[i + 1], 1 + i % 5);
+        if(i + side < n) g.addBidirectionalEdge(nodes[i], nodes[i + side], 1 + i % 3);
+    }
+
+    GraphIndex byId(g);
+    DijkstraSearch reference(byId);
+    reference.start(byId.indexOf(ids[0]));
+    while(reference.settleNext() != -1);
+
+    for(VertexOrdering ordering : {VertexOrdering::HILBERT, VertexOrdering::RCM, VertexOrdering::AUTO}){
+        GraphIndex index(g, ordering);
+        ASSERT_EQ(index.size(), n);
+        ASSERT_EQ(index.numEdges(), byId.numEdges());
+        DijkstraSearch search(index);
+        search.start(index.indexOf(ids[0]));
+        while(search.settleNext() != -1);
+        for(int v = 0; v < n; v++){
+            EXPECT_EQ(index.indexOf(index.idOf(v)), v);
+            EXPECT_EQ(search.distance(v), reference.distance(byId.indexOf(index.idOf(v))));
+        }
+    }
+
+    //the orderings keep the neighbours close (ids were shuffled)
+    auto span = [n](const GraphIndex &index){
+        long long total = 0;
+        for(int v = 0; v < n; v++){
+            for(const Neighbour *e = index.begin(v); e != index.end(v); e++) total += std::abs(e->to - v);
+        }
+        return total;
+    };
+    EXPECT_LT(span(GraphIndex(g, VertexOrdering::HILBERT)) * 4, span(byId));
+    EXPECT_LT(span(GraphIndex(g, VertexOrdering::RCM)) * 4, span(byId));
+}
+
+TEST(ShortestPaths, contraction_hierarchy_matches_dijkstra){
+    //ring with random chords
+    std::mt19937 rng(5);
+    std::uniform_real_distribution<double> weight(1, 100);
+    Graph<NodeInfo> g;
+    int n = 300;
+    for(int i = 0; i < n; i++) g.addVertex(NodeInfo(i));
+    for(int i = 0; i < n; i++){
+        g.addBidirectionalEdge(NodeInfo(i), NodeInfo((i + 1) % n), weight(rng));
+        g.addBidirectionalEdge(NodeInfo(i), NodeInfo((int) (rng() % n)), weight(rng));
+    }
+
+    GraphIndex index(g);
+    ContractionHierarchy ch(index);
+    ContractionHierarchy::Query query(ch);
+    std::vector<int> sources {0, 17, 123}, targets {5, 17, 250, 299};
+    std::vector<double> table = ch.table(sources, targets, 2);
+
+    DijkstraSearch search(index);
+    for(size_t i = 0; i < sources.size(); i++){
+        search.start(sources[i]);
+        while(search.settleNext() != -1);
+        for(size_t j = 0; j < targets.size(); j++){
+            EXPECT_NEAR(query.distance(sources[i], targets[j]), search.distance(targets[j]), 1e-9);
+            EXPECT_NEAR(table[i * targets.size() + j], search.distance(targets[j]), 1e-9);
+        }
+    }
+
+    ASSERT_TRUE(ch.save("ch_test.bin"));
+    std::unique_ptr<ContractionHierarchy> loaded = ContractionHierarchy::load("ch_test.bin", index);
+    ASSERT_NE(loaded, nullptr);
+    ContractionHierarchy::Query loadedQuery(*loaded);
+    EXPECT_EQ(loadedQuery.distance(0, 250), query.distance(0, 250));
+    std::remove("ch_test.bin");
+}
+
+TEST(ShortestPaths, blocked_floyd_warshall_matches_dijkstra){
+    std::mt19937 rng(7);
+    std::uniform_real_distribution<double> weight(1, 100);
+    Graph<NodeInfo> g;
+    int n = 150; //more than two tiles
+    for(int i = 0; i < n; i++) g.addVertex(NodeInfo(i));
+    for(int i = 0; i < n; i++){
+        g.addBidirectionalEdge(NodeInfo(i), NodeInfo((i + 1) % n), weight(rng));
+        g.addBidirectionalEdge(NodeInfo(i), NodeInfo((int) (rng() % n)), weight(rng));
+    }
+
+    GraphIndex index(g);
+    std::vector<Vertex<NodeInfo> *> order;
+    for(int i = 0; i < n; i++) order.push_back(index.vertex(i));
+    g.floydWarshall(order, 3);
+
+    DijkstraSearch search(index);
+    for(int s : {0, 64, 149}){
+        search.start(s);
+        while(search.settleNext() != -1);
+        for(int t = 0; t < n; t++) EXPECT_NEAR(g.getMatrixDist(s, t), search.distance(t), 1e-9);
+    }
+
+    std::vector<NodeInfo> path = g.getFloydWarshallPath(NodeInfo(0), NodeInfo(100));
+    ASSERT_FALSE(path.empty());
+    EXPECT_EQ(path.front().getId(), 0);
+    EXPECT_EQ(path.back().getId(), 100);
+    double cost = 0;
+    for(size_t i = 0; i + 1 < path.size(); i++) cost += index.weight(path[i].getId(), path[i + 1].getId());
+    EXPECT_NEAR(cost, g.getMatrixDist(0, 100), 1e-9);
+
+    //a moved graph keeps the vertexes and the matrixes, the source is left empty
+    double distance = g.getMatrixDist(0, 100);
+    Graph<NodeInfo> moved = std::move(g);
+    EXPECT_EQ(moved.getMatrixDist(0, 100), distance);
+    EXPECT_EQ(moved.getNumVertex(), n);
+    EXPECT_EQ(g.getNumVertex(), 0);
+    EXPECT_EQ(g.getMatrixSize(), 0);
+}
+
+TEST(Batch, options_and_writers){
+    std::vector<std::string> args {"main", "--dataset", "small:*,other/graph", "--algorithms", "nn2opt,clusters", "--start", "1,2",
+                                   "--budget", "5", "--format", "json", "--print-path", "--target-gap", "2"};
+    std::vector<char *> argv;
+    for(std::string &arg : args) argv.push_back(&arg[0]);
+    BatchOptions options;
+    EXPECT_TRUE(isBatchInvocation((int) argv.size(), argv.data()));
+    ASSERT_EQ(parseBatchOptions((int) argv.size(), argv.data(), options), EXIT_SUCCESS);
+    EXPECT_EQ(options.datasets, std::vector<std::string>({"small:1", "small:2", "small:3", "other/graph"}));
+    EXPECT_EQ(options.algorithms, std::vector<std::string>({"nn2opt", "clusters"}));
+    EXPECT_EQ(options.starts, std::vector<int>({1, 2}));
+    EXPECT_EQ(options.timeBudget, 5);
+    EXPECT_EQ(options.format, "json");
+    EXPECT_TRUE(options.printPath);
+    EXPECT_DOUBLE_EQ(options.targetGap, 0.02);
+    EXPECT_EQ(expandDatasetSpec("medium:2-4"), std::vector<std::string>({"medium:2", "medium:3", "medium:4"}));
+
+    for(const std::vector<std::string> &wrong : {std::vector<std::string> {"main", "--dataset", "small:1", "--budget", "soon"},
+                                                 {"main", "--dataset", "small:1", "--format", "xml"},
+                                                 {"main", "--datasets", "small:1"}, {"main", "--print-path"}}){
+        args = wrong;
+        argv.clear();
+        for(std::string &arg : args) argv.push_back(&arg[0]);
+        BatchOptions ignored;
+        EXPECT_EQ(parseBatchOptions((int) argv.size(), argv.data(), ignored), EXIT_FAILURE);
+    }
+
+    //the writers keep every field readable, whatever the name of the dataset
+    EXPECT_EQ(jsonEscape("a\"b\\c\n\t\x01"), "a\\\"b\\\\c\\n\\t\\u0001");
+    BatchRow row {"odd \"name\"\n", "nn2opt", 0, TSPResult()};
+    row.result.found = true;
+    row.result.cost = 12.5;
+    row.result.path = {NodeInfo(0), NodeInfo(1), NodeInfo(0)};
+    std::ostringstream json, csv;
+    printBatchRows({row}, "json", true, json);
+    std::string object = json.str();
+    EXPECT_EQ(object.find("\"dataset\":\"odd \\\"name\\\"\\n\""), (size_t) 1);
+    EXPECT_NE(object.find("\"cost\":12.5"), std::string::npos);
+    EXPECT_NE(object.find("\"path\":[0,1,0]"), std::string::npos);
+    EXPECT_EQ(std::count(object.begin(), object.end(), '\n'), 1);
+    printBatchRows({row}, "csv", true, csv);
+    std::string lines = csv.str();
+    EXPECT_EQ(lines.substr(0, lines.find('\n')), "dataset,algorithm,start,found,error,cost,time,timedOut,nodesExpanded,boundPrunes,incumbentUpdates,improvingMoves,lowerBound,cycleFrom,path,route");
+    EXPECT_EQ(lines.find("\"odd \"\"name\"\"\n\",nn2opt,0,1,0,"), lines.find('\n') + 1);
+    EXPECT_NE(lines.find(",0 1 0,\n"), std::string::npos);
+}
+
+TEST(Service, json_requests){
+    std::unordered_map<std::string, std::string> fields, raw;
+    ASSERT_TRUE(parseJsonObject(" {\"id\":7, \"op\":\"solve\",\"path\":true,\"nested\":{\"a\":[1,2]},\"name\":\"caf\\u00e9 \\\"x\\\"\\n\"} ", fields, &raw));
+    EXPECT_EQ(raw["id"], "7");
+    EXPECT_EQ(raw["op"], "\"solve\"");
+    EXPECT_EQ(raw["name"], "\"caf\\u00e9 \\\"x\\\"\\n\"");
+    EXPECT_EQ(fields["id"], "7");
+    EXPECT_EQ(fields["op"], "solve");
+    EXPECT_EQ(fields["path"], "true");
+    EXPECT_EQ(fields["nested"], "{\"a\":[1,2]}");
+    EXPECT_EQ(fields["name"], "caf\xc3\xa9 \"x\"\n");
+    ASSERT_TRUE(parseJsonObject("{\"emoji\":\"\\ud83d\\ude00\"}", fields));
+    EXPECT_EQ(fields["emoji"], "\xf0\x9f\x98\x80");
+    for(const char *wrong : {"{\"a\":\"\\u12G4\"}", "{\"a\":\"\\u12\"}", "{\"a\":\"\\ud83d\"}", "{\"a\":\"\\q\"}", "{\"a\":1", "[1]", "{\"a\" 1}"}){
+        EXPECT_FALSE(parseJsonObject(wrong, fields)) << wrong;
+    }
+
+    //a small complete graph, read as a toy graph
+    {
+        std::ofstream file("service_test.csv");
+        file << "origem,destino,distancia\n0,1,10\n0,2,15\n0,3,20\n1,2,35\n1,3,25\n2,3,30\n";
+    }
+    SolveService service(2);
+    std::string load = service.handle("{\"id\":1,\"op\":\"load\",\"dataset\":\"service_test.csv\"}");
+    EXPECT_EQ(load.find("{\"id\":1,\"op\":\"load\",\"ok\":true,\"dataset\":\"service_test.csv\",\"vertexes\":4"), (size_t) 0) << load;
+    std::string solve = service.handle("{\"id\":\"a\",\"op\":\"solve\",\"dataset\":\"service_test.csv\",\"algorithm\":\"backtracking\",\"start\":2,\"path\":true}");
+    EXPECT_EQ(solve.find("{\"id\":\"a\",\"op\":\"solve\",\"ok\":true"), (size_t) 0) << solve;
+    EXPECT_NE(solve.find("\"start\":2,\"found\":true,\"error\":0,\"cost\":80,"), std::string::npos) << solve;
+    EXPECT_NE(solve.find("\"path\":[2,"), std::string::npos) << solve;
+    for(std::string id : {"\"7x\"", "\"42\"", "\"a\\\"b\"", "-3", "null"}){
+        std::string echoed = service.handle("{\"id\":" + id + ",\"op\":\"stats\"}");
+        EXPECT_EQ(echoed.find("{\"id\":" + id + ",\"op\":\"stats\",\"ok\":true"), (size_t) 0) << echoed;
+    }
+    std::string unknown = service.handle("{\"id\":3,\"op\":\"solve\",\"dataset\":\"service_test.csv\",\"algorithm\":\"guess\"}");
+    EXPECT_NE(unknown.find("\"ok\":false,\"error\":\"unknown algorithm\""), std::string::npos) << unknown;
+    std::string missing = service.handle("{\"id\":4,\"op\":\"load\",\"dataset\":\"no_such_graph.csv\"}");
+    EXPECT_NE(missing.find("\"ok\":false,\"error\":\"unable to load the dataset\""), std::string::npos) << missing;
+    EXPECT_NE(service.handle("{\"id\":5,\"op\":\"stats\"}").find("\"latency\":{\"load\":{\"count\":1,"), std::string::npos);
+    EXPECT_NE(service.statsJson().find("\"solve:backtracking\":{\"count\":1,"), std::string::npos);
+
+    //a dataset without vertex 0: the walks from it fail, and the service goes on
+    {
+        std::ofstream file("service_no_0_test.csv");
+        file << "origem,destino,distancia\n1,2,10\n2,3,20\n1,3,30\n";
+    }
+    for(const char *algorithm : {"triangular", "other", "nn2opt"}){
+        std::string failed = service.handle("{\"op\":\"solve\",\"dataset\":\"service_no_0_test.csv\",\"algorithm\":\"" + std::string(algorithm) + "\"}");
+        EXPECT_NE(failed.find("\"ok\":true,\"dataset\":\"service_no_0_test.csv\""), std::string::npos) << failed;
+        EXPECT_NE(failed.find("\"found\":false,\"error\":1,"), std::string::npos) << failed;
+    }
+    std::string other = service.handle("{\"op\":\"solve\",\"dataset\":\"service_no_0_test.csv\",\"algorithm\":\"nn2opt\",\"start\":1}");
+    EXPECT_NE(other.find("\"found\":true,\"error\":0,\"cost\":60,"), std::string::npos) << other;
+    std::remove("service_no_0_test.csv");
+
+    //solves of the same dataset at the same time, with different budgets
+    std::vector<std::string> answers(4);
+    std::vector<std::thread> clients;
+    for(int c = 0; c < 4; c++){
+        clients.emplace_back([c, &service, &answers](){
+            answers[c] = service.handle("{\"op\":\"solve\",\"dataset\":\"service_test.csv\",\"algorithm\":\"" + std::string(c % 2 ? "nn2opt" : "backtracking")
+                                        + "\",\"start\":2,\"budget\":" + std::to_string(10 * (c / 2)) + "}");
+        });
+    }
+    for(std::thread &client : clients) client.join();
+    for(int c = 0; c < 4; c++) EXPECT_NE(answers[c].find("\"found\":true"), std::string::npos) << answers[c];
+    EXPECT_NE(answers[0].find("\"cost\":80,"), std::string::npos) << answers[0];
+    EXPECT_NE(service.handle("{\"id\":6,\"op\":\"unload\",\"dataset\":\"service_test.csv\"}").find("\"unloaded\":true"), std::string::npos);
+    EXPECT_NE(service.handle("{\"id\":7,\"op\":\"unload\",\"dataset\":\"service_test.csv\"}").find("\"unloaded\":false"), std::string::npos);
+    EXPECT_NE(service.handle("{\"op\":\"fly\"}").find("\"id\":null,\"op\":\"fly\",\"ok\":false,\"error\":\"unknown op\""), std::string::npos);
+    EXPECT_EQ(service.handle("not json"), "{\"ok\":false,\"error\":\"invalid JSON\"}");
+    EXPECT_FALSE(service.isStopping());
+    EXPECT_NE(service.handle("{\"id\":8,\"op\":\"shutdown\"}").find("\"ok\":true"), std::string::npos);
+    EXPECT_TRUE(service.isStopping());
+
+    //the stream server answers every request before stopping
+    std::istringstream in("{\"id\":1,\"op\":\"load\",\"dataset\":\"service_test.csv\"}\n\n{\"id\":2,\"op\":\"shutdown\"}\n{\"id\":3,\"op\":\"stats\"}\n");
+    std::ostringstream out;
+    SolveService streamed(1);
+    EXPECT_EQ(streamed.serveStream(in, out), EXIT_SUCCESS);
+    std::string responses = out.str();
+    EXPECT_EQ(std::count(responses.begin(), responses.end(), '\n'), 2);
+    EXPECT_NE(responses.find("\"op\":\"shutdown\",\"ok\":true"), std::string::npos);
+    std::remove("service_test.csv");
+}
+
+TEST(RealWorld, many_starts_share_the_cheapest_cycle){
+    //complete graph with random weights: every walk finds a cycle, of a different cost
+    int n = 40;
+    std::mt19937 rng(12);
+    std::uniform_real_distribution<double> weight(1, 100);
+    Graph<NodeInfo> g;
+    std::unordered_map<int, NodeInfo> map;
+    for(int i = 0; i < n; i++){
+        g.addVertex(NodeInfo(i));
+        map.emplace(i, NodeInfo(i));
+    }
+    for(int i = 0; i < n; i++){
+        for(int j = i + 1; j < n; j++) g.addBidirectionalEdge(NodeInfo(i), NodeInfo(j), WeightTraits<Weight>::fromMetres(weight(rng)));
+    }
+
+    TSP tsp;
+    tsp.setGraph(std::move(g));
+    tsp.setIdToNode(std::move(map));
+    std::vector<int> ids {0, 17, 33, 39, 1000};
+    std::vector<TSPResult> results = tsp.tspRealWordBatch(ids, 3);
+    ASSERT_EQ(results.size(), ids.size());
+    EXPECT_FALSE(results[4].found);
+    EXPECT_EQ(results[4].error, 1);
+
+    const GraphIndex &index = tsp.getIndex();
+    int rotated = 0;
+    for(size_t i = 0; i + 1 < ids.size(); i++){
+        const TSPResult &result = results[i];
+        ASSERT_TRUE(result.found);
+        EXPECT_DOUBLE_EQ(result.cost, results[0].cost);
+        EXPECT_GT(result.lowerBound, 0);
+        EXPECT_LE(result.lowerBound, result.cost);
+        ASSERT_EQ(result.path.size(), (size_t) n + 1);
+        EXPECT_EQ(result.path.front().getId(), ids[i]);
+        EXPECT_EQ(result.path.back().getId(), ids[i]);
+        std::set<int> seen;
+        double cost = 0;
+        for(size_t k = 0; k + 1 < result.path.size(); k++){
+            seen.insert(result.path[k].getId());
+            int u = index.indexOf(result.path[k].getId()), v = index.indexOf(result.path[k + 1].getId());
+            ASSERT_TRUE(index.hasEdge(u, v));
+            cost += WeightTraits<Weight>::toMetres(index.weight(u, v));
+        }
+        EXPECT_EQ(seen.size(), (size_t) n);
+        EXPECT_NEAR(cost, result.cost, 1e-6 * cost);
+
+        //the shared cycle is never worse than the start's own search, and says where it came from otherwise
+        TSPResult alone = tsp.tspRealWordBatch({ids[i]}, 1)[0];
+        if(alone.found){
+            EXPECT_LE(result.cost, alone.cost + 1e-9);
+        }
+        if(result.cycleFrom != -1){
+            rotated++;
+            EXPECT_NE(std::find(ids.begin(), ids.end(), result.cycleFrom), ids.end());
+            EXPECT_NE(result.cycleFrom, ids[i]);
+        }
+    }
+    EXPECT_LT(rotated, (int) ids.size() - 1);
+    EXPECT_DOUBLE_EQ(tsp.tspRealWordBatch(ids, 1)[2].cost, results[2].cost);
+
+    //a budget that is already over skips every start
+    results = tsp.tspRealWordBatch(ids, 2, 1e-9);
+    EXPECT_TRUE(results[0].timedOut);
+    EXPECT_FALSE(results[0].found);
+}